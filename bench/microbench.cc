@@ -0,0 +1,317 @@
+#include "../include/ir.h"
+#include "../include/symtab.h"
+#include "../include/time_report.h"
+#include "../optimize/analysis/dominator_tree.h"
+#include "../optimize/transform/mem2reg.h"
+#include "../target/common/machine_passes/register_alloc/liveinterval.h"
+#include "../target/riscv64gc/instruction_select/riscv64_instSelect.h"
+#include "../target/riscv64gc/riscv64.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <new>
+#include <span>
+#include <string>
+#include <vector>
+
+/*
+    编译器数据结构的微基准测试(make microbench, 运行bin/microbench [名称过滤])
+    在规模可控的合成控制流图和活跃区间上单独测量各个数据结构/算法, 不受词法分析、输出等其他阶段的干扰
+    每项测试输出每次操作的平均时间(ns/op), 以及每次操作中operator new的调用次数和申请的字节数
+    (Arena按块通过malloc申请内存, 不计入分配次数)
+*/
+
+// 编译器其他部分引用的、定义在target/main.cc中的全局变量
+int line_number = 0;
+int col_number = 0;
+int cur_col_number = 0;
+std::ofstream fout;
+IdTable id_table;
+TimeReport time_report;
+
+static size_t alloc_count = 0;
+static size_t alloc_bytes = 0;
+
+void *operator new(size_t size) {
+    alloc_count++;
+    alloc_bytes += size;
+    void *p = std::malloc(size == 0 ? 1 : size);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, size_t) noexcept { std::free(p); }
+
+// 防止被测代码的结果被优化掉
+static volatile long sink = 0;
+
+const char *filter = "";
+
+/*
+    执行若干轮测试, 每轮先调用setup(不计时), 再调用body并计时, body返回该轮执行的操作次数
+    至少执行3轮且总计时不少于0.2s, ns/op取各轮的中位数, 分配次数取所有轮的平均值
+*/
+void RunBench(const std::string &name, int size, const std::function<void()> &setup,
+              const std::function<long()> &body) {
+    if (strstr(name.c_str(), filter) == nullptr) {
+        return;
+    }
+    std::vector<double> ns_per_op;
+    double total_ns = 0;
+    long total_ops = 0;
+    size_t total_allocs = 0, total_bytes = 0;
+    while (ns_per_op.size() < 3 || total_ns < 2e8) {
+        setup();
+        size_t count0 = alloc_count, bytes0 = alloc_bytes;
+        auto start = std::chrono::steady_clock::now();
+        long ops = body();
+        auto end = std::chrono::steady_clock::now();
+        total_allocs += alloc_count - count0;
+        total_bytes += alloc_bytes - bytes0;
+        double ns = std::chrono::duration<double, std::nano>(end - start).count();
+        total_ns += ns;
+        total_ops += ops;
+        ns_per_op.push_back(ns / ops);
+    }
+    std::sort(ns_per_op.begin(), ns_per_op.end());
+    printf("%-32s %8d %14.1f %12.2f %14.1f\n", name.c_str(), size, ns_per_op[ns_per_op.size() / 2],
+           (double)total_allocs / total_ops, (double)total_bytes / total_ops);
+    fflush(stdout);
+}
+
+// 确定性的伪随机数, 使每次运行的输入相同
+static unsigned rand_state = 1;
+static unsigned NextRand() {
+    rand_state = rand_state * 1103515245 + 12345;
+    return rand_state >> 8;
+}
+
+// 在基本块B末尾生成一条新指令, 定义在utils/Instruction.cc
+void IRgenArithmeticI32ImmAll(LLVMBlock B, BasicInstruction::LLVMIROpcode opcode, int val1, int val2, int result_reg);
+void IRgenArithmeticI32ImmLeft(LLVMBlock B, BasicInstruction::LLVMIROpcode opcode, int val1, int reg2, int result_reg);
+void IRgenIcmpImmRight(LLVMBlock B, BasicInstruction::IcmpCond cmp_op, int reg1, int val2, int result_reg);
+void IRgenLoad(LLVMBlock B, BasicInstruction::LLVMType type, int result_reg, Operand ptr);
+void IRgenStore(LLVMBlock B, BasicInstruction::LLVMType type, int value_reg, Operand ptr);
+void IRgenRetReg(LLVMBlock B, BasicInstruction::LLVMType type, int reg);
+void IRgenBRUnCond(LLVMBlock B, int dst_label);
+void IRgenBrCond(LLVMBlock B, int cond_reg, int true_label, int false_label);
+void IRgenAlloca(LLVMBlock B, BasicInstruction::LLVMType type, int reg);
+
+/*
+    构造有n + 1个基本块的合成函数: 入口块为vars个局部变量分配栈空间并初始化
+    之后每个块读取一个变量、加上常数后写入另一个变量, 再条件跳转到下一个块或一个伪随机的块(向前或向后, 形成循环)
+    最后一个块返回, 所有块都可达, 变量都可以被Mem2Reg提升
+*/
+struct SyntheticFunction {
+    std::unique_ptr<LLVMIR> ir;
+    FuncDefInstruction defI;
+    CFG *cfg;
+
+    SyntheticFunction(int n, int vars) : ir(std::make_unique<LLVMIR>()) {
+        rand_state = n * 31 + vars;
+        ir_arena = &ir->global_arena;
+        defI = ir_arena->New<FunctionDefineInstruction>(BasicInstruction::I32, "f");
+        ir->NewFunction(defI);
+        ir_arena = &ir->GetArena(defI);
+
+        int reg = -1;
+        LLVMBlock entry = ir->NewBlock(defI, 0);
+        for (int v = 0; v < vars; v++) {
+            IRgenAlloca(entry, BasicInstruction::I32, ++reg);
+        }
+        // 与中间代码生成一致, 常量先通过add写入寄存器再store (Mem2Reg假设store的值是寄存器)
+        for (int v = 0; v < vars; v++) {
+            int init = ++reg;
+            IRgenArithmeticI32ImmAll(entry, BasicInstruction::ADD, v, 0, init);
+            IRgenStore(entry, BasicInstruction::I32, init, GetNewRegOperand(v));
+        }
+        IRgenBRUnCond(entry, 1);
+        for (int i = 1; i <= n; i++) {
+            LLVMBlock B = ir->NewBlock(defI, i);
+            int val = ++reg;
+            IRgenLoad(B, BasicInstruction::I32, val, GetNewRegOperand(i % vars));
+            int sum = ++reg;
+            IRgenArithmeticI32ImmLeft(B, BasicInstruction::ADD, i, val, sum);
+            IRgenStore(B, BasicInstruction::I32, sum, GetNewRegOperand(i * 7 % vars));
+            if (i == n) {
+                IRgenRetReg(B, BasicInstruction::I32, sum);
+                break;
+            }
+            int cond = ++reg;
+            IRgenIcmpImmRight(B, BasicInstruction::slt, sum, i, cond);
+            IRgenBrCond(B, cond, i + 1, NextRand() % n + 1);
+        }
+        ir->def_reg[defI] = reg;
+        ir->CFGInit();
+        cfg = ir->llvm_cfg[defI];
+    }
+    ~SyntheticFunction() { delete cfg; }
+};
+
+// 生成count个虚拟寄存器的活跃区间, 每个区间有segs段, 分布在长度为len的指令编号范围内
+std::vector<LiveInterval> SyntheticIntervals(int count, int segs, int len) {
+    std::vector<LiveInterval> intervals;
+    for (int i = 0; i < count; i++) {
+        LiveInterval interval(Register(true, i, INT32));
+        std::vector<int> points;
+        for (int k = 0; k < segs * 2; k++) {
+            points.push_back(NextRand() % len);
+        }
+        std::sort(points.begin(), points.end());
+        // 活跃区间从后往前构建
+        for (int k = segs - 1; k >= 0; k--) {
+            interval.PushFront(points[2 * k], points[2 * k + 1]);
+        }
+        intervals.push_back(interval);
+    }
+    return intervals;
+}
+
+// 比较两个控制流图中每个基本块的前驱和后继(不考虑邻接点的顺序)
+static bool SameEdges(CFG *a, CFG *b) {
+    auto ids = [](std::span<const LLVMBlock> blocks) {
+        std::vector<int> v;
+        for (auto bb : blocks) {
+            v.push_back(bb->block_id);
+        }
+        std::sort(v.begin(), v.end());
+        return v;
+    };
+    for (auto &[id, bb] : *a->block_map) {
+        if (ids(a->GetSuccessor(id)) != ids(b->GetSuccessor(id)) ||
+            ids(a->GetPredecessor(id)) != ids(b->GetPredecessor(id))) {
+            fprintf(stderr, "CFG mismatch at L%d\n", id);
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1) {
+        filter = argv[1];
+    }
+    printf("%-32s %8s %14s %12s %14s\n", "benchmark", "size", "ns/op", "allocs/op", "bytes/op");
+
+    for (int n : {100, 1000, 10000}) {
+        SyntheticFunction F(n, 16);
+        RunBench("CFG::BuildCFG", n, [] {}, [&] {
+            F.cfg->BuildCFG();
+            return 1L;
+        });
+
+        std::unique_ptr<DominatorTree> dt;
+        RunBench(
+        "DominatorTree::BuildDominatorTree", n,
+        [&] {
+            dt = std::make_unique<DominatorTree>();
+            dt->C = F.cfg;
+        },
+        [&] {
+            dt->BuildDominatorTree();
+            return 1L;
+        });
+
+        /*
+            增量修改控制流图: 每次把一个基本块条件跳转的假分支改到另一个伪随机的块, 删除旧边并加入新边
+            真分支不变, 所有块保持可达, 跳过两个分支相同的情况(建图时对相同的分支只建一条边)
+            结束后与根据跳转指令重新建立的控制流图(BuildEdges)比较, 验证增量修改维护的G和invG是正确的
+            (BuildCFG会按新的控制流重新编号基本块, 编号与增量修改后的不同, 因此不用于比较)
+        */
+        SyntheticFunction H(n, 16);
+        auto label_no = [](Operand label) { return ((LabelOperand *)label)->GetLabelNo(); };
+        RunBench("CFG::AddEdge/RemoveEdge", n, [] {}, [&] {
+            long ops = 0;
+            for (int i = 1; i < n; i++) {
+                auto term = H.cfg->block_map->at(i)->Instruction_list.back();
+                if (term->GetOpcode() != BasicInstruction::BR_COND) {
+                    continue;
+                }
+                auto br = (BrCondInstruction *)term;
+                int true_dst = label_no(br->GetTrueLabel()), old_dst = label_no(br->GetFalseLabel());
+                int new_dst = NextRand() % n + 1;
+                if (old_dst == true_dst || new_dst == true_dst) {
+                    continue;
+                }
+                br->SetFalseLabel(GetNewLabelOperand(new_dst));
+                H.cfg->RemoveEdge(i, old_dst);
+                H.cfg->AddEdge(i, new_dst);
+                ops++;
+            }
+            return std::max(ops, 1L);
+        });
+        CFG rebuilt;
+        rebuilt.function_def = H.defI;
+        rebuilt.block_map = H.cfg->block_map;
+        rebuilt.BuildEdges();
+        if (!SameEdges(H.cfg, &rebuilt) || !SameEdges(&rebuilt, H.cfg)) {
+            fprintf(stderr, "CFG::AddEdge/RemoveEdge does not match BuildEdges\n");
+            return 1;
+        }
+
+        // Mem2Reg会修改中间代码, 每轮重新构造函数
+        std::unique_ptr<SyntheticFunction> G;
+        std::unique_ptr<DomAnalysis> dom;
+        RunBench(
+        "Mem2RegPass::Execute", n,
+        [&] {
+            dom.reset();
+            G.reset();
+            G = std::make_unique<SyntheticFunction>(n, 16);
+            dom = std::make_unique<DomAnalysis>(G->ir.get());
+            dom->Execute();
+        },
+        [&] {
+            Mem2RegPass(G->ir.get(), dom.get()).Execute();
+            return 1L;
+        });
+        dom.reset();
+        G.reset();
+
+        RiscV64Unit unit;
+        RiscV64Selector selector(&unit, F.ir.get());
+        MachineFunction *mfun = selector.SelectFunction(F.defI, F.cfg);
+        RunBench("Liveness::Execute", n, [] {}, [&] {
+            Liveness liveness(mfun, false);
+            liveness.Execute();
+            sink = sink + (liveness.GetIN(0).begin() != liveness.GetIN(0).end());
+            return 1L;
+        });
+    }
+
+    for (int segs : {1, 16, 256}) {
+        rand_state = segs;
+        auto intervals = SyntheticIntervals(256, segs, segs * 64);
+        RunBench("LiveInterval::operator&", segs, [] {}, [&] {
+            long ops = 0;
+            for (size_t i = 0; i < intervals.size(); i++) {
+                for (size_t j = i + 1; j < intervals.size(); j++) {
+                    sink = sink + (intervals[i] & intervals[j]);
+                    ops++;
+                }
+            }
+            return ops;
+        });
+    }
+
+    for (int count : {100, 1000, 10000}) {
+        rand_state = count;
+        auto intervals = SyntheticIntervals(count, 4, count * 8);
+        RiscV64RegisterAllocTools tools;
+        RunBench("getIdleReg", count, [&] { tools.clear(); }, [&] {
+            for (auto &interval : intervals) {
+                sink = sink + tools.getIdleReg(interval);
+            }
+            return (long)intervals.size();
+        });
+    }
+    return 0;
+}
@@ -0,0 +1,150 @@
+import argparse
+import json
+import math
+import os
+import re
+import statistics
+import subprocess
+import time
+
+# 生成代码的运行时间测试: 每个用例通过 -S -O1 编译, 与lib/libsysy_rv.a链接后在qemu-riscv64中多次运行,
+# 取sylib在程序结束时输出的计时结果(_sysy_starttime/_sysy_stoptime)的中位数, 并可以与保存的基准结果逐项比较
+# 输出不正确的用例不计时间
+
+TIMER_RE = re.compile(r"Timer@\d+-\d+: (\d+)H-(\d+)M-(\d+)S-(\d+)us")
+
+def execute(command, stdin=None, timeout=None):
+    return subprocess.run(command, stdin=stdin, capture_output=True, text=True, timeout=timeout)
+
+def timer_total_us(stderr):
+    # 逐个累加Timer@行, 不使用TOTAL行(sylib计算TOTAL时微秒没有向秒进位), 没有计时的用例返回None
+    total = None
+    for h, m, s, us in TIMER_RE.findall(stderr):
+        total = (total or 0) + ((int(h) * 60 + int(m)) * 60 + int(s)) * 1000000 + int(us)
+    return total
+
+def normalize(text):
+    # 与 diff -b --strip-trailing-cr 的比较方式一致: 忽略行内空白的多少和末尾的空行
+    lines = [" ".join(line.split()) for line in text.replace("\r", "").split("\n")]
+    while lines and lines[-1] == "":
+        lines.pop()
+    return lines
+
+def expected_output(stdout, returncode):
+    if len(stdout) > 0 and not stdout.endswith("\n"):
+        stdout += "\n"
+    return stdout + str(returncode) + "\n"
+
+def build(args, input, name):
+    asm = os.path.join(args.output_folder, name + ".s")
+    obj = os.path.join(args.output_folder, name + ".o")
+    exe = os.path.join(args.output_folder, name)
+    result = execute([args.compiler, "-S", "-o", asm, input, args.opt], timeout=args.compile_timeout)
+    if result.returncode != 0:
+        return None, "Compile Error"
+    result = execute([args.cc, asm, "-c", "-o", obj, "-w"])
+    if result.returncode != 0:
+        return None, "OutPut Error"
+    result = execute([args.cc, "-static", obj, args.lib, "-o", exe])
+    os.remove(obj)
+    if result.returncode != 0:
+        return None, "Link Error"
+    return exe, None
+
+def run_case(args, input, stdin, stdout):
+    # 返回 {"status", "runs_us", "median_us", "wall_median_s"}
+    name = os.path.splitext(os.path.basename(input))[0]
+    exe, error = build(args, input, name)
+    if exe is None:
+        return {"status": error}
+    expected = None
+    if os.path.exists(stdout):
+        with open(stdout) as f:
+            expected = normalize(f.read())
+    runs_us = []
+    walls = []
+    for _ in range(args.repeat):
+        with open(stdin if stdin else os.devnull) as f:
+            start = time.perf_counter()
+            try:
+                result = execute(args.qemu.split() + [exe], stdin=f, timeout=args.timeout)
+            except subprocess.TimeoutExpired:
+                return {"status": "Time Limit Exceed"}
+            walls.append(time.perf_counter() - start)
+        if result.returncode == 139 or result.returncode < 0:
+            return {"status": "RunTime Error"}
+        if expected is not None and normalize(expected_output(result.stdout, result.returncode)) != expected:
+            return {"status": "Wrong Answer"}
+        us = timer_total_us(result.stderr)
+        if us is not None:
+            runs_us.append(us)
+    case = {"status": "ok", "runs_us": runs_us, "wall_median_s": statistics.median(walls)}
+    # 没有调用starttime/stoptime的用例以整个程序的运行时间(包括qemu启动)代替
+    case["median_us"] = statistics.median(runs_us) if runs_us else int(case["wall_median_s"] * 1000000)
+    case["metric"] = "timer" if runs_us else "wall"
+    return case
+
+def print_table(cases, baseline):
+    print("%-32s %14s %14s %9s" % ("case", "baseline(us)", "current(us)", "ratio"))
+    ratios = []
+    for name in sorted(cases.keys()):
+        case = cases[name]
+        base = baseline.get(name) if baseline else None
+        cur = case["median_us"] if case["status"] == "ok" else None
+        base_us = base["median_us"] if base and base.get("status") == "ok" else None
+        cur_text = str(cur) if cur is not None else case["status"]
+        base_text = str(base_us) if base_us is not None else "-"
+        if cur is not None and base_us:
+            ratio = cur / base_us
+            ratios.append(ratio)
+            # 变化小于2%视为噪声
+            color = "\033[92m" if ratio < 0.98 else ("\033[91m" if ratio > 1.02 else "")
+            print("%-32s %14s %14s %s%8.3fx\033[0m" % (name, base_text, cur_text, color, ratio))
+        else:
+            print("%-32s %14s %14s %9s" % (name, base_text, cur_text, "-"))
+    if ratios:
+        geomean = math.exp(sum(math.log(r) for r in ratios if r > 0) / len(ratios))
+        print("geomean ratio (current/baseline) over %d cases: %.3fx" % (len(ratios), geomean))
+
+parser = argparse.ArgumentParser(description="runtime benchmark of generated RISC-V code")
+parser.add_argument("input_folder", nargs="?", default="testcase/performance_test")
+parser.add_argument("--output_folder", default="bench_output/runtime")
+parser.add_argument("--compiler", default="./bin/SysYc")
+parser.add_argument("--opt", default="-O1")
+parser.add_argument("--cc", default="riscv64-unknown-linux-gnu-gcc")
+parser.add_argument("--qemu", default="qemu-riscv64")
+parser.add_argument("--lib", default="lib/libsysy_rv.a")
+parser.add_argument("--repeat", type=int, default=5, help="runs per case, the median is reported")
+parser.add_argument("--timeout", type=float, default=60, help="seconds per run")
+parser.add_argument("--compile_timeout", type=float, default=300)
+parser.add_argument("--baseline", default="", help="results JSON of an earlier run to compare against")
+parser.add_argument("--save", default="", help="write the results of this run to a JSON file")
+parser.add_argument("--filter", default="", help="only run cases whose name contains this string")
+args = parser.parse_args()
+
+os.makedirs(args.output_folder, exist_ok=True)
+baseline = None
+if args.baseline:
+    with open(args.baseline) as f:
+        baseline = json.load(f)["cases"]
+
+cases = {}
+for file in sorted(os.listdir(args.input_folder)):
+    if not file.endswith(".sy") or args.filter not in file:
+        continue
+    name = file[:-3]
+    input = os.path.join(args.input_folder, file)
+    stdin = os.path.join(args.input_folder, name + ".in")
+    stdout = os.path.join(args.input_folder, name + ".out")
+    case = run_case(args, input, stdin if os.path.exists(stdin) else None, stdout)
+    cases[name] = case
+    if case["status"] == "ok":
+        print("\033[92m" + case["metric"] + " " + str(case["median_us"]) + "us \033[0m" + input)
+    else:
+        print("\033[91m" + case["status"] + " on \033[0m" + input)
+
+print_table(cases, baseline)
+if args.save:
+    with open(args.save, "w") as f:
+        json.dump({"opt": args.opt, "repeat": args.repeat, "cases": cases}, f, indent=1)
+    print("results: " + args.save)
@@ -0,0 +1,176 @@
+import argparse
+import csv
+import json
+import math
+import os
+import subprocess
+import threading
+import time
+
+import stress_gen
+
+# 编译时间的规模测试: 用stress_gen.py生成不同规模的输入, 对每个阶段分别运行编译器,
+# 记录墙钟时间和峰值内存, 输出CSV和每种形状一张的对数坐标曲线(SVG), 并检查时间随输入大小的增长是否超线性
+
+# -lexer和-parser不经过优化, 只对-llvm和-S区分是否开启-O1
+STAGES = [["-lexer"], ["-parser"], ["-llvm"], ["-llvm", "-O1"], ["-S"], ["-S", "-O1"]]
+
+def peak_rss(report, usage):
+    # 峰值RSS取编译器-time-report输出的peak_rss_kb(即VmHWM);
+    # wait4得到的ru_maxrss在exec后保留了本脚本进程的峰值, 只在没有报告时(例如编译器崩溃)使用
+    try:
+        with open(report) as f:
+            return json.load(f)["peak_rss_kb"]
+    except (OSError, ValueError, KeyError):
+        return usage.ru_maxrss
+    finally:
+        if os.path.exists(report):
+            os.remove(report)
+
+def run_compiler(compiler, stage, input, output, timeout):
+    # 返回(状态, 墙钟时间, 峰值RSS(KB))
+    report = output + ".json"
+    start = time.perf_counter()
+    p = subprocess.Popen([compiler, stage[0], "-o", output, input] + stage[1:] + ["-time-report=" + report],
+                         stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+    timer = threading.Timer(timeout, p.kill)
+    timer.start()
+    _, status, usage = os.wait4(p.pid, 0)
+    wall = time.perf_counter() - start
+    timed_out = not timer.is_alive()
+    timer.cancel()
+    p.returncode = os.waitstatus_to_exitcode(status)
+    rss = peak_rss(report, usage)
+    if timed_out:
+        return "timeout", wall, rss
+    if p.returncode != 0:
+        return "error(" + str(p.returncode) + ")", wall, rss
+    return "ok", wall, rss
+
+def slope(points):
+    # points为按输入大小排序的(输入字节数, 时间), 返回最大的两个规模之间 log(时间)对log(大小)的斜率
+    if len(points) < 2:
+        return None
+    (x1, y1), (x2, y2) = points[-2], points[-1]
+    if x2 <= x1 or y1 <= 0 or y2 <= 0:
+        return None
+    return math.log(y2 / y1) / math.log(x2 / x1)
+
+COLORS = ["#1f77b4", "#ff7f0e", "#2ca02c", "#d62728", "#9467bd", "#8c564b"]
+
+def plot_svg(path, title, series):
+    # series: {名称: [(输入字节数, 时间)]}, 双对数坐标, 虚线为斜率1(线性增长)的参考线
+    W, H, L, R, T, B = 720, 480, 70, 170, 40, 50
+    pts = [p for s in series.values() for p in s if p[1] > 0]
+    if not pts:
+        return
+    lx = [math.log10(p[0]) for p in pts]
+    ly = [math.log10(p[1]) for p in pts]
+    x0, x1 = min(lx), max(lx) + 1e-9
+    y0, y1 = min(ly) - 0.1, max(ly) + 0.1
+    sx = lambda v: L + (math.log10(v) - x0) / (x1 - x0) * (W - L - R)
+    sy = lambda v: H - B - (math.log10(v) - y0) / (y1 - y0) * (H - T - B)
+    out = ['<svg xmlns="http://www.w3.org/2000/svg" width="%d" height="%d" font-family="sans-serif" font-size="12">'
+           % (W, H)]
+    out.append('<rect width="100%" height="100%" fill="white"/>')
+    out.append('<text x="%d" y="20" font-size="14">%s</text>' % (L, title))
+    out.append('<line x1="%d" y1="%d" x2="%d" y2="%d" stroke="black"/>' % (L, H - B, W - R, H - B))
+    out.append('<line x1="%d" y1="%d" x2="%d" y2="%d" stroke="black"/>' % (L, T, L, H - B))
+    out.append('<text x="%d" y="%d">input size (bytes, log)</text>' % (L, H - 10))
+    out.append('<text x="10" y="%d" transform="rotate(-90 10 %d)">wall time (s, log)</text>' % (H // 2, H // 2))
+    for e in range(math.floor(y0), math.ceil(y1) + 1):
+        if y0 <= e <= y1:
+            y = sy(10 ** e)
+            out.append('<text x="%d" y="%.1f" text-anchor="end">1e%d</text>' % (L - 5, y + 4, e))
+    for e in range(math.floor(x0), math.ceil(x1) + 1):
+        if x0 <= e <= x1:
+            x = sx(10 ** e)
+            out.append('<text x="%.1f" y="%d" text-anchor="middle">1e%d</text>' % (x, H - B + 15, e))
+    # 以最小规模处最慢的一条曲线为起点画斜率1的参考线
+    first = max((s[0] for s in series.values() if s and s[0][1] > 0), key=lambda p: p[1], default=None)
+    if first is not None:
+        xe = 10 ** x1
+        ye = first[1] * xe / first[0]
+        out.append('<line x1="%.1f" y1="%.1f" x2="%.1f" y2="%.1f" stroke="gray" stroke-dasharray="4 4"/>'
+                   % (sx(first[0]), sy(first[1]), sx(xe), sy(min(ye, 10 ** y1))))
+    for i, (name, s) in enumerate(series.items()):
+        color = COLORS[i % len(COLORS)]
+        s = [p for p in s if p[1] > 0]
+        if s:
+            coords = " ".join("%.1f,%.1f" % (sx(x), sy(y)) for x, y in s)
+            out.append('<polyline points="%s" fill="none" stroke="%s" stroke-width="2"/>' % (coords, color))
+        y = T + 20 * i
+        out.append('<line x1="%d" y1="%d" x2="%d" y2="%d" stroke="%s" stroke-width="2"/>'
+                   % (W - R + 10, y, W - R + 30, y, color))
+        out.append('<text x="%d" y="%d">%s</text>' % (W - R + 35, y + 4, name))
+    out.append("</svg>")
+    with open(path, "w") as f:
+        f.write("\n".join(out) + "\n")
+
+parser = argparse.ArgumentParser(description="compile-time scaling benchmark")
+parser.add_argument("--compiler", default="./bin/SysYc")
+parser.add_argument("--output_folder", default="bench_output")
+parser.add_argument("--shapes", default=",".join(stress_gen.SHAPES.keys()), help="comma separated")
+parser.add_argument("--sizes", default="", help="comma separated, overrides the default sizes of every shape")
+parser.add_argument("--stages", default="", help="comma separated, e.g. -llvm,-S -O1 (default: all stages)")
+parser.add_argument("--timeout", type=float, default=300)
+parser.add_argument("--repeat", type=int, default=1, help="take the fastest of N runs")
+parser.add_argument("--threshold", type=float, default=1.5, help="report slopes above this as superlinear")
+parser.add_argument("--min_time", type=float, default=0.05, help="ignore timings below this when checking slopes")
+args = parser.parse_args()
+
+os.makedirs(args.output_folder, exist_ok=True)
+shapes = [s for s in args.shapes.split(",") if s]
+stages = [s.split() for s in args.stages.split(",") if s] if args.stages else STAGES
+tmp_out = os.path.join(args.output_folder, "tmp.out")
+
+rows = []
+superlinear = []
+for shape in shapes:
+    sizes = [int(n) for n in args.sizes.split(",") if n] if args.sizes else stress_gen.DEFAULT_SIZES[shape]
+    series = {" ".join(stage): [] for stage in stages}
+    failed = set()
+    for n in sizes:
+        input = stress_gen.generate(shape, n, args.output_folder)
+        size = os.path.getsize(input)
+        for stage in stages:
+            name = " ".join(stage)
+            if name in failed:
+                # 较小规模已经失败或超时, 不再测试更大的规模
+                rows.append([shape, n, size, name, "skipped", "", ""])
+                continue
+            best = None
+            for _ in range(args.repeat):
+                result = run_compiler(args.compiler, stage, input, tmp_out, args.timeout)
+                if best is None or (result[0] == "ok" and result[1] < best[1]):
+                    best = result
+            status, wall, rss = best
+            rows.append([shape, n, size, name, status, "%.6f" % wall, rss])
+            if status == "ok":
+                series[name].append((size, wall))
+            else:
+                failed.add(name)
+            color = "\033[92m" if status == "ok" else "\033[91m"
+            print("%-12s n=%-7d %9d bytes  %-10s %s%-8s\033[0m %9.3fs %9d KB" % (shape, n, size, name, color,
+                                                                                 status, wall, rss))
+    for name, points in series.items():
+        k = slope([p for p in points if p[1] >= args.min_time])
+        if k is not None and k > args.threshold:
+            superlinear.append((shape, name, k))
+    plot_svg(os.path.join(args.output_folder, "scaling_" + shape + ".svg"), shape, series)
+
+with open(os.path.join(args.output_folder, "scaling.csv"), "w", newline="") as f:
+    writer = csv.writer(f)
+    writer.writerow(["shape", "n", "bytes", "stage", "status", "wall_s", "peak_rss_kb"])
+    writer.writerows(rows)
+if os.path.exists(tmp_out):
+    os.remove(tmp_out)
+
+print("results: " + os.path.join(args.output_folder, "scaling.csv"))
+for shape, name, k in superlinear:
+    print("\033[91mSuperlinear on \033[0m" + shape + " " + name + ": time ~ size^%.2f" % k)
+failures = [r for r in rows if r[4] != "ok" and r[4] != "skipped"]
+for r in failures:
+    print("\033[91m" + r[4] + " on \033[0m" + r[0] + " n=" + str(r[1]) + " " + r[3])
+if superlinear or failures:
+    exit(1)
@@ -1,6 +1,8 @@
 #ifndef INSTRUCTION_H
 #define INSTRUCTION_H
 
+#include "arena.h"
+#include "output_buffer.h"
 #include "symtab.h"
 #include <assert.h>
 #include <iostream>
@@ -83,8 +85,9 @@
 // 你首先需要阅读utils/Instruction_out.cc来了解指令是如何输出的
 // 除注释特别说明外，成员函数不允许设置为nullptr，否则指令输出时会出现段错误
 
-// 我们规定，对于GlobalOperand, LabelOperand, RegOperand, 只要操作数相同, 地址也相同
+// 我们规定，对于GlobalOperand, LabelOperand, RegOperand以及立即数操作数, 只要操作数相同, 地址也相同
 // 所以这些Operand的构造函数是private, 使用GetNew***Operand函数来获取新的操作数变量
+// 因此可以直接通过比较指针来判断两个操作数是否相同
 
 // 对于不同位置的指令，即使内容完全相同，也不推荐使用相同的地址,
 // 当你向基本块中插入指令时，推荐先new一个，不要使用之前已经插入过的指令，你需要保证地址不同，
@@ -98,6 +101,10 @@
 
 // 请注意代码中的typedef，为了方便书写，将一些类的指针进行了重命名, 如果不习惯该种风格，可以自行修改
 
+// 中间代码生成时新建的指令统一使用ir_arena->New<T>(...)分配,
+// ir_arena指向当前正在生成的函数的arena(生成全局定义时指向全局arena), 见LLVMIR::GetArena
+extern Arena *ir_arena;
+
 class BasicOperand;
 typedef BasicOperand *Operand;
 // @operands in instruction
@@ -112,6 +119,8 @@ public:
     BasicOperand() {}
     operand_type GetOperandType() { return operandType; }
     virtual std::string GetFullName() = 0;
+    // 直接将GetFullName()的结果输出到s, 不构造临时字符串
+    virtual void PrintFullName(OutputBuffer &s) = 0;
 };
 
 // @register operand;%r+register No
@@ -127,52 +136,67 @@ public:
 
     friend RegOperand *GetNewRegOperand(int RegNo);
     virtual std::string GetFullName();
+    virtual void PrintFullName(OutputBuffer &s);
 };
 RegOperand *GetNewRegOperand(int RegNo);
+// 寄存器编号和标签编号以编号为下标保存在操作数表中, 表的容量有限
+// 从快照或.ll读入的编号需要先检查范围, 寄存器编号可以为-1(无返回值的函数调用)
+static constexpr long long OPERAND_TABLE_SIZE = 1 << 26;
+inline bool IsValidRegNo(long long RegNo) { return RegNo >= -1 && RegNo + 1 < OPERAND_TABLE_SIZE; }
+inline bool IsValidLabelNo(long long LabelNo) { return LabelNo >= 0 && LabelNo < OPERAND_TABLE_SIZE; }
 
 // @integer32 immediate
 class ImmI32Operand : public BasicOperand {
     int immVal;
-
-public:
-    int GetIntImmVal() { return immVal; }
-
     ImmI32Operand(int immVal) {
         this->operandType = IMMI32;
         this->immVal = immVal;
     }
+
+public:
+    int GetIntImmVal() { return immVal; }
+
+    friend ImmI32Operand *GetNewImmI32Operand(int immVal);
     virtual std::string GetFullName();
+    virtual void PrintFullName(OutputBuffer &s);
 };
+ImmI32Operand *GetNewImmI32Operand(int immVal);
 
 // @integer64 immediate
 class ImmI64Operand : public BasicOperand {
     long long immVal;
-
-public:
-    long long GetLlImmVal() { return immVal; }
-
     ImmI64Operand(long long immVal) {
         this->operandType = IMMI64;
         this->immVal = immVal;
     }
+
+public:
+    long long GetLlImmVal() { return immVal; }
+
+    friend ImmI64Operand *GetNewImmI64Operand(long long immVal);
     virtual std::string GetFullName();
+    virtual void PrintFullName(OutputBuffer &s);
 };
+ImmI64Operand *GetNewImmI64Operand(long long immVal);
 
 // @float32 immediate
 class ImmF32Operand : public BasicOperand {
     float immVal;
+    ImmF32Operand(float immVal) {
+        this->operandType = IMMF32;
+        this->immVal = immVal;
+    }
 
 public:
     float GetFloatVal() { return immVal; }
 
     long long GetFloatByteVal();
 
-    ImmF32Operand(float immVal) {
-        this->operandType = IMMF32;
-        this->immVal = immVal;
-    }
+    friend ImmF32Operand *GetNewImmF32Operand(float immVal);
     virtual std::string GetFullName();
+    virtual void PrintFullName(OutputBuffer &s);
 };
+ImmF32Operand *GetNewImmF32Operand(float immVal);
 
 // @label %L+label No
 class LabelOperand : public BasicOperand {
@@ -187,6 +211,7 @@ public:
 
     friend LabelOperand *GetNewLabelOperand(int LabelNo);
     virtual std::string GetFullName();
+    virtual void PrintFullName(OutputBuffer &s);
 };
 
 LabelOperand *GetNewLabelOperand(int RegNo);
@@ -204,11 +229,14 @@ public:
 
     friend GlobalOperand *GetNewGlobalOperand(std::string name);
     virtual std::string GetFullName();
+    virtual void PrintFullName(OutputBuffer &s);
 };
 
 GlobalOperand *GetNewGlobalOperand(std::string name);
 
 class BasicInstruction;
+class BasicBlock;
+class InstructionList;
 
 typedef BasicInstruction *Instruction;
 
@@ -284,13 +312,25 @@ public:
     };
 
 private:
+    // 指令在所属基本块的指令链表中的前驱和后继, 以及所属的基本块, 均由InstructionList维护
+    BasicInstruction *prev = nullptr;
+    BasicInstruction *next = nullptr;
+    BasicBlock *parent = nullptr;
+    friend class InstructionList;
+
 protected:
     LLVMIROpcode opcode;
 
 public:
     int GetOpcode() { return opcode; }    // one solution: convert to pointer of subclasses
 
-    virtual void PrintIR(std::ostream &s) = 0;
+    // 获取指令所属的基本块, 指令不在任何基本块中时返回nullptr
+    BasicBlock *GetParent() { return parent; }
+    // 获取同一基本块中的前一条/后一条指令, 不存在时返回nullptr
+    BasicInstruction *GetPrev() { return prev; }
+    BasicInstruction *GetNext() { return next; }
+
+    virtual void PrintIR(OutputBuffer &s) = 0;
 
     // 用于修改操作数
     virtual void ReplaceRegByMap(const std::map<int, int> &Rule) = 0;
@@ -319,7 +359,7 @@ public:
         this->result = result;
         this->pointer = pointer;
     }
-    void PrintIR(std::ostream &s);
+    void PrintIR(OutputBuffer &s);
 
     // 用于修改操作数
     void ReplaceRegByMap(const std::map<int, int> &Rule);
@@ -358,7 +398,7 @@ public:
         this->value = value;
     }
 
-    virtual void PrintIR(std::ostream &s);
+    virtual void PrintIR(OutputBuffer &s);
 
     // 用于修改操作数
     void ReplaceRegByMap(const std::map<int, int> &Rule);
@@ -402,7 +442,7 @@ public:
         this->type = type;
     }
 
-    virtual void PrintIR(std::ostream &s);
+    virtual void PrintIR(OutputBuffer &s);
 
     // 用于修改操作数
     void ReplaceRegByMap(const std::map<int, int> &Rule);
@@ -442,7 +482,7 @@ public:
         this->cond = cond;
         this->result = result;
     }
-    virtual void PrintIR(std::ostream &s);
+    virtual void PrintIR(OutputBuffer &s);
 
     // 用于修改操作数
     void ReplaceRegByMap(const std::map<int, int> &Rule);
@@ -479,7 +519,7 @@ public:
         this->cond = cond;
         this->result = result;
     }
-    virtual void PrintIR(std::ostream &s);
+    virtual void PrintIR(OutputBuffer &s);
 
     // 用于修改操作数
     void ReplaceRegByMap(const std::map<int, int> &Rule);
@@ -513,8 +553,9 @@ public:
         this->type = type;
         this->result = result;
     }
-    virtual void PrintIR(std::ostream &s);
+    virtual void PrintIR(OutputBuffer &s);
 
+    enum LLVMType GetDataType() { return type; }
     std::vector<std::pair<Operand, Operand>> &GetPhiList() { return phi_list; }
     Operand GetResult() { return result; }
 
@@ -559,7 +600,7 @@ public:
         dims = ArrDims;
     }
 
-    virtual void PrintIR(std::ostream &s);
+    virtual void PrintIR(OutputBuffer &s);
 
     // 获取分配的寄存器
     int GetResultRegNo() { return ((RegOperand *)result)->GetRegNo(); }
@@ -599,7 +640,7 @@ public:
         this->falseLabel = falseLabel;
     }
 
-    virtual void PrintIR(std::ostream &s);
+    virtual void PrintIR(OutputBuffer &s);
 
     // 新加函数：重新设置 TrueLabel 和 FalseLabel
     void SetTrueLabel(Operand truelabel) { this->trueLabel = truelabel; }
@@ -628,7 +669,7 @@ public:
         this->opcode = BR_UNCOND;
         this->destLabel = destLabel;
     }
-    virtual void PrintIR(std::ostream &s);
+    virtual void PrintIR(OutputBuffer &s);
 
     // 新加函数：重新设置 destlabel
     void SetDstLabel(Operand deslabel) { this->destLabel = deslabel; }
@@ -662,10 +703,10 @@ public:
         this->opcode = LLVMIROpcode::GLOBAL_VAR;
     }
     GlobalVarDefineInstruction(std::string nam, enum LLVMType typ, VarAttribute v)
-        : name(nam), type(typ), arrayval(v), init_val{nullptr} {
+        : name(nam), type(typ), arrayval(std::move(v)), init_val{nullptr} {
         this->opcode = LLVMIROpcode::GLOBAL_VAR;
     }
-    virtual void PrintIR(std::ostream &s);
+    virtual void PrintIR(OutputBuffer &s);
 
     // 用于修改操作数
     void ReplaceRegByMap(const std::map<int, int> &Rule);
@@ -682,7 +723,7 @@ public:
         this->opcode = LLVMIROpcode::GLOBAL_STR;
     }
 
-    virtual void PrintIR(std::ostream &s);
+    virtual void PrintIR(OutputBuffer &s);
 
     // 用于修改操作数
     void ReplaceRegByMap(const std::map<int, int> &Rule);
@@ -737,7 +778,7 @@ public:
     std::vector<std::pair<enum LLVMType, Operand>> GetParameterList() { return args; }
     void push_back_Parameter(std::pair<enum LLVMType, Operand> newPara) { args.push_back(newPara); }
     void push_back_Parameter(enum LLVMType type, Operand val) { args.push_back(std::make_pair(type, val)); }
-    virtual void PrintIR(std::ostream &s);
+    virtual void PrintIR(OutputBuffer &s);
 
     // 用于修改操作数
     void ReplaceRegByMap(const std::map<int, int> &Rule);
@@ -780,7 +821,7 @@ public:
     enum LLVMType GetType() { return ret_type; }
     Operand GetRetVal() { return ret_val; }
 
-    virtual void PrintIR(std::ostream &s);
+    virtual void PrintIR(OutputBuffer &s);
 
     // 用于修改操作数
     void ReplaceRegByMap(const std::map<int, int> &Rule);
@@ -824,18 +865,19 @@ public:
     }
     void push_dim(int d) { dims.push_back(d); }
     void push_idx_reg(int idx_reg_no) { indexes.push_back(GetNewRegOperand(idx_reg_no)); }
-    void push_idx_imm32(int imm_idx) { indexes.push_back(new ImmI32Operand(imm_idx)); }
+    void push_idx_imm32(int imm_idx) { indexes.push_back(GetNewImmI32Operand(imm_idx)); }
     void push_index(Operand idx) { indexes.push_back(idx); }
     void change_index(int i, Operand op) { indexes[i] = op; }
 
     enum LLVMType GetType() { return type; }
+    enum LLVMType GetIndexType() { return index_type; }
     Operand GetResult() { return result; }
     void SetResult(Operand op) { result = op; }
     Operand GetPtrVal() { return ptrval; }
     std::vector<int> GetDims() { return dims; }
     std::vector<Operand> GetIndexes() { return indexes; }
 
-    void PrintIR(std::ostream &s);
+    void PrintIR(OutputBuffer &s);
 
     // 用于修改操作数
     void ReplaceRegByMap(const std::map<int, int> &Rule);
@@ -869,7 +911,7 @@ public:
     enum LLVMType GetReturnType() { return return_type; }
     std::string GetFunctionName() { return Func_name; }
 
-    void PrintIR(std::ostream &s);
+    void PrintIR(OutputBuffer &s);
 
     // 用于修改操作数
     void ReplaceRegByMap(const std::map<int, int> &Rule);
@@ -893,7 +935,7 @@ public:
     enum LLVMType GetReturnType() { return return_type; }
     std::string GetFunctionName() { return Func_name; }
 
-    void PrintIR(std::ostream &s);
+    void PrintIR(OutputBuffer &s);
 
     // 用于修改操作数
     void ReplaceRegByMap(const std::map<int, int> &Rule);
@@ -914,7 +956,7 @@ public:
     }
     Operand GetResult() { return result; }
     Operand GetSrc() { return value; }
-    void PrintIR(std::ostream &s);
+    void PrintIR(OutputBuffer &s);
 
     // 用于修改操作数
     void ReplaceRegByMap(const std::map<int, int> &Rule);
@@ -940,7 +982,7 @@ public:
 
     Operand GetResult() { return result; }
     Operand GetSrc() { return value; }
-    void PrintIR(std::ostream &s);
+    void PrintIR(OutputBuffer &s);
 
     // 用于修改操作数
     void ReplaceRegByMap(const std::map<int, int> &Rule);
@@ -963,11 +1005,13 @@ private:
 public:
     Operand GetResult() { return result; }
     Operand GetSrc() { return value; }
+    LLVMType GetFromType() { return from_type; }
+    LLVMType GetToType() { return to_type; }
     ZextInstruction(LLVMType to_type, Operand result_receiver, LLVMType from_type, Operand value_for_cast)
         : to_type(to_type), result(result_receiver), from_type(from_type), value(value_for_cast) {
         this->opcode = ZEXT;
     }
-    void PrintIR(std::ostream &s);
+    void PrintIR(OutputBuffer &s);
 
     // 用于修改操作数
     void ReplaceRegByMap(const std::map<int, int> &Rule);
@@ -979,9 +1023,9 @@ public:
     Operand GetModified() { return result; }
 };
 
-std::ostream &operator<<(std::ostream &s, BasicInstruction::LLVMType type);
-std::ostream &operator<<(std::ostream &s, BasicInstruction::LLVMIROpcode type);
-std::ostream &operator<<(std::ostream &s, BasicInstruction::IcmpCond type);
-std::ostream &operator<<(std::ostream &s, BasicInstruction::FcmpCond type);
-std::ostream &operator<<(std::ostream &s, Operand op);
+OutputBuffer &operator<<(OutputBuffer &s, BasicInstruction::LLVMType type);
+OutputBuffer &operator<<(OutputBuffer &s, BasicInstruction::LLVMIROpcode type);
+OutputBuffer &operator<<(OutputBuffer &s, BasicInstruction::IcmpCond type);
+OutputBuffer &operator<<(OutputBuffer &s, BasicInstruction::FcmpCond type);
+OutputBuffer &operator<<(OutputBuffer &s, Operand op);
 #endif
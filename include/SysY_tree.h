@@ -664,4 +664,8 @@ public:
     void printAST(std::ostream &s, int pad);
 };
 typedef __Program *Program;
+
+// 语法树节点以及节点中的std::vector均由ast_arena.New<T>(...)分配(见SysY_parser.y)
+// 中间代码生成之后不再使用语法树, 在codeIR之后通过ast_arena.Release()整体释放
+extern Arena ast_arena;
 #endif
\ No newline at end of file
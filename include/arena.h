@@ -0,0 +1,84 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/*
+    线性(bump)分配器: 从成块申请的内存中顺序切分出对象, 不支持单独释放, 只能通过Release整体释放
+    中间代码中的指令、立即数操作数和基本块数量多且生命周期一致(随函数一起生成, 在函数翻译为机器指令后一起失效),
+    适合使用这种分配方式, 可以减少malloc的调用次数, 同时让同一函数的对象在内存中更紧凑
+*/
+class Arena {
+private:
+    static constexpr size_t BLOCK_SIZE = 64 * 1024;
+
+    std::vector<char *> blocks{};
+    char *cur = nullptr;
+    char *end = nullptr;
+    size_t bytes = 0;
+
+    // 需要调用析构函数的对象(例如含有std::vector成员的指令), 在Release时按创建的逆序析构
+    // 记录对象的实际类型对应的析构函数, 因此不要求基类的析构函数为虚函数
+    std::vector<std::pair<void *, void (*)(void *)>> dtors{};
+
+    void *AllocateSlow(size_t size, size_t align) {
+        size_t block_size = size + align > BLOCK_SIZE ? size + align : BLOCK_SIZE;
+        char *block = (char *)std::malloc(block_size);
+        if (block == nullptr) {
+            throw std::bad_alloc();
+        }
+        blocks.push_back(block);
+        cur = block;
+        end = block + block_size;
+        return Allocate(size, align);
+    }
+
+public:
+    Arena() = default;
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+    ~Arena() { Release(); }
+
+    void *Allocate(size_t size, size_t align) {
+        size_t addr = (size_t)cur;
+        size_t aligned = (addr + align - 1) & ~(align - 1);
+        if (cur == nullptr || aligned + size > (size_t)end) {
+            return AllocateSlow(size, align);
+        }
+        cur = (char *)(aligned + size);
+        bytes += size;
+        return (void *)aligned;
+    }
+
+    template <class T, class... Args> T *New(Args &&...args) {
+        T *obj = new (Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            dtors.push_back({obj, [](void *p) { ((T *)p)->~T(); }});
+        }
+        return obj;
+    }
+
+    // 析构并释放该arena中的所有对象, 之后arena可以继续使用
+    void Release() {
+        for (auto it = dtors.rbegin(); it != dtors.rend(); ++it) {
+            it->second(it->first);
+        }
+        dtors.clear();
+        for (auto block : blocks) {
+            std::free(block);
+        }
+        blocks.clear();
+        cur = end = nullptr;
+        bytes = 0;
+    }
+
+    // 当前已分配的对象字节数
+    size_t BytesAllocated() const { return bytes; }
+};
+
+#endif
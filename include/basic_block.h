@@ -2,17 +2,127 @@
 #define BASIC_BLOCK_H
 
 #include "Instruction.h"
-#include <deque>
+#include <cstddef>
 #include <iostream>
+#include <iterator>
 #include <set>
 #include <vector>
 
+/*
+    基本块的指令链表, 链表指针直接保存在指令中(见BasicInstruction::prev/next), 即侵入式双向链表
+    在任意位置插入、删除指令都是O(1)的, 并且插入、删除不会使指向其他指令的迭代器失效
+    因此可以在遍历的同时删除指令(it = list.erase(it)), 也可以先记录要删除的指令, 最后通过erase(I)直接删除
+    一条指令同一时刻只能属于一个基本块, 删除后的指令可以重新插入到其他位置
+*/
+class InstructionList {
+private:
+    BasicBlock *parent;
+    Instruction head = nullptr;
+    Instruction tail = nullptr;
+    size_t count = 0;
+
+public:
+    class iterator {
+    private:
+        Instruction cur;
+        const InstructionList *list;
+
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = Instruction;
+        using difference_type = std::ptrdiff_t;
+        using pointer = Instruction *;
+        using reference = Instruction;
+
+        iterator() : cur(nullptr), list(nullptr) {}
+        iterator(Instruction cur, const InstructionList *list) : cur(cur), list(list) {}
+
+        Instruction operator*() const { return cur; }
+        iterator &operator++() {
+            cur = cur->next;
+            return *this;
+        }
+        iterator operator++(int) {
+            auto ret = *this;
+            ++*this;
+            return ret;
+        }
+        // end()--得到最后一条指令
+        iterator &operator--() {
+            cur = cur == nullptr ? list->tail : cur->prev;
+            return *this;
+        }
+        iterator operator--(int) {
+            auto ret = *this;
+            --*this;
+            return ret;
+        }
+        bool operator==(const iterator &that) const { return cur == that.cur; }
+        bool operator!=(const iterator &that) const { return cur != that.cur; }
+    };
+    using reverse_iterator = std::reverse_iterator<iterator>;
+
+    InstructionList(BasicBlock *parent) : parent(parent) {}
+    InstructionList(const InstructionList &) = delete;
+    InstructionList &operator=(const InstructionList &) = delete;
+
+    iterator begin() const { return iterator(head, this); }
+    iterator end() const { return iterator(nullptr, this); }
+    reverse_iterator rbegin() const { return reverse_iterator(end()); }
+    reverse_iterator rend() const { return reverse_iterator(begin()); }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    Instruction front() const { return head; }
+    Instruction back() const { return tail; }
+
+    // 在pos之前插入指令I, 返回指向I的迭代器
+    iterator insert(iterator pos, Instruction I) {
+        assert(I->parent == nullptr);
+        Instruction next = *pos;
+        Instruction prev = next == nullptr ? tail : next->prev;
+        I->prev = prev;
+        I->next = next;
+        I->parent = parent;
+        (prev == nullptr ? head : prev->next) = I;
+        (next == nullptr ? tail : next->prev) = I;
+        ++count;
+        return iterator(I, this);
+    }
+    // 在指令pos之前/之后插入指令I, pos必须属于该基本块
+    void InsertBefore(Instruction pos, Instruction I) { insert(iterator(pos, this), I); }
+    void InsertAfter(Instruction pos, Instruction I) { insert(iterator(pos->next, this), I); }
+
+    // 从链表中删除指令I(不释放I), 返回指向I的后一条指令的迭代器
+    iterator erase(Instruction I) {
+        assert(I->parent == parent);
+        Instruction next = I->next;
+        (I->prev == nullptr ? head : I->prev->next) = I->next;
+        (I->next == nullptr ? tail : I->next->prev) = I->prev;
+        I->prev = I->next = nullptr;
+        I->parent = nullptr;
+        --count;
+        return iterator(next, this);
+    }
+    iterator erase(iterator pos) { return erase(*pos); }
+
+    void push_back(Instruction I) { insert(end(), I); }
+    void push_front(Instruction I) { insert(begin(), I); }
+    void pop_back() { erase(tail); }
+    void pop_front() { erase(head); }
+    void clear() {
+        while (head != nullptr) {
+            erase(head);
+        }
+    }
+};
+
 // 请注意代码中的typedef，为了方便书写，将一些类的指针进行了重命名, 如果不习惯该种风格，可以自行修改
 class BasicBlock {
 public:
     std::string comment;    // used for debug
     int block_id = 0;
-    std::deque<Instruction> Instruction_list{};
+    InstructionList Instruction_list{this};
 
     /*
         pos = 1 -> end   pos = 0 -> begin
@@ -22,9 +132,9 @@ public:
     */
     void InsertInstruction(int pos, Instruction Ins);
 
-    void printIR(std::ostream &s);
+    void printIR(OutputBuffer &s);
     BasicBlock(int id) : block_id(id) {}
 };
 typedef BasicBlock *LLVMBlock;
 
-#endif
\ No newline at end of file
+#endif
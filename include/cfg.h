@@ -8,8 +8,37 @@
 #include <map>
 #include <queue>
 #include <set>
+#include <span>
 #include <vector>
 
+/*
+    压缩稀疏行(CSR)形式的邻接表: 所有边存放在同一个数组中, 节点u的邻接点为edges[start[u], start[u] + count[u])
+    访问邻接点时直接返回数组上的span, 不需要拷贝
+    增加边时如果u的区间已满, 将u的区间搬到数组末尾并扩大容量, 原区间作废, 均摊O(1)
+*/
+class BlockGraph {
+private:
+    std::vector<LLVMBlock> edges{};
+    std::vector<int> start{};
+    std::vector<int> count{};
+    std::vector<int> capacity{};
+
+public:
+    // 由边表建图, 同一起点的边保持在edge_list中的相对顺序
+    void Build(int n, const std::vector<std::pair<int, LLVMBlock>> &edge_list);
+    // 节点数扩大到n, 新节点没有邻接点
+    void Resize(int n);
+    void AddEdge(int u, LLVMBlock v);
+    // 删除一条u->v的边, u的其余邻接点保持原有顺序, 不存在该边时返回false
+    bool RemoveEdge(int u, LLVMBlock v);
+    void clear();
+
+    size_t size() const { return start.size(); }
+    std::span<const LLVMBlock> operator[](int u) const {
+        return std::span<const LLVMBlock>(edges.data() + start[u], count[u]);
+    }
+};
+
 class CFG {
 public:
     FuncDefInstruction function_def;
@@ -18,8 +47,10 @@ public:
       you can see it in the LLVMIR::CFGInit()*/
     std::map<int, LLVMBlock> *block_map;
 
-    // 逆后序: 将深度优先搜索的顺序反过来
+    // 逆后序/后序, 控制流图修改后会在下次获取时重新计算
     std::vector<int> rev_ord{};
+    std::vector<int> post_ord{};
+    bool order_valid = false;
 
     // 标识当前函数中正在处理的基本块
     int func_cur_label = -1;
@@ -35,16 +66,31 @@ public:
     int loop_end_label = -1;
 
     // 使用邻接表存图
-    std::vector<std::vector<LLVMBlock>> G{};       // control flow graph
-    std::vector<std::vector<LLVMBlock>> invG{};    // inverse control flow graph
+    BlockGraph G{};       // control flow graph
+    BlockGraph invG{};    // inverse control flow graph
 
     void BuildCFG();
+    // 只根据各基本块末尾的跳转指令建立G和invG, 不修改中间代码, 要求每个基本块都以跳转/返回指令结尾
+    void BuildEdges();
+
+    // 获取某个基本块节点的前驱/后继, 返回的span在修改控制流图后失效
+    std::span<const LLVMBlock> GetPredecessor(LLVMBlock B);
+    std::span<const LLVMBlock> GetPredecessor(int bbid);
+    std::span<const LLVMBlock> GetSuccessor(LLVMBlock B);
+    std::span<const LLVMBlock> GetSuccessor(int bbid);
+
+    // 增量修改控制流图: 修改跳转指令后调用, 同时维护G和invG, 不需要重新BuildCFG
+    void AddEdge(int from, int to);
+    void RemoveEdge(int from, int to);
+    // 交换G和invG(用于在反向图上建立后支配树)
+    void Reverse();
+
+    // 从入口出发的逆后序/后序, 只包含可达的基本块, O(V+E)
+    const std::vector<int> &GetReversePostOrder();
+    const std::vector<int> &GetPostOrder();
 
-    // 获取某个基本块节点的前驱/后继
-    std::vector<LLVMBlock> GetPredecessor(LLVMBlock B);
-    std::vector<LLVMBlock> GetPredecessor(int bbid);
-    std::vector<LLVMBlock> GetSuccessor(LLVMBlock B);
-    std::vector<LLVMBlock> GetSuccessor(int bbid);
+private:
+    void ComputeOrder();
 };
 
 #endif
\ No newline at end of file
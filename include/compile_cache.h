@@ -0,0 +1,53 @@
+#ifndef COMPILE_CACHE_H
+#define COMPILE_CACHE_H
+
+#include <atomic>
+#include <string>
+#include <string_view>
+
+/*
+    按函数的编译缓存(-cache-dir=DIR): 以 编译器版本+编译选项+函数优化后的中间代码 为键, 保存该函数的汇编代码
+    命中时直接拼接保存的汇编, 跳过该函数的指令选择、寄存器分配等后端阶段
+    每个条目是目录中的一个文件, 文件名为键的哈希值, 文件中同时保存完整的键, 读取时逐字节比较, 因此哈希冲突只会导致未命中
+    写入时先写临时文件再rename, 多个编译器进程可以同时使用同一个目录
+    命中时更新条目的修改时间, 目录总大小超过上限(-cache-size=MB)时按修改时间从旧到新删除条目(LRU)
+*/
+class CompileCache {
+private:
+    bool enabled = false;
+    std::string dir{};
+    long long max_bytes = 0;
+    // 所有键共同的前缀: 编译器版本和影响输出的编译选项
+    std::string context{};
+    std::atomic<int> hits{0};
+    std::atomic<int> misses{0};
+    std::atomic<int> stores{0};
+
+    std::string EntryPath(std::string_view key) const;
+
+public:
+    // 默认容量512MB
+    static constexpr long long DEFAULT_SIZE_MB = 512;
+
+    // 目录不存在时创建, 无法使用时输出警告并保持关闭
+    void Enable(std::string_view dir, long long max_mb);
+    bool IsEnabled() const { return enabled; }
+    // flags为影响生成代码的编译选项, 与编译器可执行文件的大小和修改时间一起作为所有键的前缀
+    void SetContext(std::string_view flags);
+    // 由函数的中间代码得到完整的键
+    std::string MakeKey(std::string_view func_ir) const { return context + std::string(func_ir); }
+
+    // 查找key对应的汇编代码, 命中时写入asm_out并更新条目的访问时间, 可以在多个线程中同时调用
+    bool Lookup(std::string_view key, std::string &asm_out);
+    // 保存key对应的汇编代码, 可以在多个线程中同时调用
+    void Store(std::string_view key, std::string_view asm_code);
+    // 本次编译写入过新条目且目录总大小超过上限时, 删除最久未使用的条目, 直到总大小不超过上限的90%
+    void Trim();
+
+    int GetHits() const { return hits; }
+    int GetMisses() const { return misses; }
+};
+
+extern CompileCache compile_cache;
+
+#endif
@@ -2,6 +2,7 @@
 #define IR_H
 
 #include "Instruction.h"
+#include "arena.h"
 #include "cfg.h"
 #include <map>
 
@@ -23,21 +24,49 @@ public:
     // 你必须保证函数的入口基本块为0号基本块，否则在后端会出现错误。
     std::map<FuncDefInstruction, std::map<int, LLVMBlock>> function_block_map;
 
+    // 按定义顺序保存的所有函数, 上面的map以指针为键, 遍历顺序取决于函数定义指令的地址
+    // 输出中间代码和汇编时按该顺序遍历, 保证函数的输出顺序与源程序一致
+    std::vector<FuncDefInstruction> function_order{};
+
+    // 全局变量定义、函数声明和函数定义指令所在的arena, 在整个编译过程中有效
+    Arena global_arena;
+
+    // key为函数定义指令, value为该函数的指令、立即数操作数和基本块所在的arena
+    // 函数翻译为机器指令后, 可以通过ReleaseFunction整体释放
+    std::map<FuncDefInstruction, Arena> function_arena;
+
     // 我们用函数定义指令来对应一个函数
     // 在LLVMIR中新建一个函数
-    void NewFunction(FuncDefInstruction I) { function_block_map[I] = {}; }
+    void NewFunction(FuncDefInstruction I) {
+        function_block_map[I] = {};
+        function_arena[I];
+        function_order.push_back(I);
+    }
+
+    Arena &GetArena(FuncDefInstruction I) { return function_arena[I]; }
+
+    // 释放函数I的所有基本块和指令, 之后不能再访问该函数的中间代码
+    void ReleaseFunction(FuncDefInstruction I);
 
     // 获取一个在函数I中编号为now_label的基本块, 该基本块必须已存在
     LLVMBlock GetBlock(FuncDefInstruction I, int now_label) { return function_block_map[I][now_label]; }
 
     // 在函数I中新建一个新的编号为x的基本块, 该编号不能与已经有的重复
     LLVMBlock NewBlock(FuncDefInstruction I, int x) {
-        function_block_map[I][x] = new BasicBlock(x);
+        function_block_map[I][x] = function_arena[I].New<BasicBlock>(x);
         return GetBlock(I, x);
     }
-    void printIR(std::ostream &s);
+    void printIR(OutputBuffer &s);
+    // 只输出函数I的定义(函数头和所有基本块)
+    void printFunctionIR(OutputBuffer &s, FuncDefInstruction I);
 
-    void CFGInit();
+    // 为每个函数建立控制流图, simplify为true时同时删除不可达基本块并重新编号(见CFG::BuildCFG)
+    // 从快照或.ll读入的中间代码已经化简过, 使用simplify = false只建立控制流图, 保证与保存时完全一致
+    void CFGInit(bool simplify = true);
+    // 检查函数I的基本块能否建立控制流图: 存在入口基本块L0, 每个基本块以br/ret结尾, 跳转目标都是已有的基本块,
+    // 所有基本块都从L0可达, 使用的寄存器都有定义, 并且满足中端和后端依赖的中间代码生成的约定
+    // 用于检查从快照或.ll读入的中间代码, 不满足时将原因写入error并返回false
+    bool CheckBlocks(FuncDefInstruction I, std::string &error);
     void BuildCFG();
 };
 
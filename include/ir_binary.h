@@ -0,0 +1,137 @@
+#ifndef IR_BINARY_H
+#define IR_BINARY_H
+
+#include "ir.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+/*
+    中间代码的二进制格式(快照), 用于在任意pass之后保存LLVMIR, 之后从快照继续执行后面的阶段
+    文件由文件头和若干段组成, 每段是定长记录的数组, 按8字节对齐, 文件映射到内存后可以直接按数组访问, 不需要解析文本
+    记录之间通过下标引用:
+        字符串段保存(偏移, 长度), 字符内容统一保存在字符串数据段中, 相同的字符串只保存一次
+        操作数段中每个不同的操作数只保存一次, 指令通过操作数的下标引用操作数
+        寄存器和label本身就是函数内稠密的编号, 直接保存在操作数记录中
+        函数记录指向连续的基本块记录, 基本块记录指向连续的指令记录
+        变长的内容(phi的incoming、call的参数、数组的维度和初值等)保存在额外数据段(uint32数组)中, 记录保存其起始位置和长度
+    整数按本机字节序保存, 只能在相同字节序的机器上读取
+*/
+
+static constexpr char IR_BINARY_MAGIC[8] = {'S', 'Y', 'S', 'Y', 'I', 'R', 'B', '\0'};
+// 修改任何记录的格式时需要增加版本号
+static constexpr uint32_t IR_BINARY_VERSION = 1;
+// 空操作数(例如ret void的返回值)和不存在的字符串
+static constexpr uint32_t IR_BINARY_NONE = 0xffffffffu;
+
+enum IRBinarySectionId {
+    IRB_STRING_DATA = 0,    // char
+    IRB_STRINGS,            // IRBString
+    IRB_OPERANDS,           // IRBOperand
+    IRB_DECLARES,           // IRBDeclare
+    IRB_GLOBALS,            // IRBGlobal
+    IRB_FUNCTIONS,          // IRBFunction
+    IRB_BLOCKS,             // IRBBlock
+    IRB_INSTS,              // IRBInst
+    IRB_EXTRA,              // uint32_t
+    IRB_SECTION_NUM
+};
+
+struct IRBSection {
+    uint64_t offset;
+    uint64_t count;
+};
+
+struct IRBHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t section_num;
+    IRBSection sections[IRB_SECTION_NUM];
+};
+
+struct IRBString {
+    uint32_t offset;
+    uint32_t length;
+};
+
+// kind为BasicOperand::operand_type
+// REG: a = 寄存器编号; LABEL: a = label编号; IMMI32: a = 值; IMMF32: a = 位模式; IMMI64: a = 低32位, b = 高32位
+// GLOBAL: a = 名字的字符串下标
+struct IRBOperand {
+    uint32_t kind;
+    uint32_t a;
+    uint32_t b;
+};
+
+// 函数声明, 额外数据为参数类型
+struct IRBDeclare {
+    uint32_t name;
+    uint32_t ret_type;
+    uint32_t extra;
+    uint32_t n_extra;
+};
+
+// 全局变量, opcode目前只有GLOBAL_VAR(中间代码生成不会产生GLOBAL_STR), 预留以便之后支持其他全局定义
+// init为初值操作数, 额外数据为 维数, 各维大小, 整数初值的长度, 非0元素个数, (下标, 值)..., 浮点数初值同上
+struct IRBGlobal {
+    uint32_t opcode;
+    uint32_t type;
+    uint32_t attr_type;    // VarAttribute::type
+    uint32_t const_tag;
+    uint32_t name;
+    uint32_t init;
+    uint32_t extra;
+    uint32_t n_extra;
+};
+
+// 函数定义, 额外数据为 (参数类型, 参数寄存器操作数)...
+struct IRBFunction {
+    uint32_t name;
+    uint32_t ret_type;
+    uint32_t extra;
+    uint32_t n_extra;
+    int32_t max_reg;
+    uint32_t first_block;
+    uint32_t n_blocks;
+    uint32_t reserved;
+};
+
+struct IRBBlock {
+    int32_t id;
+    uint32_t comment;
+    uint32_t first_inst;
+    uint32_t n_insts;
+};
+
+/*
+    指令, result和op为操作数下标
+    LOAD: op0 = 地址; STORE: op0 = 地址, op1 = 值; 算术指令: op0, op1; ICMP/FCMP: op0, op1, aux = 条件
+    PHI: 额外数据为 (label, 值)...; ALLOCA: 额外数据为数组各维大小
+    BR_COND: op0 = 条件, op1 = 真分支label, op2 = 假分支label; BR_UNCOND: op0 = 目标label; RET: op0 = 返回值
+    CALL: type = 返回类型, op0 = 函数名的字符串下标, 额外数据为 (参数类型, 参数)...
+    GETELEMENTPTR: aux = 下标类型, op0 = 基地址, op1 = 维数, 额外数据为 各维大小, 各个下标
+    FPTOSI/SITOFP: op0 = 源操作数; ZEXT: type = 目标类型, aux = 源类型, op0 = 源操作数
+*/
+struct IRBInst {
+    uint8_t opcode;
+    uint8_t type;
+    uint8_t aux;
+    uint8_t reserved;
+    uint32_t result;
+    uint32_t op[3];
+    uint32_t extra;
+    uint32_t n_extra;
+};
+
+static_assert(std::is_trivially_copyable_v<IRBInst> && sizeof(IRBInst) == 28);
+static_assert(sizeof(IRBHeader) % 8 == 0);
+
+// 判断内存中的文件内容是否为二进制中间代码(以魔数开头), 截断的文件在LoadIRBinary中报告错误
+bool IsIRBinary(const char *data, size_t size);
+// 将IR写入path, 失败时输出错误信息并返回false
+bool SaveIRBinary(LLVMIR &IR, const char *path);
+// 从映射到内存的文件内容恢复IR(IR应当为空), 新建的指令分配在IR的arena中, 格式错误时将原因写入error并返回false
+bool LoadIRBinary(LLVMIR &IR, const char *data, size_t size, std::string &error);
+
+#endif
@@ -0,0 +1,19 @@
+#ifndef IR_PARSER_H
+#define IR_PARSER_H
+
+#include "ir.h"
+#include <cstddef>
+#include <string>
+
+/*
+    读取LLVMIR::printIR输出的文本形式的中间代码(.ll), 重建function_declare、global_def和function_block_map
+    只支持printIR输出的格式(每行一条声明/定义/指令, 操作数的写法与PrintIR一致), 不是通用的LLVM IR解析器
+    文本中没有保存函数使用的最大寄存器编号, 以文本中出现的最大寄存器编号作为def_reg
+*/
+
+// 判断path是否为文本中间代码文件(扩展名为.ll)
+bool IsIRTextFile(const char *path);
+// 解析data[0, size)中的中间代码, 新建的指令分配在IR的arena中, 出错时将行号和原因写入error并返回false
+bool ParseIRText(LLVMIR &IR, const char *data, size_t size, std::string &error);
+
+#endif
@@ -0,0 +1,161 @@
+#ifndef OUTPUT_BUFFER_H
+#define OUTPUT_BUFFER_H
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <sys/uio.h>
+#include <type_traits>
+#include <unistd.h>
+#include <vector>
+
+/*
+    输出缓冲区: 中间代码和汇编代码的规模与指令数成正比, 逐项通过std::ostream输出的开销很大
+    该缓冲区只做追加, 整数由手写的转换函数格式化, 不经过locale和格式状态
+    绑定文件描述符时, 缓冲区超过FLUSH_SIZE后通过write整块写出; 未绑定时只保存在内存中,
+    用于并行输出时每个函数各自的缓冲区, 最后通过WriteBuffers按顺序一次性写出
+*/
+class OutputBuffer {
+private:
+    static constexpr size_t FLUSH_SIZE = 1 << 20;
+
+    std::string buf;
+    int fd = -1;
+
+    static void WriteAll(int fd, const char *data, size_t len) {
+        while (len > 0) {
+            ssize_t n = ::write(fd, data, len);
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                perror("write");
+                return;
+            }
+            data += n;
+            len -= n;
+        }
+    }
+
+    void AppendUnsigned(unsigned long long v) {
+        char tmp[20];
+        char *p = tmp + sizeof(tmp);
+        do {
+            *--p = '0' + v % 10;
+            v /= 10;
+        } while (v != 0);
+        Append(p, tmp + sizeof(tmp) - p);
+    }
+
+public:
+    OutputBuffer() = default;
+    explicit OutputBuffer(int fd) : fd(fd) { buf.reserve(FLUSH_SIZE + FLUSH_SIZE / 4); }
+    OutputBuffer(OutputBuffer &&) = default;
+    OutputBuffer(const OutputBuffer &) = delete;
+    OutputBuffer &operator=(const OutputBuffer &) = delete;
+    ~OutputBuffer() { Flush(); }
+
+    void Append(const char *data, size_t len) {
+        buf.append(data, len);
+        if (fd >= 0 && buf.size() >= FLUSH_SIZE) {
+            Flush();
+        }
+    }
+
+    // 追加count个字符c
+    void Append(size_t count, char c) { buf.append(count, c); }
+
+    // 以小写十六进制输出(负数按补码输出), 与std::hex的格式一致
+    void AppendHex(unsigned long long v) {
+        char tmp[16];
+        char *p = tmp + sizeof(tmp);
+        do {
+            *--p = "0123456789abcdef"[v & 15];
+            v >>= 4;
+        } while (v != 0);
+        Append(p, tmp + sizeof(tmp) - p);
+    }
+
+    OutputBuffer &operator<<(char c) {
+        buf.push_back(c);
+        return *this;
+    }
+    OutputBuffer &operator<<(std::string_view str) {
+        Append(str.data(), str.size());
+        return *this;
+    }
+    OutputBuffer &operator<<(const char *str) { return *this << std::string_view(str); }
+    OutputBuffer &operator<<(const std::string &str) { return *this << std::string_view(str); }
+
+    template <class T>
+    requires(std::is_integral_v<T> && !std::is_same_v<T, char> && !std::is_same_v<T, bool>)
+    OutputBuffer &operator<<(T v) {
+        if constexpr (std::is_signed_v<T>) {
+            if (v < 0) {
+                buf.push_back('-');
+                // 先转为无符号数再取负, 避免最小值溢出
+                AppendUnsigned(0ULL - (unsigned long long)v);
+                return *this;
+            }
+        }
+        AppendUnsigned((unsigned long long)v);
+        return *this;
+    }
+
+    // 与std::ostream的默认格式(%g, 6位有效数字)保持一致
+    OutputBuffer &operator<<(double v) {
+        char tmp[32];
+        int len = snprintf(tmp, sizeof(tmp), "%g", v);
+        Append(tmp, len);
+        return *this;
+    }
+
+    // 将缓冲区中的内容写入文件描述符, 未绑定文件描述符时不做任何事
+    void Flush() {
+        if (fd >= 0 && !buf.empty()) {
+            WriteAll(fd, buf.data(), buf.size());
+            buf.clear();
+        }
+    }
+
+    // 先写出自身缓冲区的内容, 再按顺序写出bufs中各个内存缓冲区的内容(通过writev一次提交多块)
+    void WriteBuffers(const std::vector<OutputBuffer> &bufs) {
+        Flush();
+        std::vector<iovec> iov;
+        for (auto &b : bufs) {
+            if (!b.buf.empty()) {
+                iov.push_back({(void *)b.buf.data(), b.buf.size()});
+            }
+        }
+        size_t i = 0;
+        while (i < iov.size()) {
+            int cnt = (int)std::min<size_t>(iov.size() - i, IOV_MAX);
+            ssize_t n = ::writev(fd, &iov[i], cnt);
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                perror("writev");
+                return;
+            }
+            // 处理部分写出: 跳过已经完整写出的块, 调整第一个未写完的块
+            while (i < iov.size() && n >= (ssize_t)iov[i].iov_len) {
+                n -= iov[i].iov_len;
+                i++;
+            }
+            if (n > 0) {
+                iov[i].iov_base = (char *)iov[i].iov_base + n;
+                iov[i].iov_len -= n;
+            }
+        }
+    }
+
+    std::string_view View() const { return buf; }
+    size_t size() const { return buf.size(); }
+};
+
+#endif
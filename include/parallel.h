@@ -0,0 +1,129 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+    并行循环: 用jobs个线程(包括调用者所在的线程)执行body(i, worker), i取遍[0, n)
+    各线程通过原子计数器依次领取下一个下标, 因此各任务耗时差别很大时(例如函数大小悬殊)也能较好地均摊
+    worker为执行该任务的线程编号(0 <= worker < jobs), 可以用来索引每个线程私有的状态
+    body之间不能有依赖, 需要有序的结果时应写入以i为下标的位置, 由调用者在返回后按顺序处理
+*/
+template <class Body> void ParallelFor(int jobs, size_t n, Body body) {
+    if (jobs > (int)n) {
+        jobs = n;
+    }
+    if (jobs <= 1) {
+        for (size_t i = 0; i < n; i++) {
+            body(i, 0);
+        }
+        return;
+    }
+    std::atomic<size_t> next{0};
+    auto run = [&](int worker) {
+        for (size_t i = next++; i < n; i = next++) {
+            body(i, worker);
+        }
+    };
+    std::vector<std::thread> threads;
+    for (int worker = 1; worker < jobs; worker++) {
+        threads.emplace_back(run, worker);
+    }
+    run(0);
+    for (auto &t : threads) {
+        t.join();
+    }
+}
+
+/*
+    工作窃取执行器: 任务下标按连续的区间预先分给各线程自己的双端队列
+    线程从自己队列的头部取任务, 自己的队列为空时从其他线程队列的尾部窃取, 所有队列都为空时结束
+    大部分时间各线程只访问自己的队列, 相邻的任务(例如相邻的函数)也更可能由同一线程连续执行
+    任务执行过程中不会产生新的任务, 因此不需要额外的结束检测
+*/
+class WorkStealingExecutor {
+private:
+    struct WorkQueue {
+        std::mutex mtx;
+        std::deque<size_t> tasks;
+    };
+    int jobs;
+
+public:
+    WorkStealingExecutor(int jobs) : jobs(jobs > 0 ? jobs : 1) {}
+
+    // 执行body(i, worker), i取遍[0, n), worker为线程编号(0 <= worker < jobs)
+    template <class Body> void Run(size_t n, Body body) {
+        int threads_num = jobs > (int)n ? (int)n : jobs;
+        if (threads_num <= 1) {
+            for (size_t i = 0; i < n; i++) {
+                body(i, 0);
+            }
+            return;
+        }
+        std::vector<std::unique_ptr<WorkQueue>> queues;
+        for (int w = 0; w < threads_num; w++) {
+            queues.push_back(std::make_unique<WorkQueue>());
+            for (size_t i = n * w / threads_num; i < n * (w + 1) / threads_num; i++) {
+                queues[w]->tasks.push_back(i);
+            }
+        }
+        auto take = [&](int w, bool front, size_t &task) {
+            std::lock_guard<std::mutex> lock(queues[w]->mtx);
+            auto &tasks = queues[w]->tasks;
+            if (tasks.empty()) {
+                return false;
+            }
+            if (front) {
+                task = tasks.front();
+                tasks.pop_front();
+            } else {
+                task = tasks.back();
+                tasks.pop_back();
+            }
+            return true;
+        };
+        auto run = [&](int worker) {
+            size_t task;
+            while (true) {
+                if (take(worker, true, task)) {
+                    body(task, worker);
+                    continue;
+                }
+                bool stolen = false;
+                for (int k = 1; k < threads_num && !stolen; k++) {
+                    stolen = take((worker + k) % threads_num, false, task);
+                }
+                if (!stolen) {
+                    return;
+                }
+                body(task, worker);
+            }
+        };
+        std::vector<std::thread> threads;
+        for (int worker = 1; worker < threads_num; worker++) {
+            threads.emplace_back(run, worker);
+        }
+        run(0);
+        for (auto &t : threads) {
+            t.join();
+        }
+    }
+};
+
+// -j 0 表示使用所有处理器核心
+inline int ResolveJobs(int jobs) {
+    if (jobs > 0) {
+        return jobs;
+    }
+    int cores = std::thread::hardware_concurrency();
+    return cores > 0 ? cores : 1;
+}
+
+#endif
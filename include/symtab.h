@@ -5,6 +5,9 @@
 #include <map>
 #include <stack>
 #include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 /*词法分析阶段需要阅读的代码*/
@@ -15,32 +18,82 @@ private:
 public:
     Entry(std::string s) { name = s; }
     std::string get_string() { return name; }
+    std::string_view get_view() { return name; }
 };
 typedef Entry *Symbol;
 
 /* 相同的字符串均使用同一个Symbol指向，我们可以直接使用Symbol的 == 来判断标识符是否相等
    必须使用add_id函数来添加新的Symbol
    作用域问题在词法分析和语法分析阶段不需要考虑，在semant阶段我们会进行处理
+   表的key指向Symbol自身保存的字符串, 查找时直接使用词法分析器给出的string_view, 只有新的标识符才需要拷贝
 */
 class IdTable {
 private:
-    std::map<std::string, Symbol> id_table{};
+    std::unordered_map<std::string_view, Symbol> id_table{};
 
 public:
-    Symbol add_id(std::string s);
+    Symbol add_id(std::string_view s);
 };
 
-/*语义分析和类型检查阶段需要阅读的代码*/
-class SymbolTable {
+/*
+    带作用域的符号表: 每个Symbol对应一个栈, 保存该Symbol在各层作用域中的定义, 栈顶即离当前作用域最近的定义
+    查找只需要一次哈希, 不需要从内层作用域开始逐层查找
+    每层作用域记录在其中定义的Symbol, 退出作用域时将这些Symbol的栈顶弹出
+*/
+template <class T> class ScopedTable {
 private:
-    // 当前作用域
     int current_scope = -1;
-
-    std::vector<std::map<Symbol, VarAttribute>> symbol_table;
+    // key: Symbol, value: (作用域, 定义)组成的栈
+    std::unordered_map<Symbol, std::vector<std::pair<int, T>>> bindings;
+    // 每层作用域中定义的Symbol
+    std::vector<std::vector<Symbol>> scope_symbols;
 
 public:
     int get_current_scope() { return current_scope; }
 
+    // 在当前作用域中定义C, 如果当前作用域中已经定义过C则覆盖
+    void insert(Symbol C, T val) {
+        auto &stack = bindings[C];
+        if (!stack.empty() && stack.back().first == current_scope) {
+            stack.back().second = std::move(val);
+            return;
+        }
+        stack.emplace_back(current_scope, std::move(val));
+        scope_symbols[current_scope].push_back(C);
+    }
+
+    // 返回离当前作用域最近的C的(作用域, 定义), 不存在时返回nullptr
+    // 返回的指针在该定义所在的作用域退出或者C被再次定义之前有效
+    std::pair<int, T> *find(Symbol C) {
+        auto it = bindings.find(C);
+        if (it == bindings.end() || it->second.empty()) {
+            return nullptr;
+        }
+        return &it->second.back();
+    }
+
+    void enter_scope() {
+        ++current_scope;
+        scope_symbols.emplace_back();
+    }
+
+    void exit_scope() {
+        for (auto C : scope_symbols.back()) {
+            bindings.find(C)->second.pop_back();
+        }
+        scope_symbols.pop_back();
+        --current_scope;
+    }
+};
+
+/*语义分析和类型检查阶段需要阅读的代码*/
+class SymbolTable {
+private:
+    ScopedTable<VarAttribute> symbol_table;
+
+public:
+    int get_current_scope() { return symbol_table.get_current_scope(); }
+
     // 在当前作用域插入一条局部变量信息
     void add_Symbol(Symbol C, VarAttribute val);
 
@@ -48,8 +101,9 @@ public:
     Type::ty lookup_type(Symbol C);
     // 返回离当前作用域最近的局部变量的作用域
     int lookup_scope(Symbol C);
-    // 返回离当前作用域最近的局部变量的相关信息
-    VarAttribute lookup_val(Symbol C);
+    // 返回离当前作用域最近的局部变量的相关信息, 不存在时返回空的VarAttribute
+    // 返回的是符号表中的引用, 不会拷贝数组的维度和初始值
+    const VarAttribute &lookup_val(Symbol C);
     // 进入新的作用域
     void enter_scope();
     // 退出当前作用域, 返回到上一层作用域
@@ -80,8 +134,7 @@ public:
 */
 class SymbolRegTable {
 private:
-    int current_scope = -1;
-    std::vector<std::map<Symbol, int>> symbol_table;
+    ScopedTable<int> symbol_table;
 
 public:
     void add_Symbol(Symbol C, int reg);
@@ -0,0 +1,241 @@
+#ifndef TIME_REPORT_H
+#define TIME_REPORT_H
+
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+#include <fcntl.h>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <sys/resource.h>
+#include <unistd.h>
+#include <vector>
+
+/*
+    编译时间报告(-time-report): 记录每个阶段以及阶段内每个函数的墙钟时间、CPU时间和常驻内存(RSS)的变化
+    阶段由main中顺序执行的Scope划分; 函数级的记录由各个pass遍历函数的位置通过FunctionScope添加,
+    归属于当前所在的阶段(也可以显式指定阶段名, 用于后端按函数并行时一个函数依次经过多个阶段的情况)
+    未开启时所有Scope只做一次判断, 不读取时钟
+    阶段的CPU时间是整个进程(所有线程)的CPU时间, 函数的CPU时间是执行该函数的线程的CPU时间
+    RSS是整个进程的, 因此并行时函数级的RSS变化会包含同时在处理的其他函数, 只能作为参考
+*/
+class TimeReport {
+public:
+    struct Entry {
+        std::string stage;
+        std::string func;    // 为空表示阶段本身
+        double wall = 0;
+        double cpu = 0;
+        long rss_delta_kb = 0;
+        long peak_rss_kb = 0;
+    };
+
+private:
+    struct Sample {
+        double wall;
+        double cpu;
+        long rss_kb;
+    };
+
+    bool enabled = false;
+    std::string json_path{};    // 为空时以文本形式输出到stderr
+    std::string cur_stage{};
+    std::vector<Entry> stages{};
+    std::vector<Entry> funcs{};
+    std::mutex mtx;
+
+    static double Clock(clockid_t id) {
+        timespec ts;
+        clock_gettime(id, &ts);
+        return ts.tv_sec + ts.tv_nsec * 1e-9;
+    }
+    // 函数级的记录很多, 保持/proc/self/statm打开, 每次只需要一次pread
+    static long CurrentRSS() {
+        static int fd = open("/proc/self/statm", O_RDONLY);
+        char buf[128];
+        ssize_t len = fd < 0 ? -1 : pread(fd, buf, sizeof(buf) - 1, 0);
+        if (len <= 0) {
+            return 0;
+        }
+        buf[len] = '\0';
+        long pages = 0, resident = 0;
+        sscanf(buf, "%ld %ld", &pages, &resident);
+        return resident * (sysconf(_SC_PAGESIZE) / 1024);
+    }
+    // 优先使用/proc/self/status中的VmHWM: ru_maxrss在exec后会保留父进程(例如启动编译器的python脚本)的峰值,
+    // 而VmHWM只统计当前的地址空间
+    static long PeakRSS() {
+        long peak = -1;
+        FILE *f = fopen("/proc/self/status", "r");
+        if (f != nullptr) {
+            char line[256];
+            while (fgets(line, sizeof(line), f) != nullptr) {
+                if (sscanf(line, "VmHWM: %ld", &peak) == 1) {
+                    break;
+                }
+            }
+            fclose(f);
+        }
+        if (peak < 0) {
+            rusage usage;
+            getrusage(RUSAGE_SELF, &usage);
+            peak = usage.ru_maxrss;
+        }
+        return peak;
+    }
+    static Sample Now(clockid_t cpu_clock) { return {Clock(CLOCK_MONOTONIC), Clock(cpu_clock), CurrentRSS()}; }
+
+    static void PrintJsonString(FILE *f, std::string_view str) {
+        fputc('"', f);
+        for (char c : str) {
+            if (c == '"' || c == '\\') {
+                fputc('\\', f);
+            }
+            fputc(c, f);
+        }
+        fputc('"', f);
+    }
+    static void PrintJsonEntry(FILE *f, const Entry &e, bool with_func) {
+        fputs("{\"stage\":", f);
+        PrintJsonString(f, e.stage);
+        if (with_func) {
+            fputs(",\"function\":", f);
+            PrintJsonString(f, e.func);
+        }
+        fprintf(f, ",\"wall\":%.6f,\"cpu\":%.6f,\"rss_delta_kb\":%ld", e.wall, e.cpu, e.rss_delta_kb);
+        if (!with_func) {
+            fprintf(f, ",\"peak_rss_kb\":%ld", e.peak_rss_kb);
+        }
+        fputc('}', f);
+    }
+
+    void PrintText(FILE *f) {
+        Entry total;
+        total.stage = "total";
+        fprintf(f, "===== Time report =====\n");
+        fprintf(f, "%-24s %12s %12s %16s %14s\n", "stage", "wall(s)", "cpu(s)", "rss delta(KB)", "peak rss(KB)");
+        for (auto &e : stages) {
+            fprintf(f, "%-24s %12.6f %12.6f %16ld %14ld\n", e.stage.c_str(), e.wall, e.cpu, e.rss_delta_kb,
+                    e.peak_rss_kb);
+            total.wall += e.wall;
+            total.cpu += e.cpu;
+            total.rss_delta_kb += e.rss_delta_kb;
+        }
+        fprintf(f, "%-24s %12.6f %12.6f %16ld %14ld\n", "total", total.wall, total.cpu, total.rss_delta_kb,
+                PeakRSS());
+
+        // 函数可能很多, 文本形式只输出耗时最长的若干项, 完整的结果可以通过JSON输出
+        const size_t TOP = 20;
+        auto sorted = funcs;
+        std::stable_sort(sorted.begin(), sorted.end(), [](const Entry &a, const Entry &b) { return a.wall > b.wall; });
+        if (sorted.size() > TOP) {
+            sorted.resize(TOP);
+        }
+        if (!sorted.empty()) {
+            fprintf(f, "----- slowest functions (%zu of %zu) -----\n", sorted.size(), funcs.size());
+            fprintf(f, "%-24s %-24s %12s %12s %16s\n", "stage", "function", "wall(s)", "cpu(s)", "rss delta(KB)");
+        }
+        for (auto &e : sorted) {
+            fprintf(f, "%-24s %-24s %12.6f %12.6f %16ld\n", e.stage.c_str(), e.func.c_str(), e.wall, e.cpu,
+                    e.rss_delta_kb);
+        }
+    }
+
+    void PrintJson(FILE *f) {
+        fputs("{\"stages\":[", f);
+        for (size_t i = 0; i < stages.size(); i++) {
+            fputs(i == 0 ? "\n  " : ",\n  ", f);
+            PrintJsonEntry(f, stages[i], false);
+        }
+        fputs("\n],\"functions\":[", f);
+        for (size_t i = 0; i < funcs.size(); i++) {
+            fputs(i == 0 ? "\n  " : ",\n  ", f);
+            PrintJsonEntry(f, funcs[i], true);
+        }
+        fprintf(f, "\n],\"peak_rss_kb\":%ld}\n", PeakRSS());
+    }
+
+public:
+    // 记录一个阶段, 阶段之间不能嵌套, 只能在主线程中使用
+    class Scope {
+    private:
+        TimeReport &report;
+        Sample start{};
+
+    public:
+        Scope(TimeReport &report, std::string_view stage) : report(report) {
+            if (report.enabled) {
+                report.cur_stage = stage;
+                start = Now(CLOCK_PROCESS_CPUTIME_ID);
+            }
+        }
+        ~Scope() {
+            if (report.enabled) {
+                Sample end = Now(CLOCK_PROCESS_CPUTIME_ID);
+                report.stages.push_back({report.cur_stage, "", end.wall - start.wall, end.cpu - start.cpu,
+                                         end.rss_kb - start.rss_kb, PeakRSS()});
+                report.cur_stage.clear();
+            }
+        }
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+    };
+
+    // 记录一个函数在某个阶段的耗时, 可以在多个线程中同时使用
+    class FunctionScope {
+    private:
+        TimeReport &report;
+        std::string stage;
+        std::string func;
+        Sample start{};
+
+    public:
+        FunctionScope(TimeReport &report, std::string_view func) : FunctionScope(report, "", func) {}
+        FunctionScope(TimeReport &report, std::string_view stage, std::string_view func) : report(report) {
+            if (report.enabled) {
+                this->stage = stage.empty() ? report.cur_stage : std::string(stage);
+                this->func = func;
+                start = Now(CLOCK_THREAD_CPUTIME_ID);
+            }
+        }
+        ~FunctionScope() {
+            if (report.enabled) {
+                Sample end = Now(CLOCK_THREAD_CPUTIME_ID);
+                std::lock_guard<std::mutex> lock(report.mtx);
+                report.funcs.push_back(
+                {stage, func, end.wall - start.wall, end.cpu - start.cpu, end.rss_kb - start.rss_kb, 0});
+            }
+        }
+        FunctionScope(const FunctionScope &) = delete;
+        FunctionScope &operator=(const FunctionScope &) = delete;
+    };
+
+    // json_path为空时输出到stderr, 否则以JSON格式写入该文件
+    void Enable(std::string_view json_path) {
+        enabled = true;
+        this->json_path = json_path;
+    }
+    bool IsEnabled() const { return enabled; }
+
+    void Print() {
+        if (!enabled) {
+            return;
+        }
+        if (json_path.empty()) {
+            PrintText(stderr);
+            return;
+        }
+        FILE *f = fopen(json_path.c_str(), "w");
+        if (f == nullptr) {
+            perror(json_path.c_str());
+            return;
+        }
+        PrintJson(f);
+        fclose(f);
+    }
+};
+
+extern TimeReport time_report;
+
+#endif
@@ -1,8 +1,11 @@
 #ifndef TYPE_H
 #define TYPE_H
 
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 #include <string>
+#include <utility>
 #include <vector>
 
 class Type {
@@ -29,6 +32,67 @@ public:
     }
 };
 
+/*
+    数组初始值的稀疏表示: 逻辑上是长度为size()的数组, 只按下标递增的顺序保存非0元素(下标, 值), 其余元素均为0
+    大部分元素为0的大数组不再占用与数组大小成正比的内存, 输出时连续的0可以直接输出为.zero或zeroinitializer
+    浮点数按位模式判断是否为0, 因此-0.0会被保存
+*/
+template <class T> class SparseArray {
+private:
+    size_t n = 0;
+    std::vector<std::pair<size_t, T>> elems{};
+
+    static bool IsZero(const T &val) {
+        T zero{};
+        return std::memcmp(&val, &zero, sizeof(T)) == 0;
+    }
+    auto LowerBound(size_t i) const {
+        return std::lower_bound(elems.begin(), elems.end(), i, [](const auto &e, size_t i) { return e.first < i; });
+    }
+
+public:
+    SparseArray() = default;
+    explicit SparseArray(size_t n) : n(n) {}
+
+    size_t size() const { return n; }
+    bool empty() const { return n == 0; }
+    // 修改数组长度, 新增的元素为0
+    void resize(size_t new_n) {
+        n = new_n;
+        elems.erase(LowerBound(n), elems.end());
+    }
+    void push_back(T val) { set(n++, val); }
+
+    T operator[](size_t i) const {
+        if (elems.empty() || i > elems.back().first) {
+            return T{};
+        }
+        auto it = LowerBound(i);
+        return it != elems.end() && it->first == i ? it->second : T{};
+    }
+    // 按下标递增的顺序赋值时为O(1)
+    void set(size_t i, T val) {
+        size_t pos = elems.empty() || i > elems.back().first ? elems.size() : LowerBound(i) - elems.begin();
+        if (pos < elems.size() && elems[pos].first == i) {
+            if (IsZero(val)) {
+                elems.erase(elems.begin() + pos);
+            } else {
+                elems[pos].second = val;
+            }
+        } else if (!IsZero(val)) {
+            elems.insert(elems.begin() + pos, {i, val});
+        }
+    }
+
+    // 下标在[begin, end)中的元素是否全为0
+    bool AllZero(size_t begin, size_t end) const {
+        auto it = LowerBound(begin);
+        return it == elems.end() || it->first >= end;
+    }
+    // 所有非0元素(下标, 值), 按下标递增
+    const std::vector<std::pair<size_t, T>> &NonZeros() const { return elems; }
+};
+
 // 变量的属性
 class VarAttribute {
 public:
@@ -36,8 +100,8 @@ public:
     bool ConstTag = 0;
     std::vector<int> dims{};    // 存储数组类型的相关信息
     // 对于数组的初始化值，我们将高维数组看作一维后再存储 eg.([3 x [4 x i32]] => [12 x i32])
-    std::vector<int> IntInitVals{};
-    std::vector<float> FloatInitVals{};
+    SparseArray<int> IntInitVals{};
+    SparseArray<float> FloatInitVals{};
 
     // TODO():也许你需要添加更多变量
     VarAttribute() {
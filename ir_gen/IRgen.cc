@@ -1,8 +1,10 @@
 #include "IRgen.h"
 #include "../include/cfg.h"
 #include "../include/ir.h"
+#include "../include/time_report.h"
 #include "semant.h"
 #include <cassert>
+#include <cmath>
 #include <cstddef>
 #include <cstring>
 #include <unordered_map>
@@ -140,13 +142,22 @@ void IRgenTypeConverse(LLVMBlock B, Type::ty type_src, Type::ty type_dst, int sr
             IRgenZextI1toI32(B, src, NewReg());
         } else if (type_dst == Type::FLOAT) {
             IRgenZextI1toI32(B, src, NewReg());
-            IRgenSitofp(B, cur_reg, NewReg());
+            int int_reg = cur_reg;
+            IRgenSitofp(B, int_reg, NewReg());
         }
     } else {
         cur_reg--;
     }
 }
 
+// 将cur_reg中的值转换为type_dst, 转换结果仍在cur_reg中
+// 函数实参的求值顺序是未指定的, 不能写成IRgenTypeConverse(B, ..., cur_reg, NewReg()),
+// 否则g++会先调用NewReg()再读取cur_reg, 把尚未定义的寄存器当作转换的源
+void IRgenTypeConverse(LLVMBlock B, Type::ty type_src, Type::ty type_dst) {
+    int src = cur_reg;
+    IRgenTypeConverse(B, type_src, type_dst, src, NewReg());
+}
+
 void BasicBlock::InsertInstruction(int pos, Instruction Ins) {
     assert(pos == 0 || pos == 1);
     if (pos == 0) {
@@ -171,6 +182,7 @@ void BasicBlock::InsertInstruction(int pos, Instruction Ins) {
 */
 
 void __Program::codeIR() {
+    ir_arena = &llvmIR.global_arena;
     AddLibFunctionDeclare();
     auto comp_vector = *comp_list;
     for (auto comp : comp_vector) {
@@ -746,7 +758,7 @@ void LAndExp_and::codeIR() {
     landexp->codeIR();
 
     auto leftBB = (*cur_cfg.block_map)[cur_cfg.func_cur_label];
-    IRgenTypeConverse(leftBB, landexp->attribute.T.type, Type::ty::BOOL, cur_reg, NewReg());
+    IRgenTypeConverse(leftBB, landexp->attribute.T.type, Type::ty::BOOL);
     IRgenBrCond(leftBB, cur_reg, landexp->true_label, landexp->false_label);
 
     // 只有当左表达式为真时, 才执行右表达式
@@ -757,7 +769,7 @@ void LAndExp_and::codeIR() {
     eqexp->false_label = false_label;
     cur_cfg.func_cur_label = landexp->true_label;
     eqexp->codeIR();
-    IRgenTypeConverse(rightBB, eqexp->attribute.T.type, Type::ty::BOOL, cur_reg, NewReg());
+    IRgenTypeConverse(rightBB, eqexp->attribute.T.type, Type::ty::BOOL);
 }
 
 // short circuit ||
@@ -782,7 +794,7 @@ void LOrExp_or::codeIR() {
     lorexp->codeIR();
 
     auto leftBB = (*cur_cfg.block_map)[cur_cfg.func_cur_label];
-    IRgenTypeConverse(leftBB, lorexp->attribute.T.type, Type::ty::BOOL, cur_reg, NewReg());
+    IRgenTypeConverse(leftBB, lorexp->attribute.T.type, Type::ty::BOOL);
     IRgenBrCond(leftBB, cur_reg, lorexp->true_label, lorexp->false_label);
 
     // 只有当左表达式为假时, 才执行右表达式
@@ -793,7 +805,7 @@ void LOrExp_or::codeIR() {
     landexp->false_label = false_label;
     cur_cfg.func_cur_label = lorexp->false_label;
     landexp->codeIR();
-    IRgenTypeConverse(rightBB, landexp->attribute.T.type, Type::ty::BOOL, cur_reg, NewReg());
+    IRgenTypeConverse(rightBB, landexp->attribute.T.type, Type::ty::BOOL);
 }
 
 void ConstExp::codeIR() { addexp->codeIR(); }
@@ -803,17 +815,20 @@ void Lval::codeIR() {
 
     auto bb = (*cur_cfg.block_map)[cur_cfg.func_cur_label];
 
-    VarAttribute def_var;
+    // 只需要读取变量的类型和维度, 使用引用避免拷贝全局数组的初始值
+    static const VarAttribute undefined_var;
+    const VarAttribute *def_var_ptr = &undefined_var;
     bool isGlobal = false;
     int alloca_reg = irgen_table.symbol_table.lookup(name);
     if (alloca_reg != -1) {
         // 局部变量
-        def_var = irgen_table.reg_table[alloca_reg];
+        def_var_ptr = &irgen_table.reg_table[alloca_reg];
     } else if (semant_table.GlobalTable.find(name) != semant_table.GlobalTable.end()) {
         // 全局变量
         isGlobal = true;
-        def_var = semant_table.GlobalVarTable[name];
+        def_var_ptr = &semant_table.GlobalVarTable[name];
     }
+    const VarAttribute &def_var = *def_var_ptr;
     std::vector<Expression> dim_vector;
     std::vector<Operand> lval_dims;
     if (dims) {
@@ -821,7 +836,7 @@ void Lval::codeIR() {
     }
     for (auto d : dim_vector) {
         d->codeIR();
-        IRgenTypeConverse(bb, d->attribute.T.type, Type::ty::INT, cur_reg, NewReg());
+        IRgenTypeConverse(bb, d->attribute.T.type, Type::ty::INT);
         lval_dims.push_back(GetNewRegOperand(cur_reg));
     }
     if (def_var.dims.size() > lval_dims.size()) {
@@ -833,7 +848,7 @@ void Lval::codeIR() {
         } else {
             op = GetNewRegOperand(alloca_reg);
         }
-        lval_dims.insert(lval_dims.begin(), new ImmI32Operand(0));
+        lval_dims.insert(lval_dims.begin(), GetNewImmI32Operand(0));
         IRgenGetElementptrIndexI32(bb, getLLVMType[def_var.type], NewReg(), op, def_var.dims, lval_dims);
 
     } else if (def_var.dims.size() == lval_dims.size()) {
@@ -851,7 +866,7 @@ void Lval::codeIR() {
                 IRgenLoad(bb, getLLVMType[def_var.type], NewReg(), op);
             } else {
                 IRgenGetElementptrIndexI32(bb, getLLVMType[def_var.type], NewReg(), op, def_var.dims,
-                                           {new ImmI32Operand(0)});
+                                           {GetNewImmI32Operand(0)});
             }
         } else {
             // 定义的值是数组
@@ -861,7 +876,7 @@ void Lval::codeIR() {
             } else {
                 op = GetNewRegOperand(alloca_reg);
             }
-            lval_dims.insert(lval_dims.begin(), new ImmI32Operand(0));
+            lval_dims.insert(lval_dims.begin(), GetNewImmI32Operand(0));
             IRgenGetElementptrIndexI32(bb, getLLVMType[def_var.type], NewReg(), op, def_var.dims, lval_dims);
 
             op = GetNewRegOperand(cur_reg);
@@ -898,7 +913,7 @@ void Func_call::codeIR() {
             auto formal = (*formals)[i];
             auto real = (*reals)[i];
             real->codeIR();
-            IRgenTypeConverse(bb, real->attribute.T.type, formal->type_decl, cur_reg, NewReg());
+            IRgenTypeConverse(bb, real->attribute.T.type, formal->type_decl);
             if (real->attribute.T.type == Type::PTR) {
                 args.push_back(std::make_pair(getLLVMType[Type::PTR], GetNewRegOperand(cur_reg)));
             } else {
@@ -927,14 +942,16 @@ void UnaryExp_neg::codeIR() {
 
     auto bb = (*cur_cfg.block_map)[cur_cfg.func_cur_label];
     unary_exp->codeIR();
+    int val_reg = cur_reg;
     if (unary_exp->attribute.T.type == Type::INT) {
         // res_reg = 0 - cur_reg;
-        IRgenArithmeticI32ImmLeft(bb, BasicInstruction::LLVMIROpcode::SUB, 0, cur_reg, NewReg());
+        IRgenArithmeticI32ImmLeft(bb, BasicInstruction::LLVMIROpcode::SUB, 0, val_reg, NewReg());
     } else if (unary_exp->attribute.T.type == Type::FLOAT) {
-        IRgenArithmeticF32ImmLeft(bb, BasicInstruction::LLVMIROpcode::FSUB, 0, cur_reg, NewReg());
+        IRgenArithmeticF32ImmLeft(bb, BasicInstruction::LLVMIROpcode::FSUB, 0, val_reg, NewReg());
     } else {
-        IRgenZextI1toI32(bb, cur_reg, NewReg());
-        IRgenArithmeticI32ImmLeft(bb, BasicInstruction::LLVMIROpcode::SUB, 0, cur_reg, NewReg());
+        IRgenZextI1toI32(bb, val_reg, NewReg());
+        int int_reg = cur_reg;
+        IRgenArithmeticI32ImmLeft(bb, BasicInstruction::LLVMIROpcode::SUB, 0, int_reg, NewReg());
     }
 }
 
@@ -943,14 +960,16 @@ void UnaryExp_not::codeIR() {
 
     auto bb = (*cur_cfg.block_map)[cur_cfg.func_cur_label];
     unary_exp->codeIR();
+    int val_reg = cur_reg;
     if (unary_exp->attribute.T.type == Type::INT) {
         // res_reg = 0 == cur_reg;
-        IRgenIcmpImmRight(bb, BasicInstruction::IcmpCond::eq, cur_reg, 0, NewReg());
+        IRgenIcmpImmRight(bb, BasicInstruction::IcmpCond::eq, val_reg, 0, NewReg());
     } else if (unary_exp->attribute.T.type == Type::FLOAT) {
-        IRgenFcmpImmRight(bb, BasicInstruction::FcmpCond::OEQ, cur_reg, 0, NewReg());
+        IRgenFcmpImmRight(bb, BasicInstruction::FcmpCond::OEQ, val_reg, 0, NewReg());
     } else {
-        IRgenZextI1toI32(bb, cur_reg, NewReg());
-        IRgenIcmpImmRight(bb, BasicInstruction::IcmpCond::eq, cur_reg, 0, NewReg());
+        IRgenZextI1toI32(bb, val_reg, NewReg());
+        int int_reg = cur_reg;
+        IRgenIcmpImmRight(bb, BasicInstruction::IcmpCond::eq, int_reg, 0, NewReg());
     }
 }
 
@@ -986,7 +1005,7 @@ void assign_stmt::codeIR() {
     auto l_reg = irgen_table.symbol_table.lookup(l_exp->name);
     exp->codeIR();
 
-    IRgenTypeConverse(bb, exp->attribute.T.type, lval->attribute.T.type, cur_reg, NewReg());
+    IRgenTypeConverse(bb, exp->attribute.T.type, lval->attribute.T.type);
     if (l_reg == -1) {
         // 全局变量
         int tmp = cur_reg;
@@ -997,12 +1016,12 @@ void assign_stmt::codeIR() {
             // 需要访问全局数组变量中的元素
             for (auto d : *l_exp->dims) {
                 d->codeIR();
-                IRgenTypeConverse(bb, d->attribute.T.type, Type::ty::INT, cur_reg, NewReg());
+                IRgenTypeConverse(bb, d->attribute.T.type, Type::ty::INT);
                 l_dims.push_back(GetNewRegOperand(cur_reg));
             }
             // op = 全局变量数组首地址
             op = GetNewGlobalOperand(l_exp->name->get_string());
-            l_dims.insert(l_dims.begin(), new ImmI32Operand(0));
+            l_dims.insert(l_dims.begin(), GetNewImmI32Operand(0));
             IRgenGetElementptrIndexI32(bb, getLLVMType[def_var.type], NewReg(), op, def_var.dims, l_dims);
             // op = 全局变量数组中元素的地址
             op = GetNewRegOperand(cur_reg);
@@ -1016,17 +1035,17 @@ void assign_stmt::codeIR() {
         std::vector<Operand> l_dims;
         if (l_exp->dims != nullptr) {
             // 是一个数组
-            auto def_var = irgen_table.reg_table[l_reg];    // 找到局部变量数组的变量属性
+            auto &def_var = irgen_table.reg_table[l_reg];    // 找到局部变量数组的变量属性
             if (l_exp->dims->size() <= def_var.dims.size()) {
                 // 需要访问局部变量数组变量中的元素
                 for (auto d : *l_exp->dims) {
                     d->codeIR();
-                    IRgenTypeConverse(bb, d->attribute.T.type, Type::ty::INT, cur_reg, NewReg());
+                    IRgenTypeConverse(bb, d->attribute.T.type, Type::ty::INT);
                     l_dims.push_back(GetNewRegOperand(cur_reg));
                 }
                 // op = 局部变量数组首地址
                 op = GetNewRegOperand(l_reg);
-                l_dims.insert(l_dims.begin(), new ImmI32Operand(0));
+                l_dims.insert(l_dims.begin(), GetNewImmI32Operand(0));
                 IRgenGetElementptrIndexI32(bb, getLLVMType[def_var.type], NewReg(), op, def_var.dims, l_dims);
                 // op = 局部变量数组中元素的地址
                 op = GetNewRegOperand(cur_reg);
@@ -1034,7 +1053,7 @@ void assign_stmt::codeIR() {
                 // 需要访问局部变量数组变量中的元素
                 for (auto d : *l_exp->dims) {
                     d->codeIR();
-                    IRgenTypeConverse(bb, d->attribute.T.type, Type::ty::INT, cur_reg, NewReg());
+                    IRgenTypeConverse(bb, d->attribute.T.type, Type::ty::INT);
                     l_dims.push_back(GetNewRegOperand(cur_reg));
                 }
                 // op = 局部变量数组首地址
@@ -1086,7 +1105,7 @@ void ifelse_stmt::codeIR() {
 
     // 获取 Cond 生成的基本块
     auto condBB = (*cur_cfg.block_map)[cur_cfg.func_cur_label];
-    IRgenTypeConverse(condBB, Cond->attribute.T.type, Type::ty::BOOL, cur_reg, NewReg());
+    IRgenTypeConverse(condBB, Cond->attribute.T.type, Type::ty::BOOL);
     IRgenBrCond(condBB, cur_reg, Cond->true_label, Cond->false_label);
 
     cur_cfg.func_cur_label = Cond->true_label;
@@ -1128,7 +1147,7 @@ void if_stmt::codeIR() {
     // 获取 Cond 生成的基本块
     auto condBB = (*cur_cfg.block_map)[cur_cfg.func_cur_label];
     // std::cout << cond_label << "\n";
-    IRgenTypeConverse(condBB, Cond->attribute.T.type, Type::ty::BOOL, cur_reg, NewReg());
+    IRgenTypeConverse(condBB, Cond->attribute.T.type, Type::ty::BOOL);
     IRgenBrCond(condBB, cur_reg, Cond->true_label, Cond->false_label);
 
     cur_cfg.func_cur_label = Cond->true_label;
@@ -1185,7 +1204,7 @@ void while_stmt::codeIR() {
 
     auto B1 = (*cur_cfg.block_map)[cur_cfg.func_cur_label];
     if (Cond->attribute.T.type != Type::ty::BOOL) {
-        IRgenTypeConverse(B1, Cond->attribute.T.type, Type::ty::BOOL, cur_reg, NewReg());
+        IRgenTypeConverse(B1, Cond->attribute.T.type, Type::ty::BOOL);
         IRgenBrCond(B1, cur_reg, Cond->true_label, Cond->false_label);
     } else {
         IRgenBrCond(B1, cur_reg, Cond->true_label, Cond->false_label);
@@ -1225,8 +1244,7 @@ void return_stmt::codeIR() {
     auto bb = (*cur_cfg.block_map)[cur_cfg.func_cur_label];
     return_exp->codeIR();
 
-    IRgenTypeConverse(bb, return_exp->attribute.T.type, getType(cur_cfg.function_def->GetReturnType()), cur_reg,
-                      NewReg());
+    IRgenTypeConverse(bb, return_exp->attribute.T.type, getType(cur_cfg.function_def->GetReturnType()));
 
     IRgenRetReg(bb, cur_cfg.function_def->GetReturnType(), cur_reg);
 }
@@ -1280,6 +1298,23 @@ std::vector<int> GetIndexFromFlatIndex(const std::vector<int> dims, int flatInde
     return index;
 }
 
+// 初始值是否为编译期常量0(-0.0除外), 局部数组在初始化前已经通过memset清零, 这样的元素不需要生成store
+static bool IsConstZeroInitVal(InitVal val) {
+    if (!val->attribute.V.ConstTag) {
+        return false;
+    }
+    switch (val->attribute.T.type) {
+    case Type::INT:
+        return val->attribute.V.val.IntVal == 0;
+    case Type::FLOAT:
+        return val->attribute.V.val.FloatVal == 0 && !std::signbit(val->attribute.V.val.FloatVal);
+    case Type::BOOL:
+        return !val->attribute.V.val.BoolVal;
+    default:
+        return false;
+    }
+}
+
 size_t initIntArray(LLVMBlock bb, std::vector<InitVal> *currentInit, int addr_reg, const std::vector<int> &dims,
                     size_t index, int depth) {
     if (!currentInit) {
@@ -1298,16 +1333,18 @@ size_t initIntArray(LLVMBlock bb, std::vector<InitVal> *currentInit, int addr_re
         if (val->GetInitValArray()) {
             // 递归处理数组初始化
             index = initIntArray(bb, val->GetInitValArray(), addr_reg, dims, index, depth + 1);
+        } else if (IsConstZeroInitVal(val)) {
+            index++;
         } else {
             // 生成IR代码
             val->codeIR();
-            IRgenTypeConverse(bb, val->attribute.T.type, Type::INT, cur_reg, NewReg());
+            IRgenTypeConverse(bb, val->attribute.T.type, Type::INT);
             auto val_reg = cur_reg;
 
             // 使用GetElementptrInstruction获取元素地址
             auto getele =
-            new GetElementptrInstruction(BasicInstruction::LLVMType::I32, GetNewRegOperand(NewReg()),
-                                         GetNewRegOperand(addr_reg), dims, BasicInstruction::LLVMType::I32);
+            ir_arena->New<GetElementptrInstruction>(BasicInstruction::LLVMType::I32, GetNewRegOperand(NewReg()),
+                                                    GetNewRegOperand(addr_reg), dims, BasicInstruction::LLVMType::I32);
             auto result = getele->GetResult();
             getele->push_idx_imm32(0);
 
@@ -1342,13 +1379,15 @@ size_t initFloatArray(LLVMBlock bb, std::vector<InitVal> *currentInit, int addr_
 
         if (val->GetInitValArray()) {
             index = initIntArray(bb, val->GetInitValArray(), addr_reg, dims, index, depth + 1);
+        } else if (IsConstZeroInitVal(val)) {
+            index++;
         } else {
             val->codeIR();
-            IRgenTypeConverse(bb, val->attribute.T.type, Type::FLOAT, cur_reg, NewReg());
+            IRgenTypeConverse(bb, val->attribute.T.type, Type::FLOAT);
             auto val_reg = cur_reg;
             auto getele =
-            new GetElementptrInstruction(BasicInstruction::LLVMType::FLOAT32, GetNewRegOperand(NewReg()),
-                                         GetNewRegOperand(addr_reg), dims, BasicInstruction::LLVMType::I32);
+            ir_arena->New<GetElementptrInstruction>(BasicInstruction::LLVMType::FLOAT32, GetNewRegOperand(NewReg()),
+                                                    GetNewRegOperand(addr_reg), dims, BasicInstruction::LLVMType::I32);
             auto result = getele->GetResult();
             getele->push_idx_imm32(0);
 
@@ -1374,25 +1413,27 @@ void VarDecl::codeIR() {
     if (semant_table.symbol_table.get_current_scope() == 0) {
         // 全局变量声明
         for (auto def : *var_def_list) {
-            VarAttribute var = semant_table.GlobalVarTable[def->GetName()];
+            const VarAttribute &var = semant_table.GlobalVarTable[def->GetName()];
+            auto name = def->GetName()->get_string();
+            auto type = getLLVMType[var.type];
 
             Instruction ins;
             if (var.dims.size() == 0) {    // 非数组
                 auto init = def->GetInitVal();
                 if (init != nullptr) {    // 有初始值
                     if (var.type == Type::INT) {
-                        ins = new GlobalVarDefineInstruction(def->GetName()->get_string(), getLLVMType[var.type],
-                                                             new ImmI32Operand(var.IntInitVals[0]));
+                        ins = ir_arena->New<GlobalVarDefineInstruction>(
+                        name, type, GetNewImmI32Operand(var.IntInitVals[0]));
                     } else if (var.type == Type::FLOAT) {
-                        ins = new GlobalVarDefineInstruction(def->GetName()->get_string(), getLLVMType[var.type],
-                                                             new ImmF32Operand(var.FloatInitVals[0]));
+                        ins = ir_arena->New<GlobalVarDefineInstruction>(
+                        name, type, GetNewImmF32Operand(var.FloatInitVals[0]));
                     }
                 } else {
-                    ins = new GlobalVarDefineInstruction(def->GetName()->get_string(), getLLVMType[var.type], nullptr);
+                    ins = ir_arena->New<GlobalVarDefineInstruction>(name, type, nullptr);
                 }
 
             } else {    // 全局变量数组初始化
-                ins = new GlobalVarDefineInstruction(def->GetName()->get_string(), getLLVMType[var.type], var);
+                ins = ir_arena->New<GlobalVarDefineInstruction>(name, type, var);
             }
             llvmIR.global_def.push_back(ins);
         }
@@ -1437,13 +1478,13 @@ void VarDecl::codeIR() {
                 // 指向待初始化内存的指针
                 args.push_back(std::make_pair(BasicInstruction::PTR, GetNewRegOperand(cur_reg)));
                 // 初始值
-                args.push_back(std::make_pair(BasicInstruction::I8, new ImmI32Operand(0)));
+                args.push_back(std::make_pair(BasicInstruction::I8, GetNewImmI32Operand(0)));
                 // 初始化的长度，以字节为单位
-                args.push_back(std::make_pair(BasicInstruction::I32, new ImmI32Operand(size * sizeof(int))));
+                args.push_back(std::make_pair(BasicInstruction::I32, GetNewImmI32Operand(size * sizeof(int))));
                 // 内存对齐长度
-                args.push_back(std::make_pair(BasicInstruction::I1, new ImmI32Operand(0)));
-                auto memset = new CallInstruction(BasicInstruction::LLVMType::VOID, GetNewRegOperand(cur_reg),
-                                                  "llvm.memset.p0.i32", args);
+                args.push_back(std::make_pair(BasicInstruction::I1, GetNewImmI32Operand(0)));
+                auto memset = ir_arena->New<CallInstruction>(BasicInstruction::LLVMType::VOID,
+                                                             GetNewRegOperand(cur_reg), "llvm.memset.p0.i32", args);
                 bb->InsertInstruction(1, memset);
 
                 if (type_decl == Type::INT) {
@@ -1466,7 +1507,7 @@ void VarDecl::codeIR() {
             if (init) {    // 如果有初始值
                 auto v_exp = dynamic_cast<VarInitVal_exp *>(init);
                 v_exp->exp->codeIR();
-                IRgenTypeConverse(bb, init->attribute.T.type, type_decl, cur_reg, NewReg());
+                IRgenTypeConverse(bb, init->attribute.T.type, type_decl);
                 auto operand = GetNewRegOperand(cur_reg);
                 IRgenStore(bb, getLLVMType[type_decl], operand, GetNewRegOperand(vardecl_reg));
             }
@@ -1491,7 +1532,9 @@ void ConstDecl::codeIR() {
     if (semant_table.symbol_table.get_current_scope() == 0) {
         // 全局变量声明
         for (auto def : *var_def_list) {
-            VarAttribute var = semant_table.GlobalVarTable[def->GetName()];
+            const VarAttribute &var = semant_table.GlobalVarTable[def->GetName()];
+            auto name = def->GetName()->get_string();
+            auto type = getLLVMType[var.type];
 
             Instruction ins;
             if (var.dims.size() == 0) {    // 非数组
@@ -1499,18 +1542,18 @@ void ConstDecl::codeIR() {
                 if (init != nullptr) {    // 有初始值
 
                     if (var.type == Type::INT) {
-                        ins = new GlobalVarDefineInstruction(def->GetName()->get_string(), getLLVMType[var.type],
-                                                             new ImmI32Operand(var.IntInitVals[0]));
+                        ins = ir_arena->New<GlobalVarDefineInstruction>(
+                        name, type, GetNewImmI32Operand(var.IntInitVals[0]));
                     } else if (var.type == Type::FLOAT) {
-                        ins = new GlobalVarDefineInstruction(def->GetName()->get_string(), getLLVMType[var.type],
-                                                             new ImmF32Operand(var.FloatInitVals[0]));
+                        ins = ir_arena->New<GlobalVarDefineInstruction>(
+                        name, type, GetNewImmF32Operand(var.FloatInitVals[0]));
                     }
                 } else {
-                    ins = new GlobalVarDefineInstruction(def->GetName()->get_string(), getLLVMType[var.type], nullptr);
+                    ins = ir_arena->New<GlobalVarDefineInstruction>(name, type, nullptr);
                 }
 
             } else {    // 全局变量数组初始化
-                ins = new GlobalVarDefineInstruction(def->GetName()->get_string(), getLLVMType[var.type], var);
+                ins = ir_arena->New<GlobalVarDefineInstruction>(name, type, var);
             }
             llvmIR.global_def.push_back(ins);
         }
@@ -1545,11 +1588,11 @@ void ConstDecl::codeIR() {
                 }
                 std::vector<std::pair<BasicInstruction::LLVMType, Operand>> args;
                 args.push_back(std::make_pair(BasicInstruction::PTR, GetNewRegOperand(cur_reg)));
-                args.push_back(std::make_pair(BasicInstruction::I8, new ImmI32Operand(0)));
-                args.push_back(std::make_pair(BasicInstruction::I32, new ImmI32Operand(size * sizeof(int))));
-                args.push_back(std::make_pair(BasicInstruction::I1, new ImmI32Operand(0)));
-                auto memset = new CallInstruction(BasicInstruction::LLVMType::VOID, GetNewRegOperand(cur_reg),
-                                                  "llvm.memset.p0.i32", args);
+                args.push_back(std::make_pair(BasicInstruction::I8, GetNewImmI32Operand(0)));
+                args.push_back(std::make_pair(BasicInstruction::I32, GetNewImmI32Operand(size * sizeof(int))));
+                args.push_back(std::make_pair(BasicInstruction::I1, GetNewImmI32Operand(0)));
+                auto memset = ir_arena->New<CallInstruction>(BasicInstruction::LLVMType::VOID,
+                                                             GetNewRegOperand(cur_reg), "llvm.memset.p0.i32", args);
                 bb->InsertInstruction(1, memset);
                 if (type_decl == Type::INT) {
                     size_t index = initIntArray(bb, def->GetInitVal()->GetInitValArray(), cur_reg, var.dims, 0, 0);
@@ -1572,7 +1615,7 @@ void ConstDecl::codeIR() {
             if (init) {    // 如果有初始值
                 auto c_exp = dynamic_cast<ConstInitVal_exp *>(init);
                 c_exp->exp->codeIR();
-                IRgenTypeConverse(bb, init->attribute.T.type, type_decl, cur_reg, NewReg());
+                IRgenTypeConverse(bb, init->attribute.T.type, type_decl);
             } else {    // 没有初始值默认为 0
                 if (type_decl == Type::INT) {
                     IRgenArithmeticI32ImmAll(bb, BasicInstruction::LLVMIROpcode::ADD, 0, 0, NewReg());
@@ -1619,6 +1662,7 @@ void __FuncDef::codeIR() {
     // std::vector<FuncFParam> *formals;
     // Block block;
 
+    TimeReport::FunctionScope timer(time_report, name->get_string());
     irgen_table.symbol_table.enter_scope();
     semant_table.symbol_table.enter_scope();
 
@@ -1630,8 +1674,10 @@ void __FuncDef::codeIR() {
     return_label = 0;
 
     auto ret_type = getLLVMType[return_type];
-    auto f_def = new FunctionDefineInstruction(ret_type, name->get_string());
+    auto f_def = ir_arena->New<FunctionDefineInstruction>(ret_type, name->get_string());
     llvmIR.NewFunction(f_def);
+    // 函数内的指令分配在该函数自己的arena中
+    ir_arena = &llvmIR.GetArena(f_def);
 
     // 函数入口基本块，处理形参
     auto bb = llvmIR.NewBlock(f_def, NewLabel());
@@ -1737,6 +1783,7 @@ void __FuncDef::codeIR() {
     }
 
     llvmIR.def_reg[f_def] = cur_reg;
+    ir_arena = &llvmIR.global_arena;
 
     irgen_table.symbol_table.exit_scope();
     semant_table.symbol_table.exit_scope();
@@ -1751,78 +1798,89 @@ void CompUnit_Decl::codeIR() {
 void CompUnit_FuncDef::codeIR() { func_def->codeIR(); }
 
 void AddLibFunctionDeclare() {
-    FunctionDeclareInstruction *getint = new FunctionDeclareInstruction(BasicInstruction::I32, "getint");
+    FunctionDeclareInstruction *getint = ir_arena->New<FunctionDeclareInstruction>(BasicInstruction::I32, "getint");
     llvmIR.function_declare.push_back(getint);
 
-    FunctionDeclareInstruction *getchar = new FunctionDeclareInstruction(BasicInstruction::I32, "getch");
+    FunctionDeclareInstruction *getchar = ir_arena->New<FunctionDeclareInstruction>(BasicInstruction::I32, "getch");
     llvmIR.function_declare.push_back(getchar);
 
-    FunctionDeclareInstruction *getfloat = new FunctionDeclareInstruction(BasicInstruction::FLOAT32, "getfloat");
+    FunctionDeclareInstruction *getfloat =
+    ir_arena->New<FunctionDeclareInstruction>(BasicInstruction::FLOAT32, "getfloat");
     llvmIR.function_declare.push_back(getfloat);
 
-    FunctionDeclareInstruction *getarray = new FunctionDeclareInstruction(BasicInstruction::I32, "getarray");
+    FunctionDeclareInstruction *getarray = ir_arena->New<FunctionDeclareInstruction>(BasicInstruction::I32, "getarray");
     getarray->InsertFormal(BasicInstruction::PTR);
     llvmIR.function_declare.push_back(getarray);
 
-    FunctionDeclareInstruction *getfloatarray = new FunctionDeclareInstruction(BasicInstruction::I32, "getfarray");
+    FunctionDeclareInstruction *getfloatarray =
+    ir_arena->New<FunctionDeclareInstruction>(BasicInstruction::I32, "getfarray");
     getfloatarray->InsertFormal(BasicInstruction::PTR);
     llvmIR.function_declare.push_back(getfloatarray);
 
-    FunctionDeclareInstruction *putint = new FunctionDeclareInstruction(BasicInstruction::VOID, "putint");
+    FunctionDeclareInstruction *putint = ir_arena->New<FunctionDeclareInstruction>(BasicInstruction::VOID, "putint");
     putint->InsertFormal(BasicInstruction::I32);
     llvmIR.function_declare.push_back(putint);
 
-    FunctionDeclareInstruction *putch = new FunctionDeclareInstruction(BasicInstruction::VOID, "putch");
+    FunctionDeclareInstruction *putch = ir_arena->New<FunctionDeclareInstruction>(BasicInstruction::VOID, "putch");
     putch->InsertFormal(BasicInstruction::I32);
     llvmIR.function_declare.push_back(putch);
 
-    FunctionDeclareInstruction *putfloat = new FunctionDeclareInstruction(BasicInstruction::VOID, "putfloat");
+    FunctionDeclareInstruction *putfloat =
+    ir_arena->New<FunctionDeclareInstruction>(BasicInstruction::VOID, "putfloat");
     putfloat->InsertFormal(BasicInstruction::FLOAT32);
     llvmIR.function_declare.push_back(putfloat);
 
-    FunctionDeclareInstruction *putarray = new FunctionDeclareInstruction(BasicInstruction::VOID, "putarray");
+    FunctionDeclareInstruction *putarray =
+    ir_arena->New<FunctionDeclareInstruction>(BasicInstruction::VOID, "putarray");
     putarray->InsertFormal(BasicInstruction::I32);
     putarray->InsertFormal(BasicInstruction::PTR);
     llvmIR.function_declare.push_back(putarray);
 
-    FunctionDeclareInstruction *putfarray = new FunctionDeclareInstruction(BasicInstruction::VOID, "putfarray");
+    FunctionDeclareInstruction *putfarray =
+    ir_arena->New<FunctionDeclareInstruction>(BasicInstruction::VOID, "putfarray");
     putfarray->InsertFormal(BasicInstruction::I32);
     putfarray->InsertFormal(BasicInstruction::PTR);
     llvmIR.function_declare.push_back(putfarray);
 
-    FunctionDeclareInstruction *starttime = new FunctionDeclareInstruction(BasicInstruction::VOID, "_sysy_starttime");
+    FunctionDeclareInstruction *starttime =
+    ir_arena->New<FunctionDeclareInstruction>(BasicInstruction::VOID, "_sysy_starttime");
     starttime->InsertFormal(BasicInstruction::I32);
     llvmIR.function_declare.push_back(starttime);
 
-    FunctionDeclareInstruction *stoptime = new FunctionDeclareInstruction(BasicInstruction::VOID, "_sysy_stoptime");
+    FunctionDeclareInstruction *stoptime =
+    ir_arena->New<FunctionDeclareInstruction>(BasicInstruction::VOID, "_sysy_stoptime");
     stoptime->InsertFormal(BasicInstruction::I32);
     llvmIR.function_declare.push_back(stoptime);
 
     // 一些llvm自带的函数，也许会为你的优化提供帮助
     FunctionDeclareInstruction *llvm_memset =
-    new FunctionDeclareInstruction(BasicInstruction::VOID, "llvm.memset.p0.i32");
+    ir_arena->New<FunctionDeclareInstruction>(BasicInstruction::VOID, "llvm.memset.p0.i32");
     llvm_memset->InsertFormal(BasicInstruction::PTR);
     llvm_memset->InsertFormal(BasicInstruction::I8);
     llvm_memset->InsertFormal(BasicInstruction::I32);
     llvm_memset->InsertFormal(BasicInstruction::I1);
     llvmIR.function_declare.push_back(llvm_memset);
 
-    FunctionDeclareInstruction *llvm_umax = new FunctionDeclareInstruction(BasicInstruction::I32, "llvm.umax.i32");
+    FunctionDeclareInstruction *llvm_umax =
+    ir_arena->New<FunctionDeclareInstruction>(BasicInstruction::I32, "llvm.umax.i32");
     llvm_umax->InsertFormal(BasicInstruction::I32);
     llvm_umax->InsertFormal(BasicInstruction::I32);
     llvmIR.function_declare.push_back(llvm_umax);
 
-    FunctionDeclareInstruction *llvm_umin = new FunctionDeclareInstruction(BasicInstruction::I32, "llvm.umin.i32");
+    FunctionDeclareInstruction *llvm_umin =
+    ir_arena->New<FunctionDeclareInstruction>(BasicInstruction::I32, "llvm.umin.i32");
     llvm_umin->InsertFormal(BasicInstruction::I32);
     llvm_umin->InsertFormal(BasicInstruction::I32);
     llvmIR.function_declare.push_back(llvm_umin);
 
-    FunctionDeclareInstruction *llvm_smax = new FunctionDeclareInstruction(BasicInstruction::I32, "llvm.smax.i32");
+    FunctionDeclareInstruction *llvm_smax =
+    ir_arena->New<FunctionDeclareInstruction>(BasicInstruction::I32, "llvm.smax.i32");
     llvm_smax->InsertFormal(BasicInstruction::I32);
     llvm_smax->InsertFormal(BasicInstruction::I32);
     llvmIR.function_declare.push_back(llvm_smax);
 
-    FunctionDeclareInstruction *llvm_smin = new FunctionDeclareInstruction(BasicInstruction::I32, "llvm.smin.i32");
+    FunctionDeclareInstruction *llvm_smin =
+    ir_arena->New<FunctionDeclareInstruction>(BasicInstruction::I32, "llvm.smin.i32");
     llvm_smin->InsertFormal(BasicInstruction::I32);
     llvm_smin->InsertFormal(BasicInstruction::I32);
     llvmIR.function_declare.push_back(llvm_smin);
@@ -45,7 +45,7 @@ SemantTable semant_table;
 std::vector<std::string> error_msgs{};    // 将语义错误信息保存到该变量中
 
 // 常量数组初始化
-size_t fillIntArray(std::vector<InitVal> *currentInit, std::vector<int> &array, const std::vector<int> &dims,
+size_t fillIntArray(std::vector<InitVal> *currentInit, SparseArray<int> &array, const std::vector<int> &dims,
                     size_t index, int depth, bool constTag) {
     if (!currentInit) {
         return index;
@@ -92,7 +92,7 @@ size_t fillIntArray(std::vector<InitVal> *currentInit, std::vector<int> &array,
                                      std::to_string(val->GetLineNumber()) + "\n");
                 break;
             }
-            array[index++] = val->attribute.V.val.IntVal;
+            array.set(index++, val->attribute.V.val.IntVal);
 
             if (index - 1 >= next_index) {
                 error_msgs.push_back("Initial values exceed array dimensions in line " +
@@ -106,7 +106,7 @@ size_t fillIntArray(std::vector<InitVal> *currentInit, std::vector<int> &array,
     return next_index;
 }
 
-size_t fillFloatArray(std::vector<InitVal> *currentInit, std::vector<float> &array, const std::vector<int> dims,
+size_t fillFloatArray(std::vector<InitVal> *currentInit, SparseArray<float> &array, const std::vector<int> dims,
                       size_t index, int depth, bool constTag) {
     if (!currentInit) {
         return index;
@@ -146,7 +146,7 @@ size_t fillFloatArray(std::vector<InitVal> *currentInit, std::vector<float> &arr
                                          std::to_string(val->GetLineNumber()) + "\n");
                     break;
                 }
-                array[index++] = val->attribute.V.val.FloatVal;
+                array.set(index++, val->attribute.V.val.FloatVal);
 
                 if (index - 1 >= next_index) {
                     error_msgs.push_back("Initial values exceed array dimensions in line " +
@@ -164,7 +164,7 @@ size_t fillFloatArray(std::vector<InitVal> *currentInit, std::vector<float> &arr
                                          std::to_string(val->GetLineNumber()) + "\n");
                     break;
                 }
-                array[index++] = float(val->attribute.V.val.IntVal);
+                array.set(index++, float(val->attribute.V.val.IntVal));
 
                 if (index - 1 >= next_index) {
                     error_msgs.push_back("Initial values exceed array dimensions in line " +
@@ -184,7 +184,7 @@ size_t fillFloatArray(std::vector<InitVal> *currentInit, std::vector<float> &arr
 }
 
 // 根据索引访问展平数组
-int getIntArrayVal(VarAttribute val, std::vector<int> index) {
+int getIntArrayVal(const VarAttribute &val, const std::vector<int> &index) {
     if (index.size() == 1) {
         // 一维数组，直接返回值
         return val.IntInitVals[index[0]];
@@ -198,7 +198,7 @@ int getIntArrayVal(VarAttribute val, std::vector<int> index) {
     return val.IntInitVals[idx];
 }
 
-int getFloatArrayVal(VarAttribute val, std::vector<int> index) {
+int getFloatArrayVal(const VarAttribute &val, const std::vector<int> &index) {
     if (index.size() == 1) {
         // 一维数组，直接返回值
         return val.FloatInitVals[index[0]];
@@ -1023,12 +1023,13 @@ void ConstExp::TypeCheck() {
 void Lval::TypeCheck() {
     // TODO("Lval Semant");
 
-    VarAttribute var;
+    // 使用指向符号表中变量信息的指针, 避免拷贝数组的初始值
+    const VarAttribute *var;
     if (semant_table.symbol_table.lookup_scope(name) != -1) {
-        var = semant_table.symbol_table.lookup_val(name);
+        var = &semant_table.symbol_table.lookup_val(name);
         scope = semant_table.symbol_table.lookup_scope(name);
     } else if (semant_table.GlobalTable.find(name) != semant_table.GlobalTable.end()) {
-        var = semant_table.GlobalTable[name];
+        var = &semant_table.GlobalTable[name];
         scope = 0;
     } else {
         error_msgs.push_back("undeclared variable '" + name->get_string() + "' in line " + std::to_string(line_number) +
@@ -1051,28 +1052,28 @@ void Lval::TypeCheck() {
         lval_dims.push_back(d->attribute.V.val.IntVal);
     }
 
-    if (var.dims.size() > lval_dims.size()) {
+    if (var->dims.size() > lval_dims.size()) {
         // 数组
         attribute.T.type = Type::PTR;
         attribute.V.ConstTag = false;
-    } else if (var.dims.size() == lval_dims.size()) {
+    } else if (var->dims.size() == lval_dims.size()) {
         // 非数组
-        attribute.T.type = var.type;
-        attribute.V.ConstTag = var.ConstTag;
-        if (var.ConstTag) {
-            if (var.dims.size() == 0) {
+        attribute.T.type = var->type;
+        attribute.V.ConstTag = var->ConstTag;
+        if (var->ConstTag) {
+            if (var->dims.size() == 0) {
                 // 定义的值不是数组
                 if (attribute.T.type == Type::INT) {
-                    attribute.V.val.IntVal = var.IntInitVals[0];
+                    attribute.V.val.IntVal = var->IntInitVals[0];
                 } else if (attribute.T.type == Type::FLOAT) {
-                    attribute.V.val.FloatVal = var.FloatInitVals[0];
+                    attribute.V.val.FloatVal = var->FloatInitVals[0];
                 }
             } else {
                 // 定义的值是数组
                 if (attribute.T.type == Type::INT) {
-                    attribute.V.val.IntVal = getIntArrayVal(var, lval_dims);
+                    attribute.V.val.IntVal = getIntArrayVal(*var, lval_dims);
                 } else if (attribute.T.type == Type::FLOAT) {
-                    attribute.V.val.FloatVal = getFloatArrayVal(var, lval_dims);
+                    attribute.V.val.FloatVal = getFloatArrayVal(*var, lval_dims);
                 }
             }
         }
@@ -1408,15 +1409,15 @@ void VarDecl::TypeCheck() {
             if (type_decl == Type::INT) {
                 // 如果变量为整数类型且初始值是一个数组
                 if (var->GetInitVal()->GetInitValArray()) {
-                    std::vector<int> result(size, 0);
+                    SparseArray<int> result(size);
                     // 填充整数数组，index为填充后的位置，如果超出数组长度，添加错误信息
                     size_t index = fillIntArray(var->GetInitVal()->GetInitValArray(), result, dims, 0, 0, false);
                     if (index > size) {
                         error_msgs.push_back("Initial values exceed array dimensions in line " +
                                              std::to_string(line_number) + "\n");
                     }
-                    var_attr.IntInitVals = result;    // 将填充后的数组设置为变量的初始值
-                } else {                              // 如果变量为整数类型且初始值不是一个数组
+                    var_attr.IntInitVals = std::move(result);    // 将填充后的数组设置为变量的初始值
+                } else {                                         // 如果变量为整数类型且初始值不是一个数组
                     // 根据初始值的类型进行相应的处理和转换
                     switch (var->GetInitVal()->attribute.T.type) {
                     case Type::INT:
@@ -1434,15 +1435,15 @@ void VarDecl::TypeCheck() {
                 // 如果变量为浮点数类型且初始值是一个数组
                 if (var->GetInitVal()->GetInitValArray()) {
                     // 初始化一个浮点数类型的数组，长度为size，初始值为0
-                    std::vector<float> result(size, 0);
+                    SparseArray<float> result(size);
                     // 填充浮点数数组，index为填充后的位置，如果超出数组长度，添加错误信息
                     size_t index = fillFloatArray(var->GetInitVal()->GetInitValArray(), result, dims, 0, 0, false);
                     if (index > size) {
                         error_msgs.push_back("Initial values exceed array dimensions in line " +
                                              std::to_string(line_number) + "\n");
                     }
-                    var_attr.FloatInitVals = result;    // 将填充后的数组设置为变量的初始值
-                } else {                                // 如果变量为浮点数类型且初始值不是一个数组
+                    var_attr.FloatInitVals = std::move(result);    // 将填充后的数组设置为变量的初始值
+                } else {                                           // 如果变量为浮点数类型且初始值不是一个数组
                     // 根据初始值的类型进行相应的处理和转换
                     switch (var->GetInitVal()->attribute.T.type) {
                     case Type::INT:
@@ -1459,18 +1460,18 @@ void VarDecl::TypeCheck() {
             }
         } else {    // 如果变量没有初始值，根据变量类型设置默认初始值
             if (type_decl == Type::INT) {
-                var_attr.IntInitVals.resize(size, 0);    // 默认初始值0
+                var_attr.IntInitVals.resize(size);    // 默认初始值0
             } else if (type_decl == Type::FLOAT) {
-                var_attr.FloatInitVals.resize(size, 0);
+                var_attr.FloatInitVals.resize(size);
             }
         }
 
         // 将变量属性信息添加到相应的符号表中
         if (is_global) {    // 如果是全局变量
             semant_table.GlobalVarTable[var->GetName()] = var_attr;
-            semant_table.GlobalTable[var->GetName()] = var_attr;
+            semant_table.GlobalTable[var->GetName()] = std::move(var_attr);
         } else {    // 如果是局部变量
-            semant_table.symbol_table.add_Symbol(var->GetName(), var_attr);
+            semant_table.symbol_table.add_Symbol(var->GetName(), std::move(var_attr));
         }
     }
 }
@@ -1520,7 +1521,7 @@ void ConstDecl::TypeCheck() {
                         if (type_decl == Type::INT) {
                             if (var->GetInitVal()->GetInitValArray()) {
                                 // InitVal -> {InitVal, InitVal...}
-                                std::vector<int> result(size, 0);
+                                SparseArray<int> result(size);
 
                                 size_t index =
                                 fillIntArray(var->GetInitVal()->GetInitValArray(), result, dims, 0, 0, true);
@@ -1528,7 +1529,7 @@ void ConstDecl::TypeCheck() {
                                     error_msgs.push_back("Initial values exceed array dimensions in line " +
                                                          std::to_string(line_number) + "\n");
                                 }
-                                var_attr.IntInitVals = result;
+                                var_attr.IntInitVals = std::move(result);
                             } else {
                                 // InitVal -> InitVal
                                 if (var->GetInitVal()->attribute.T.type == Type::INT) {
@@ -1543,14 +1544,14 @@ void ConstDecl::TypeCheck() {
                         } else if (type_decl == Type::FLOAT) {
                             if (var->GetInitVal()->GetInitValArray()) {
                                 // InitVal -> {InitVal, InitVal...}
-                                std::vector<float> result(size, 0);
+                                SparseArray<float> result(size);
                                 size_t index =
                                 fillFloatArray(var->GetInitVal()->GetInitValArray(), result, dims, 0, 0, true);
                                 if (index > size) {
                                     error_msgs.push_back("Initial values exceed array dimensions in line " +
                                                          std::to_string(line_number) + "\n");
                                 }
-                                var_attr.FloatInitVals = result;
+                                var_attr.FloatInitVals = std::move(result);
                             } else {
                                 // InitVal -> InitVal
                                 if (var->GetInitVal()->attribute.T.type == Type::INT) {
@@ -1565,7 +1566,7 @@ void ConstDecl::TypeCheck() {
                         }
                     }
                     semant_table.GlobalTable[var->GetName()] = var_attr;
-                    semant_table.GlobalVarTable[var->GetName()] = var_attr;
+                    semant_table.GlobalVarTable[var->GetName()] = std::move(var_attr);
                 }
             } else {
                 for (auto var : var_list_vector) {
@@ -1613,7 +1614,7 @@ void ConstDecl::TypeCheck() {
                         if (type_decl == Type::INT) {
                             if (var->GetInitVal()->GetInitValArray()) {
                                 // InitVal -> {InitVal, InitVal...}
-                                std::vector<int> result(size, 0);
+                                SparseArray<int> result(size);
 
                                 size_t index =
                                 fillIntArray(var->GetInitVal()->GetInitValArray(), result, dims, 0, 0, true);
@@ -1621,7 +1622,7 @@ void ConstDecl::TypeCheck() {
                                     error_msgs.push_back("Initial values exceed array dimensions in line " +
                                                          std::to_string(line_number) + "\n");
                                 }
-                                var_attr.IntInitVals = result;
+                                var_attr.IntInitVals = std::move(result);
                             } else {
                                 // InitVal -> InitVal
                                 if (var->GetInitVal()->attribute.T.type == Type::INT) {
@@ -1636,14 +1637,14 @@ void ConstDecl::TypeCheck() {
                         } else if (type_decl == Type::FLOAT) {
                             if (var->GetInitVal()->GetInitValArray()) {
                                 // InitVal -> {InitVal, InitVal...}
-                                std::vector<float> result(size, 0);
+                                SparseArray<float> result(size);
                                 size_t index =
                                 fillFloatArray(var->GetInitVal()->GetInitValArray(), result, dims, 0, 0, true);
                                 if (index > size) {
                                     error_msgs.push_back("Initial values exceed array dimensions in line " +
                                                          std::to_string(line_number) + "\n");
                                 }
-                                var_attr.FloatInitVals = result;
+                                var_attr.FloatInitVals = std::move(result);
                             } else {
                                 // InitVal -> InitVal
                                 if (var->GetInitVal()->attribute.T.type == Type::INT) {
@@ -1659,7 +1660,7 @@ void ConstDecl::TypeCheck() {
                     }
 
                     // Add the constant declaration to the symbol table
-                    semant_table.symbol_table.add_Symbol(var->GetName(), var_attr);
+                    semant_table.symbol_table.add_Symbol(var->GetName(), std::move(var_attr));
                 }
             }
         }
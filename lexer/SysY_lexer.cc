@@ -730,7 +730,7 @@ YY_DECL {
 #line 23 "lexer/SysY_lexer.l"
                 {    // 单行注释
                     cur_col_number = col_number;
-                    col_number += strlen(yytext);
+                    col_number += yyleng;
                 }
                 YY_BREAK
             case 2:
@@ -738,7 +738,7 @@ YY_DECL {
 #line 28 "lexer/SysY_lexer.l"
                 {    // 多行注释
                     cur_col_number = col_number;
-                    col_number += strlen(yytext);
+                    col_number += yyleng;
                     BEGIN(ANNOTATION);
                 }
                 YY_BREAK
@@ -747,7 +747,7 @@ YY_DECL {
 #line 34 "lexer/SysY_lexer.l"
                 {
                     cur_col_number = col_number;
-                    col_number += strlen(yytext);
+                    col_number += yyleng;
                     yylval.error_msg = "only */ without /*";
                     return ERROR;
                 }
@@ -757,7 +757,7 @@ YY_DECL {
 #line 41 "lexer/SysY_lexer.l"
                 {
                     cur_col_number = col_number;
-                    col_number += strlen(yytext);
+                    col_number += yyleng;
                     BEGIN(INITIAL);
                 }
                 YY_BREAK
@@ -775,7 +775,7 @@ YY_DECL {
 #line 52 "lexer/SysY_lexer.l"
                 {
                     cur_col_number = col_number;
-                    col_number += strlen(yytext);
+                    col_number += yyleng;
                 }
                 YY_BREAK
             /* TODO():增加处理列号的代码(cur_col_number表示当前token开始位置, col_number表示当前token结束位置) */
@@ -784,7 +784,7 @@ YY_DECL {
 #line 58 "lexer/SysY_lexer.l"
                 {
                     cur_col_number = col_number;
-                    col_number += strlen(yytext);
+                    col_number += yyleng;
                     return LEQ;
                 }
                 YY_BREAK
@@ -793,7 +793,7 @@ YY_DECL {
 #line 63 "lexer/SysY_lexer.l"
                 {
                     cur_col_number = col_number;
-                    col_number += strlen(yytext);
+                    col_number += yyleng;
                     return GEQ;
                 }
                 YY_BREAK
@@ -802,7 +802,7 @@ YY_DECL {
 #line 68 "lexer/SysY_lexer.l"
                 {
                     cur_col_number = col_number;
-                    col_number += strlen(yytext);
+                    col_number += yyleng;
                     return EQ;
                 }
                 YY_BREAK
@@ -811,7 +811,7 @@ YY_DECL {
 #line 73 "lexer/SysY_lexer.l"
                 {
                     cur_col_number = col_number;
-                    col_number += strlen(yytext);
+                    col_number += yyleng;
                     return NE;
                 }
                 YY_BREAK
@@ -820,7 +820,7 @@ YY_DECL {
 #line 78 "lexer/SysY_lexer.l"
                 {
                     cur_col_number = col_number;
-                    col_number += strlen(yytext);
+                    col_number += yyleng;
                     return AND;
                 }
                 YY_BREAK
@@ -829,7 +829,7 @@ YY_DECL {
 #line 83 "lexer/SysY_lexer.l"
                 {
                     cur_col_number = col_number;
-                    col_number += strlen(yytext);
+                    col_number += yyleng;
                     return OR;
                 }
                 YY_BREAK
@@ -838,7 +838,7 @@ YY_DECL {
 #line 88 "lexer/SysY_lexer.l"
                 {
                     cur_col_number = col_number;
-                    col_number += strlen(yytext);
+                    col_number += yyleng;
                     return CONST;
                 }
                 YY_BREAK
@@ -847,7 +847,7 @@ YY_DECL {
 #line 93 "lexer/SysY_lexer.l"
                 {
                     cur_col_number = col_number;
-                    col_number += strlen(yytext);
+                    col_number += yyleng;
                     return IF;
                 }
                 YY_BREAK
@@ -856,7 +856,7 @@ YY_DECL {
 #line 98 "lexer/SysY_lexer.l"
                 {
                     cur_col_number = col_number;
-                    col_number += strlen(yytext);
+                    col_number += yyleng;
                     return ELSE;
                 }
                 YY_BREAK
@@ -865,7 +865,7 @@ YY_DECL {
 #line 103 "lexer/SysY_lexer.l"
                 {
                     cur_col_number = col_number;
-                    col_number += strlen(yytext);
+                    col_number += yyleng;
                     return WHILE;
                 }
                 YY_BREAK
@@ -874,7 +874,7 @@ YY_DECL {
 #line 108 "lexer/SysY_lexer.l"
                 {
                     cur_col_number = col_number;
-                    col_number += strlen(yytext);
+                    col_number += yyleng;
                     return NONE_TYPE;
                 }
                 YY_BREAK
@@ -883,7 +883,7 @@ YY_DECL {
 #line 113 "lexer/SysY_lexer.l"
                 {
                     cur_col_number = col_number;
-                    col_number += strlen(yytext);
+                    col_number += yyleng;
                     return INT;
                 }
                 YY_BREAK
@@ -892,7 +892,7 @@ YY_DECL {
 #line 118 "lexer/SysY_lexer.l"
                 {
                     cur_col_number = col_number;
-                    col_number += strlen(yytext);
+                    col_number += yyleng;
                     return FLOAT;
                 }
                 YY_BREAK
@@ -901,7 +901,7 @@ YY_DECL {
 #line 123 "lexer/SysY_lexer.l"
                 {
                     cur_col_number = col_number;
-                    col_number += strlen(yytext);
+                    col_number += yyleng;
                     return RETURN;
                 }
                 YY_BREAK
@@ -910,7 +910,7 @@ YY_DECL {
 #line 128 "lexer/SysY_lexer.l"
                 {
                     cur_col_number = col_number;
-                    col_number += strlen(yytext);
+                    col_number += yyleng;
                     return BREAK;
                 }
                 YY_BREAK
@@ -919,7 +919,7 @@ YY_DECL {
 #line 133 "lexer/SysY_lexer.l"
                 {
                     cur_col_number = col_number;
-                    col_number += strlen(yytext);
+                    col_number += yyleng;
                     return CONTINUE;
                 }
                 YY_BREAK
@@ -929,7 +929,7 @@ YY_DECL {
 #line 140 "lexer/SysY_lexer.l"
                 {
                     cur_col_number = col_number;
-                    col_number += strlen(yytext);
+                    col_number += yyleng;
                     return FOR;
                 }
                 YY_BREAK
@@ -938,7 +938,7 @@ YY_DECL {
 #line 145 "lexer/SysY_lexer.l"
                 {
                     cur_col_number = col_number;
-                    col_number += strlen(yytext);
+                    col_number += yyleng;
                     return THEN;
                 }
                 YY_BREAK
@@ -955,7 +955,7 @@ YY_DECL {
                 YY_RULE_SETUP
 #line 153 "lexer/SysY_lexer.l"
                 {
-                    col_number += strlen(yytext);
+                    col_number += yyleng;
                 }
                 YY_BREAK
             case 27:
@@ -963,7 +963,7 @@ YY_DECL {
 #line 155 "lexer/SysY_lexer.l"
                 {
                     cur_col_number = col_number;
-                    col_number += strlen(yytext);
+                    col_number += yyleng;
                     return yytext[0];
                 }
                 YY_BREAK
@@ -972,7 +972,7 @@ YY_DECL {
 #line 161 "lexer/SysY_lexer.l"
                 {
                     cur_col_number = col_number;
-                    col_number += strlen(yytext);
+                    col_number += yyleng;
                     return yytext[0];
                 }
                 YY_BREAK
@@ -981,8 +981,8 @@ YY_DECL {
 #line 167 "lexer/SysY_lexer.l"
                 {
                     cur_col_number = col_number;
-                    col_number += strlen(yytext);
-                    yylval.symbol_token = id_table.add_id(std::string(yytext));
+                    col_number += yyleng;
+                    yylval.symbol_token = id_table.add_id(std::string_view(yytext, yyleng));
                     return IDENT;
                 }
                 YY_BREAK
@@ -991,7 +991,7 @@ YY_DECL {
 #line 173 "lexer/SysY_lexer.l"
                 {
                     cur_col_number = col_number;
-                    col_number += strlen(yytext);
+                    col_number += yyleng;
                     // yylval.int_token = stoi(std::string(yytext));
                     yylval.int_token = 0;
                     for (int i = 0; yytext[i]; i++) {
@@ -1013,7 +1013,7 @@ YY_DECL {
                 {
                     // 二进制整数常量
                     cur_col_number = col_number;
-                    col_number += strlen(yytext);
+                    col_number += yyleng;
                     yylval.int_token = 0;
                     int i = 0;
                     // 跳过 0[bB] 两个字符
@@ -1031,7 +1031,7 @@ YY_DECL {
                 {
                     // 八进制整数常量
                     cur_col_number = col_number;
-                    col_number += strlen(yytext);
+                    col_number += yyleng;
                     yylval.int_token = 0;
                     int i = 0;
                     // 跳过 0 一个字符
@@ -1049,7 +1049,7 @@ YY_DECL {
                 {
                     // 十六进制整数常量
                     cur_col_number = col_number;
-                    col_number += strlen(yytext);
+                    col_number += yyleng;
                     yylval.int_token = 0;
                     int i = 0;
                     // 跳过 0[xX] 两个字符
@@ -1073,7 +1073,7 @@ YY_DECL {
                 {
                     // 科学计数法
                     cur_col_number = col_number;
-                    col_number += strlen(yytext);
+                    col_number += yyleng;
                     // yylval.float_token = std::stof(yytext);
                     double result = 0.0;
                     double exp = 0.0;
@@ -1130,7 +1130,7 @@ YY_DECL {
                 {
                     // 十六进制浮点常量
                     cur_col_number = col_number;
-                    col_number += strlen(yytext);
+                    col_number += yyleng;
 
                     int i = 0;
                     // 跳过 0[xX]
@@ -1140,7 +1140,7 @@ YY_DECL {
                     int exp = 0;
                     // 计算整数部分和小数部分，最后再除以小数位个 16 即可
                     int frac_size = 0;
-                    while (i < strlen(yytext) && yytext[i] != 'p' && yytext[i] != 'P') {
+                    while (i < yyleng && yytext[i] != 'p' && yytext[i] != 'P') {
                         if (yytext[i] == '.') {
                             frac_size++;
                             i++;
@@ -1165,9 +1165,9 @@ YY_DECL {
                     }
 
                     // 计算指数部分
-                    if (i < strlen(yytext) && (yytext[i] == 'p' || yytext[i] == 'P')) {
+                    if (i < yyleng && (yytext[i] == 'p' || yytext[i] == 'P')) {
                         i++;
-                        if (i < strlen(yytext)) {
+                        if (i < yyleng) {
                             int exp_sign = 1;
                             if (yytext[i] == '-') {
                                 exp_sign = -1;
@@ -1175,9 +1175,9 @@ YY_DECL {
                             } else if (yytext[i] == '+') {
                                 i++;
                             }
-                            if (i < strlen(yytext)) {
+                            if (i < yyleng) {
                                 // 说明存在指数部分
-                                while (i < strlen(yytext)) {
+                                while (i < yyleng) {
                                     exp = exp * 10 + (yytext[i] - '0');
                                     i++;
                                 }
@@ -1198,7 +1198,7 @@ YY_DECL {
 #line 366 "lexer/SysY_lexer.l"
                 {
                     cur_col_number = col_number;
-                    col_number += strlen(yytext);
+                    col_number += yyleng;
                     yylval.error_msg = yytext;
                     return ERROR;
                 }
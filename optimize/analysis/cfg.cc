@@ -1,29 +1,199 @@
 #include "../../include/Instruction.h"
 #include "../../include/ir.h"
+#include <algorithm>
 #include <assert.h>
-#include <deque>
 #include <map>
+#include <set>
 #include <stack>
 #include <vector>
 
-void LLVMIR::CFGInit() {
+void LLVMIR::CFGInit(bool simplify) {
     for (auto &[defI, bb_map] : function_block_map) {
         CFG *cfg = new CFG();
         cfg->block_map = &bb_map;
         cfg->function_def = defI;
-        cfg->BuildCFG();
+        if (simplify) {
+            cfg->BuildCFG();
+        } else {
+            cfg->BuildEdges();
+        }
         // TODO("init your members in class CFG if you need");
         llvm_cfg[defI] = cfg;
         cfg->max_reg = def_reg[defI];
     }
 }
 
+static bool IsTerminator(Instruction I) {
+    int opcode = I->GetOpcode();
+    return opcode == BasicInstruction::BR_COND || opcode == BasicInstruction::BR_UNCOND ||
+           opcode == BasicInstruction::RET;
+}
+
+bool LLVMIR::CheckBlocks(FuncDefInstruction I, std::string &error) {
+    auto &blocks = function_block_map[I];
+    if (!blocks.count(0)) {
+        error = "function " + I->GetFunctionName() + " has no entry block L0";
+        return false;
+    }
+    auto fail = [&](int id, const char *what) {
+        error = "block L" + std::to_string(id) + " of function " + I->GetFunctionName() + " " + what;
+        return false;
+    };
+    auto is_reg = [](Operand op) { return op != nullptr && op->GetOperandType() == BasicOperand::REG; };
+    auto is_kind = [](Operand op, BasicOperand::operand_type kind) {
+        return op != nullptr && op->GetOperandType() == kind;
+    };
+    // 指令选择只接受这些实参形式: i32为寄存器或整数立即数, float为寄存器或浮点立即数, ptr为寄存器或全局变量;
+    // llvm.memset由指令选择单独处理, 其实参固定为(ptr 寄存器, i8 立即数, i32 寄存器或立即数, i1 立即数)
+    auto valid_args = [&](CallInstruction *call) {
+        auto args = call->GetParameterList();
+        if (call->GetFunctionName() == "llvm.memset.p0.i32") {
+            return args.size() == 4 && args[0].first == BasicInstruction::PTR && is_reg(args[0].second) &&
+                   args[1].first == BasicInstruction::I8 && is_kind(args[1].second, BasicOperand::IMMI32) &&
+                   args[2].first == BasicInstruction::I32 &&
+                   (is_reg(args[2].second) || is_kind(args[2].second, BasicOperand::IMMI32)) &&
+                   args[3].first == BasicInstruction::I1 && is_kind(args[3].second, BasicOperand::IMMI32);
+        }
+        for (auto &[type, op] : args) {
+            bool ok = is_reg(op);
+            if (type == BasicInstruction::I32) {
+                ok = ok || is_kind(op, BasicOperand::IMMI32);
+            } else if (type == BasicInstruction::FLOAT32) {
+                ok = ok || is_kind(op, BasicOperand::IMMF32);
+            } else if (type == BasicInstruction::PTR) {
+                ok = ok || is_kind(op, BasicOperand::GLOBAL);
+            } else {
+                ok = false;
+            }
+            if (!ok) {
+                return false;
+            }
+        }
+        return true;
+    };
+    // 中端和后端依赖的中间代码生成的约定: 结果都是寄存器, load/store的地址为寄存器或全局变量,
+    // store的值总是寄存器(常量先用add c,0存入寄存器), 条件跳转的条件为比较指令的结果
+    std::set<Operand> cmp_results;
+    std::set<int> defined_regs;
+    for (auto formal : I->formals_reg) {
+        defined_regs.insert(((RegOperand *)formal)->GetRegNo());
+    }
+    for (auto &[id, bb] : blocks) {
+        for (auto ins : bb->Instruction_list) {
+            int opcode = ins->GetOpcode();
+            if (opcode == BasicInstruction::STORE || opcode == BasicInstruction::LOAD) {
+                Operand ptr = opcode == BasicInstruction::STORE ? ((StoreInstruction *)ins)->GetPointer()
+                                                                : ((LoadInstruction *)ins)->GetPointer();
+                if (!is_reg(ptr) && ptr->GetOperandType() != BasicOperand::GLOBAL) {
+                    return fail(id, "accesses memory through a non-pointer operand");
+                }
+                if (opcode == BasicInstruction::STORE && !is_reg(((StoreInstruction *)ins)->GetValue())) {
+                    return fail(id, "stores a non-register value");
+                }
+            }
+            if (opcode != BasicInstruction::STORE && ins->GetModified() != nullptr && !is_reg(ins->GetModified())) {
+                return fail(id, "defines a non-register result");
+            }
+            if (opcode == BasicInstruction::CALL && !valid_args((CallInstruction *)ins)) {
+                return fail(id, "calls with an argument the back end cannot pass");
+            }
+            if (opcode == BasicInstruction::ICMP || opcode == BasicInstruction::FCMP) {
+                cmp_results.insert(ins->GetModified());
+            }
+            if (opcode != BasicInstruction::STORE && ins->GetModified() != nullptr) {
+                defined_regs.insert(((RegOperand *)ins->GetModified())->GetRegNo());
+            }
+        }
+    }
+    // 使用的寄存器必须是形参或函数内某条指令的结果. 前端会生成 %r37 = icmp eq i32 %r37,0 这样使用自身结果的指令,
+    // 所以这里不检查定义是否支配使用, 只拒绝从未定义的寄存器
+    for (auto &[id, bb] : blocks) {
+        for (auto ins : bb->Instruction_list) {
+            std::vector<Operand> uses;
+            if (ins->GetOpcode() == BasicInstruction::CALL) {
+                // memset的GetUses只返回指针, 长度也可能是寄存器
+                for (auto &[type, op] : ((CallInstruction *)ins)->GetParameterList()) {
+                    uses.push_back(op);
+                }
+            } else {
+                uses = ins->GetUses();
+                if (ins->GetOpcode() == BasicInstruction::STORE) {
+                    uses.push_back(((StoreInstruction *)ins)->GetPointer());
+                }
+            }
+            for (auto op : uses) {
+                if (is_reg(op) && !defined_regs.count(((RegOperand *)op)->GetRegNo())) {
+                    return fail(id, "uses an undefined register");
+                }
+            }
+        }
+    }
+    // 跳转目标必须是label操作数, 并且对应的基本块存在
+    auto missing = [&](Operand label) {
+        return label == nullptr || label->GetOperandType() != BasicOperand::LABEL ||
+               !blocks.count(((LabelOperand *)label)->GetLabelNo());
+    };
+    auto label_no = [](Operand label) { return ((LabelOperand *)label)->GetLabelNo(); };
+    std::map<int, std::vector<int>> succ;
+    for (auto &[id, bb] : blocks) {
+        if (bb->Instruction_list.empty() || !IsTerminator(bb->Instruction_list.back())) {
+            return fail(id, "does not end with br/ret");
+        }
+        auto term = bb->Instruction_list.back();
+        if (term->GetOpcode() == BasicInstruction::BR_COND) {
+            auto br = (BrCondInstruction *)term;
+            if (!cmp_results.count(br->GetCond())) {
+                return fail(id, "branches on a value that is not a comparison result");
+            }
+            if (missing(br->GetTrueLabel()) || missing(br->GetFalseLabel())) {
+                return fail(id, "branches to an unknown label");
+            }
+            succ[id] = {label_no(br->GetTrueLabel()), label_no(br->GetFalseLabel())};
+        } else if (term->GetOpcode() == BasicInstruction::BR_UNCOND) {
+            auto dst = ((BrUncondInstruction *)term)->GetDestLabel();
+            if (missing(dst)) {
+                return fail(id, "branches to an unknown label");
+            }
+            succ[id] = {label_no(dst)};
+        }
+    }
+    // 不建立控制流图时不会删除不可达基本块, 而支配树等分析要求所有基本块都从L0可达
+    std::set<int> visited{0};
+    std::stack<int> work;
+    work.push(0);
+    while (!work.empty()) {
+        int id = work.top();
+        work.pop();
+        for (int dst : succ[id]) {
+            if (visited.insert(dst).second) {
+                work.push(dst);
+            }
+        }
+    }
+    for (auto &[id, bb] : blocks) {
+        if (!visited.count(id)) {
+            return fail(id, "is unreachable from L0");
+        }
+    }
+    return true;
+}
+
 void LLVMIR::BuildCFG() {
     for (auto [defI, cfg] : llvm_cfg) {
         cfg->BuildCFG();
     }
 }
 
+void LLVMIR::ReleaseFunction(FuncDefInstruction I) {
+    auto it = llvm_cfg.find(I);
+    if (it != llvm_cfg.end() && it->second != nullptr) {
+        it->second->G.clear();
+        it->second->invG.clear();
+    }
+    function_block_map[I].clear();
+    function_arena[I].Release();
+}
+
 void CFG::BuildCFG() {
     // TODO("BuildCFG");
     // 标记那些块是可达的
@@ -49,13 +219,13 @@ void CFG::BuildCFG() {
         auto bb = st.top();
         st.pop();
         auto label = bb->block_id;
-        auto ins_list = bb->Instruction_list;
+        auto &ins_list = bb->Instruction_list;
         if (reachable[label] != -1) {
             continue;
         }
-        rev_ord.insert(rev_ord.begin(), label);
         int i = 0;
-        for (auto &ins : ins_list) {
+        Instruction term = nullptr;
+        for (auto ins : ins_list) {
             if (ins->GetOpcode() == BasicInstruction::LLVMIROpcode::BR_COND) {
                 BrCondInstruction *br_ins = dynamic_cast<BrCondInstruction *>(ins);
                 auto true_label = dynamic_cast<LabelOperand *>(br_ins->GetTrueLabel())->GetLabelNo();
@@ -94,6 +264,7 @@ void CFG::BuildCFG() {
                     st.push((*block_map)[false_label]);
                 }
 
+                term = ins;
                 break;
 
             } else if (ins->GetOpcode() == BasicInstruction::LLVMIROpcode::BR_UNCOND) {
@@ -103,29 +274,30 @@ void CFG::BuildCFG() {
                 auto next_bb = (*block_map)[next_label];
                 st.push(next_bb);
 
+                term = ins;
                 break;
             } else if (ins->GetOpcode() == BasicInstruction::LLVMIROpcode::RET) {
+                term = ins;
                 break;
             }
             i++;
         }
 
         reachable[label] = i;
-        // 新的指令数组, i 位置为跳转/返回指令在指令数组中的位置
-        auto new_list = std::deque<Instruction>(ins_list.begin(), ins_list.begin() + i + 1);
-        bb->Instruction_list = new_list;
+        // 删除跳转/返回指令之后的不可达指令, 此后跳转/返回指令为基本块的最后一条指令
+        while (ins_list.back() != term) {
+            ins_list.pop_back();
+        }
         new_map[new_label] = bb;
         old2new[label] = new_label++;
     }
 
-    G.clear();
-    invG.clear();
-    G.resize(new_label);
-    invG.resize(new_label);
+    // 先收集所有边, 再一次性建立压缩邻接表
+    std::vector<std::pair<int, LLVMBlock>> edges, inv_edges;
 
     // 删除了一些只有无条件跳转指令的基本块，减少了 label 数量，为了减少内存开销，遍历所有跳转指令重新分配 label 编号
     for (auto &[lb, bb] : new_map) {
-        auto &ins = bb->Instruction_list[reachable[bb->block_id]];
+        auto ins = bb->Instruction_list.back();
         bb->block_id = lb;
         if (ins->GetOpcode() == BasicInstruction::LLVMIROpcode::BR_COND) {
             BrCondInstruction *br_ins = dynamic_cast<BrCondInstruction *>(ins);
@@ -137,13 +309,13 @@ void CFG::BuildCFG() {
             br_ins->SetFalseLabel(GetNewLabelOperand(new_false));
 
             if (old_true == old_false) {
-                G[lb].push_back((*block_map)[old_true]);
-                invG[new_true].push_back(bb);
+                edges.push_back({lb, (*block_map)[old_true]});
+                inv_edges.push_back({new_true, bb});
             } else {
-                G[lb].push_back((*block_map)[old_true]);
-                G[lb].push_back((*block_map)[old_false]);
-                invG[new_true].push_back(bb);
-                invG[new_false].push_back(bb);
+                edges.push_back({lb, (*block_map)[old_true]});
+                edges.push_back({lb, (*block_map)[old_false]});
+                inv_edges.push_back({new_true, bb});
+                inv_edges.push_back({new_false, bb});
             }
 
         } else if (ins->GetOpcode() == BasicInstruction::LLVMIROpcode::BR_UNCOND) {
@@ -152,25 +324,177 @@ void CFG::BuildCFG() {
             auto new_dst = old2new[old_dst];
             br_ins->SetDstLabel(GetNewLabelOperand(new_dst));
 
-            G[lb].push_back((*block_map)[old_dst]);
-            invG[new_dst].push_back(bb);
+            edges.push_back({lb, (*block_map)[old_dst]});
+            inv_edges.push_back({new_dst, bb});
         }
     }
 
+    G.Build(new_label, edges);
+    invG.Build(new_label, inv_edges);
+
     // 将新的 label-bb 映射表赋值给 cfg
     *block_map = new_map;
     this->max_label = new_label - 1;
+    order_valid = false;
+}
 
-    // 更新逆序图
-    for (auto &i : rev_ord) {
-        i = old2new[i];
+void CFG::BuildEdges() {
+    std::vector<std::pair<int, LLVMBlock>> edges, inv_edges;
+    max_label = block_map->empty() ? -1 : block_map->rbegin()->first;
+    // 边的顺序与BuildCFG相同: 条件跳转先真分支后假分支
+    auto add = [&](LLVMBlock bb, Operand label) {
+        int dst = ((LabelOperand *)label)->GetLabelNo();
+        edges.push_back({bb->block_id, (*block_map)[dst]});
+        inv_edges.push_back({dst, bb});
+    };
+    for (auto &[lb, bb] : *block_map) {
+        auto ins = bb->Instruction_list.back();
+        if (ins->GetOpcode() == BasicInstruction::LLVMIROpcode::BR_COND) {
+            auto br_ins = (BrCondInstruction *)ins;
+            add(bb, br_ins->GetTrueLabel());
+            if (br_ins->GetFalseLabel() != br_ins->GetTrueLabel()) {
+                add(bb, br_ins->GetFalseLabel());
+            }
+        } else if (ins->GetOpcode() == BasicInstruction::LLVMIROpcode::BR_UNCOND) {
+            add(bb, ((BrUncondInstruction *)ins)->GetDestLabel());
+        }
     }
+    G.Build(max_label + 1, edges);
+    invG.Build(max_label + 1, inv_edges);
+    order_valid = false;
+}
+
+std::span<const LLVMBlock> CFG::GetPredecessor(LLVMBlock B) { return invG[B->block_id]; }
+
+std::span<const LLVMBlock> CFG::GetPredecessor(int bbid) { return invG[bbid]; }
+
+std::span<const LLVMBlock> CFG::GetSuccessor(LLVMBlock B) { return G[B->block_id]; }
+
+std::span<const LLVMBlock> CFG::GetSuccessor(int bbid) { return G[bbid]; }
+
+void CFG::AddEdge(int from, int to) {
+    // 新加入的基本块在两个图中都需要有对应的节点
+    G.Resize(std::max(from, to) + 1);
+    invG.Resize(std::max(from, to) + 1);
+    // 两端的基本块都必须已经存在, at在label不存在时抛出异常, 而不是插入空的基本块
+    G.AddEdge(from, block_map->at(to));
+    invG.AddEdge(to, block_map->at(from));
+    order_valid = false;
 }
 
-std::vector<LLVMBlock> CFG::GetPredecessor(LLVMBlock B) { return invG[B->block_id]; }
+void CFG::RemoveEdge(int from, int to) {
+    G.RemoveEdge(from, block_map->at(to));
+    invG.RemoveEdge(to, block_map->at(from));
+    order_valid = false;
+}
 
-std::vector<LLVMBlock> CFG::GetPredecessor(int bbid) { return invG[bbid]; }
+void CFG::Reverse() {
+    std::swap(G, invG);
+    order_valid = false;
+}
 
-std::vector<LLVMBlock> CFG::GetSuccessor(LLVMBlock B) { return G[B->block_id]; }
+const std::vector<int> &CFG::GetReversePostOrder() {
+    if (!order_valid) {
+        ComputeOrder();
+    }
+    return rev_ord;
+}
 
-std::vector<LLVMBlock> CFG::GetSuccessor(int bbid) { return G[bbid]; }
\ No newline at end of file
+const std::vector<int> &CFG::GetPostOrder() {
+    if (!order_valid) {
+        ComputeOrder();
+    }
+    return post_ord;
+}
+
+void CFG::ComputeOrder() {
+    // 迭代 DFS 求后序, 逆后序由后序反转得到
+    int n = G.size();
+    post_ord.clear();
+    rev_ord.clear();
+    if (n > 0) {
+        std::vector<char> visited(n, 0);
+        std::vector<std::pair<int, size_t>> st;
+        st.push_back({0, 0});
+        visited[0] = 1;
+        while (!st.empty()) {
+            auto &[u, next] = st.back();
+            auto succs = G[u];
+            if (next < succs.size()) {
+                int v = succs[next++]->block_id;
+                if (!visited[v]) {
+                    visited[v] = 1;
+                    st.push_back({v, 0});
+                }
+            } else {
+                post_ord.push_back(u);
+                st.pop_back();
+            }
+        }
+        rev_ord.assign(post_ord.rbegin(), post_ord.rend());
+    }
+    order_valid = true;
+}
+
+void BlockGraph::Build(int n, const std::vector<std::pair<int, LLVMBlock>> &edge_list) {
+    // 计数排序: 先统计每个起点的出边数得到区间起始位置, 再按原顺序填入
+    start.assign(n, 0);
+    count.assign(n, 0);
+    for (auto &[u, v] : edge_list) {
+        count[u]++;
+    }
+    int offset = 0;
+    for (int u = 0; u < n; u++) {
+        start[u] = offset;
+        offset += count[u];
+    }
+    capacity = count;
+    edges.assign(offset, nullptr);
+    std::vector<int> pos(start);
+    for (auto &[u, v] : edge_list) {
+        edges[pos[u]++] = v;
+    }
+}
+
+void BlockGraph::Resize(int n) {
+    if (n > (int)size()) {
+        start.resize(n, edges.size());
+        count.resize(n, 0);
+        capacity.resize(n, 0);
+    }
+}
+
+void BlockGraph::AddEdge(int u, LLVMBlock v) {
+    Resize(u + 1);
+    if (count[u] == capacity[u]) {
+        int new_start = edges.size();
+        int new_capacity = std::max(2 * capacity[u], 2);
+        edges.resize(new_start + new_capacity, nullptr);
+        std::copy(edges.begin() + start[u], edges.begin() + start[u] + count[u], edges.begin() + new_start);
+        start[u] = new_start;
+        capacity[u] = new_capacity;
+    }
+    edges[start[u] + count[u]++] = v;
+}
+
+bool BlockGraph::RemoveEdge(int u, LLVMBlock v) {
+    if (u >= (int)size()) {
+        return false;
+    }
+    auto first = edges.begin() + start[u];
+    auto last = first + count[u];
+    auto it = std::find(first, last, v);
+    if (it == last) {
+        return false;
+    }
+    std::copy(it + 1, last, it);
+    count[u]--;
+    return true;
+}
+
+void BlockGraph::clear() {
+    edges.clear();
+    start.clear();
+    count.clear();
+    capacity.clear();
+}
@@ -1,18 +1,106 @@
 #include "def_use.h"
 #include "../../include/ir.h"
 
-/*
-伪代码:
-for BasicBlock bb in C
-    for Instruction I in bb
-        if I 有结果寄存器
-            int regno = I->GetResultRegNo()
-            IRDefMaps[C][regno] = I
-*/
-void DefUseAnalysis::GetDefUseInSingleCFG(CFG *C) { TODO("GetDefUseInSingleCFG"); }
+// 指令I读取的寄存器编号, 需要与ReplaceRegByMap会改写的操作数一致
+// GetUses不包含store的地址和memset除第一个参数以外的参数, 这里需要补上
+static void GetUseRegs(Instruction I, std::vector<int> &regs) {
+    regs.clear();
+    std::vector<Operand> uses;
+    if (I->GetOpcode() == BasicInstruction::LLVMIROpcode::CALL) {
+        for (auto &arg : ((CallInstruction *)I)->GetParameterList()) {
+            uses.push_back(arg.second);
+        }
+    } else {
+        uses = I->GetUses();
+        if (I->GetOpcode() == BasicInstruction::LLVMIROpcode::STORE) {
+            uses.push_back(I->GetModified());
+        }
+    }
+    for (auto op : uses) {
+        if (op != nullptr && op->GetOperandType() == BasicOperand::REG) {
+            regs.push_back(((RegOperand *)op)->GetRegNo());
+        }
+    }
+}
+
+// 指令I定义的寄存器编号, 没有则返回-1(store的GetModified是地址, 不是定义)
+static int GetDefReg(Instruction I) {
+    if (I->GetOpcode() == BasicInstruction::LLVMIROpcode::STORE) {
+        return -1;
+    }
+    auto def = I->GetModified();
+    if (def == nullptr || def->GetOperandType() != BasicOperand::REG) {
+        return -1;
+    }
+    return ((RegOperand *)def)->GetRegNo();
+}
+
+void DefUseAnalysis::GetDefUseInSingleCFG(CFG *C) {
+    IRDefMaps[C].clear();
+    auto &uses = IRUseMaps[C];
+    uses.clear();
+    uses.resize(C->max_reg + 1);
+    for (auto [id, bb] : *C->block_map) {
+        for (auto I : bb->Instruction_list) {
+            AddInstruction(C, I);
+        }
+    }
+}
+
+void DefUseAnalysis::AddInstruction(CFG *C, Instruction I) {
+    int def = GetDefReg(I);
+    if (def >= 0) {
+        IRDefMaps[C][def] = I;
+    }
+    std::vector<int> regs;
+    GetUseRegs(I, regs);
+    for (auto reg : regs) {
+        AddUse(C, reg, I);
+    }
+}
+
+void DefUseAnalysis::AddUse(CFG *C, int regno, Instruction I) {
+    auto &uses = IRUseMaps[C];
+    if (regno >= (int)uses.size()) {
+        uses.resize(regno + 1);
+    }
+    uses[regno].push_back(I);
+}
+
+void DefUseAnalysis::ReplaceAllUsesWith(CFG *C, int old_reg, int new_reg) {
+    auto &uses = IRUseMaps[C];
+    if (old_reg == new_reg || old_reg >= (int)uses.size()) {
+        return;
+    }
+    if (new_reg >= (int)uses.size()) {
+        uses.resize(new_reg + 1);
+    }
+    std::vector<Instruction> old_uses;
+    old_uses.swap(uses[old_reg]);
+    std::map<int, int> rule{{old_reg, new_reg}};
+    for (auto I : old_uses) {
+        // 跳过已经被删除的指令
+        if (I->GetParent() == nullptr) {
+            continue;
+        }
+        I->ReplaceRegByMap(rule);
+        uses[new_reg].push_back(I);
+    }
+}
+
+void DefUseAnalysis::Release(CFG *C) {
+    IRDefMaps.erase(C);
+    IRUseMaps.erase(C);
+}
+
+const std::vector<Instruction> &DefUseAnalysis::GetUseList(CFG *C, int regno) {
+    static const std::vector<Instruction> empty;
+    auto &uses = IRUseMaps[C];
+    return regno < (int)uses.size() ? uses[regno] : empty;
+}
 
 void DefUseAnalysis::Execute() {
     for (auto [defI, cfg] : llvmIR->llvm_cfg) {
         GetDefUseInSingleCFG(cfg);
     }
-}
\ No newline at end of file
+}
@@ -5,20 +5,39 @@
 #include <set>
 #include <vector>
 
+/*
+    def-use链: 对每个函数记录寄存器的定义指令和使用该寄存器的指令列表
+    寄存器操作数是全局复用的(不同函数中的%r1是同一个RegOperand对象), 因此使用列表按函数保存, 以寄存器编号为下标
+    指令从基本块中删除后不需要立即从使用列表中移除, 遍历使用列表时会跳过已经不在基本块中的指令
+*/
 class DefUseAnalysis : public IRPass {
 private:
-    void GetDefUseInSingleCFG(CFG *C);
-
     //<key1:CFG*, value1:
     //      <key2: 寄存器编号, value2: 定义该寄存器的指令 > >
     std::map<CFG *, std::map<int, Instruction>> IRDefMaps;
 
-    // 添加更多的成员变量和函数来完成def-use分析
+    //<key1:CFG*, value1: 以寄存器编号为下标, 使用该寄存器的指令列表>
+    std::map<CFG *, std::vector<std::vector<Instruction>>> IRUseMaps;
+
 public:
     DefUseAnalysis(LLVMIR *IR) : IRPass(IR) {}
 
+    // 重新计算函数C的def-use链
+    void GetDefUseInSingleCFG(CFG *C);
+    // 将新插入函数C的指令I加入def-use链
+    void AddInstruction(CFG *C, Instruction I);
+    // 指令I新增了对寄存器regno的使用(例如phi指令新增了incoming value)
+    void AddUse(CFG *C, int regno, Instruction I);
+
+    // 将函数C中所有对old_reg的使用替换为new_reg, 只会修改使用old_reg的指令
+    // 要求old_reg的定义指令不是自身的使用者(SSA形式下通常是old_reg的定义即将被删除)
+    void ReplaceAllUsesWith(CFG *C, int old_reg, int new_reg);
+
+    // 释放函数C的def-use信息
+    void Release(CFG *C);
+
     const std::map<int, Instruction> &GetDefMap(CFG *C) { return IRDefMaps[C]; }
+    const std::vector<Instruction> &GetUseList(CFG *C, int regno);
     void Execute();
-    // TODO(): add more functions and members if you need
 };
-#endif
\ No newline at end of file
+#endif
@@ -5,92 +5,122 @@
 #include <vector>
 
 void DomAnalysis::Execute() {
+    std::vector<CFG *> cfgs;
     for (auto [defI, cfg] : llvmIR->llvm_cfg) {
-        DomInfo[cfg].C = llvmIR->llvm_cfg[defI];
-        DomInfo[cfg].BuildDominatorTree();
+        cfgs.push_back(cfg);
     }
+    Execute(cfgs);
+}
+void DomAnalysis::Execute(const std::vector<CFG *> &cfgs) {
+    // 先串行地为每个函数建立条目, 并行建树时只访问已经存在的条目
+    for (auto cfg : cfgs) {
+        DomInfo[cfg].C = cfg;
+    }
+    ForEachFunction(cfgs, [this](CFG *cfg, int worker) { DomInfo[cfg].BuildDominatorTree(); });
 }
 void DominatorTree::BuildTree() {
+    /*
+    Cooper-Harvey-Kennedy 算法 (A Simple, Fast Dominance Algorithm):
+        1. 从入口出发 DFS, 得到后序编号和逆后序
+        2. 按逆后序迭代: idom(v) = 已处理的前驱沿 idom 链求"最近公共祖先"
+           由于按逆后序处理, 一般 2~3 轮即可收敛, 且不需要 O(n^2) 的支配集合
+        3. 由 idom 建立支配树, 并记录支配树上 DFS 的进入/离开时间, 用于 O(1) 回答支配关系
+    */
+    int n = C->max_label + 1;
     idom.clear();
     dom_tree.clear();
-    dom_relation.clear();
-    idom.resize(C->max_label + 1, nullptr);
-    dom_tree.resize(C->max_label + 1);
-    // dom_relation[i] 存储支配 i 的所有节点
-    dom_relation.resize(C->max_label + 1);
+    idom.resize(n, nullptr);
+    dom_tree.resize(n);
 
-    // 建立支配关系: dom[i][j] = 1 表示 i 被 j 支配
-    /*
-    迭代数据流:
-        初始化 dom 数组:
-        第 0 行: dom[0][0] = 1, 其他全为 0
-        其他   : 全为 1
-    */
-    dom.clear();
-    dom.resize(C->max_label + 1);
-    for (int v : C->rev_ord) {
-        dom[v] = std::vector<bool>(C->max_label + 1, true);
+    // 迭代 DFS 求后序, 避免长函数上递归过深
+    std::vector<int> po_num(n, -1);
+    std::vector<int> rpo;
+    std::vector<char> visited(n, 0);
+    std::vector<std::pair<int, size_t>> st;
+    rpo.reserve(n);
+    st.push_back({0, 0});
+    visited[0] = 1;
+    while (!st.empty()) {
+        auto &[u, next] = st.back();
+        if (next < C->G[u].size()) {
+            int v = C->G[u][next++]->block_id;
+            if (!visited[v]) {
+                visited[v] = 1;
+                st.push_back({v, 0});
+            }
+        } else {
+            po_num[u] = rpo.size();
+            rpo.push_back(u);
+            st.pop_back();
+        }
     }
-    dom[0] = std::vector<bool>(C->max_label + 1, false);
-    dom[0][0] = true;
-    bool flag = true;
-    auto ord = C->rev_ord;
-    std::reverse(ord.begin(), ord.end());
-    // 将每个结点上的支配点集不断迭代直至答案不变即可
-    while (flag) {
-        flag = false;
-        for (int v : ord) {
+    std::reverse(rpo.begin(), rpo.end());
+
+    std::vector<int> idom_id(n, -1);
+    idom_id[0] = 0;
+    // 沿 idom 链向上, 直到两个节点汇合, 后序编号越大越靠近入口
+    auto intersect = [&](int a, int b) {
+        while (a != b) {
+            while (po_num[a] < po_num[b]) {
+                a = idom_id[a];
+            }
+            while (po_num[b] < po_num[a]) {
+                b = idom_id[b];
+            }
+        }
+        return a;
+    };
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (int v : rpo) {
             if (v == 0) {
                 continue;
             }
-            auto tmp = dom[v];
-            // 一个点的支配点的点集为它所有前驱结点的支配点集的交集，再并上它本身
-            auto pres = C->GetPredecessor(v);
-            for (auto p : pres) {
-                for (int i = 0; i <= C->max_label; i++) {
-                    // 更新当前的支配关系
-                    tmp[i] = tmp[i] && dom[p->block_id][i];
+            int new_idom = -1;
+            for (auto p : C->invG[v]) {
+                int pid = p->block_id;
+                if (idom_id[pid] == -1) {
+                    // 前驱尚未处理(回边), 本轮跳过
+                    continue;
                 }
+                new_idom = (new_idom == -1) ? pid : intersect(pid, new_idom);
             }
-            tmp[v] = true;
-
-            if (dom[v] != tmp) {
-                // 支配关系发生变化，继续迭代
-                flag = true;
+            if (new_idom != idom_id[v]) {
+                idom_id[v] = new_idom;
+                changed = true;
             }
-            dom[v] = tmp;
         }
     }
-    for (int i = 1; i <= C->max_label; i++) {
-        for (int j = 0; j <= C->max_label; j++) {
-            if (dom[i][j]) {
-                // i 的所有支配节点
-                dom_relation[i].push_back(j);
-                // std::cout << i << "<-" << j << "\n";
-            }
+
+    for (int v = 0; v < n; v++) {
+        if (idom_id[v] == -1) {
+            continue;
+        }
+        idom[v] = (*C->block_map)[idom_id[v]];
+        if (v != 0) {
+            dom_tree[idom_id[v]].push_back((*C->block_map)[v]);
         }
     }
 
-    // std::cout << "pver\n";
-
-    // 计算直接支配者
-    idom[0] = (*C->block_map)[0];
-    for (int u = 1; u <= C->max_label; u++) {
-        int imm = -1;
-        for (int v : dom_relation[u]) {
-            if (v == u)
-                continue;
-            if (imm == -1) {
-                imm = v;
-            } else if (dom_relation[imm].end() == std::find(dom_relation[imm].begin(), dom_relation[imm].end(), v)) {
-                // 如果 v 被 imm 支配: imm -> .. -> v -> .. -> u, 更新 imm
-                imm = v;
-            }
+    // 支配树上的 DFS 时间戳
+    dfs_in.assign(n, -1);
+    dfs_out.assign(n, -1);
+    int clock = 0;
+    st.clear();
+    st.push_back({0, 0});
+    dfs_in[0] = clock++;
+    while (!st.empty()) {
+        auto &[u, next] = st.back();
+        if (next < dom_tree[u].size()) {
+            int v = dom_tree[u][next++]->block_id;
+            dfs_in[v] = clock++;
+            st.push_back({v, 0});
+        } else {
+            dfs_out[u] = clock++;
+            st.pop_back();
         }
-
-        // std::cout << imm << "\n";
-        idom[u] = (*C->block_map)[imm];
-        // std::cout << idom[u]->block_id << " -> " << u << "\n";
     }
 }
 void DominatorTree::BuildDF() {
@@ -116,7 +146,7 @@ void DominatorTree::BuildDF() {
     dom_frontier.clear();
     dom_frontier.resize(C->max_label + 1);
 
-    for (int n : C->rev_ord) {
+    for (int n : C->GetReversePostOrder()) {
         auto pres = C->GetPredecessor(n);
         if (pres.size() == 0) {
             continue;
@@ -139,9 +169,7 @@ void DominatorTree::BuildDF() {
 void DominatorTree::BuildDominatorTree(bool reverse) {
     // TODO("BuildDominatorTree");
     if (reverse) {
-        auto tmp = C->G;
-        C->G = C->invG;
-        C->invG = tmp;
+        C->Reverse();
     }
     BuildTree();
     BuildDF();
@@ -156,12 +184,15 @@ std::set<int> DominatorTree::GetDF(std::set<int> S) {
     return res;
 }
 
-std::set<int> DominatorTree::GetDF(int id) {
+const std::set<int> &DominatorTree::GetDF(int id) {
     // TODO("GetDF");
     return dom_frontier[id];
 }
 
 bool DominatorTree::IsDominate(int id1, int id2) {
     // TODO("IsDominate");
-    return dom[id2][id1];
+    if (dfs_in[id1] == -1 || dfs_in[id2] == -1) {
+        return false;
+    }
+    return dfs_in[id1] <= dfs_in[id2] && dfs_out[id2] <= dfs_out[id1];
 }
@@ -13,7 +13,7 @@ public:
 
     void BuildDominatorTree(bool reverse = false);    // build the dominator tree of CFG* C
     std::set<int> GetDF(std::set<int> S);             // return DF(S)  S = {id1,id2,id3,...}
-    std::set<int> GetDF(int id);                      // return DF(id)
+    const std::set<int> &GetDF(int id);               // return DF(id)
     bool IsDominate(int id1, int id2);                // if blockid1 dominate blockid2, return true, else return false
 
     // TODO(): add or modify functions and members if you need
@@ -26,8 +26,10 @@ public:
     void BuildCDG();
 
     std::vector<std::set<int>> dom_frontier{};
-    std::vector<std::vector<bool>> dom{};
-    std::vector<std::vector<int>> dom_relation{};
+
+    // 支配树上 DFS 的进入/离开时间戳, a 支配 b 当且仅当 b 的区间嵌套在 a 的区间内
+    std::vector<int> dfs_in{};
+    std::vector<int> dfs_out{};
 };
 
 class DomAnalysis : public IRPass {
@@ -37,6 +39,8 @@ private:
 public:
     DomAnalysis(LLVMIR *IR) : IRPass(IR) {}
     void Execute();
+    // 只重新建立cfgs中函数的支配树, 用于控制流图修改后的增量更新
+    void Execute(const std::vector<CFG *> &cfgs);
     DominatorTree *GetDomTree(CFG *C) { return &DomInfo[C]; }
     // TODO(): add more functions and members if you need
 };
@@ -1,14 +1,39 @@
 #ifndef PASS_H
 #define PASS_H
 #include "../include/ir.h"
+#include "../include/parallel.h"
+#include "../include/time_report.h"
+#include <vector>
 
 class IRPass {
 protected:
     LLVMIR *llvmIR;
 
+    // 执行函数级pass使用的线程数, 通过 -j N 指定
+    inline static int jobs = 1;
+
+    // 对每个函数执行body(cfg, worker), 不同函数可能由不同线程并行处理, worker为线程编号(0 <= worker < jobs)
+    // body只能修改该函数自身的数据, 需要的临时状态应按worker分开保存
+    template <class Body> void ForEachFunction(Body body) {
+        std::vector<CFG *> cfgs;
+        for (auto [defI, cfg] : llvmIR->llvm_cfg) {
+            cfgs.push_back(cfg);
+        }
+        ForEachFunction(cfgs, body);
+    }
+    // 只对cfgs中的函数执行body
+    template <class Body> void ForEachFunction(const std::vector<CFG *> &cfgs, Body body) {
+        WorkStealingExecutor(jobs).Run(cfgs.size(), [&](size_t i, int worker) {
+            TimeReport::FunctionScope timer(time_report, cfgs[i]->function_def->GetFunctionName());
+            body(cfgs[i], worker);
+        });
+    }
+
 public:
     virtual void Execute() = 0;
     IRPass(LLVMIR *IR) { llvmIR = IR; }
+    static void SetJobs(int n) { jobs = n; }
+    static int GetJobs() { return jobs; }
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,117 @@
+#include "pass_manager.h"
+#include "../include/parallel.h"
+#include "../include/time_report.h"
+#include "transform/mem2reg.h"
+#include "transform/simplify_cfg.h"
+
+// 所有可以通过 -passes= 使用的pass, 添加新的pass时在这里注册
+static const PassInfo PassRegistry[] = {
+{"simplifycfg", "SimplifyCFG", ANALYSIS_CFG, ANALYSIS_ALL,
+ [](LLVMIR *IR, AnalysisManager &am) { SimplifyCFGPass(IR).Execute(); }},
+// mem2reg插入phi并删除alloca/load/store, 不修改跳转指令, 因此控制流图和支配树仍然有效
+{"mem2reg", "Mem2Reg", ANALYSIS_CFG | ANALYSIS_DOM, ANALYSIS_ALL,
+ [](LLVMIR *IR, AnalysisManager &am) { Mem2RegPass(IR, am.GetDomAnalysis()).Execute(); }},
+};
+
+AnalysisManager::AnalysisManager(LLVMIR *IR) : llvmIR(IR), dom(IR) {
+    for (auto [defI, cfg] : llvmIR->llvm_cfg) {
+        valid[cfg] = ANALYSIS_CFG;
+    }
+}
+
+void AnalysisManager::Require(unsigned analyses) {
+    // 按依赖顺序计算: 支配树依赖控制流图
+    if (analyses & ANALYSIS_DOM) {
+        analyses |= ANALYSIS_CFG;
+    }
+    auto stale = [&](AnalysisKind kind) {
+        std::vector<CFG *> cfgs;
+        for (auto [defI, cfg] : llvmIR->llvm_cfg) {
+            if (!(valid[cfg] & kind)) {
+                cfgs.push_back(cfg);
+            }
+        }
+        return cfgs;
+    };
+    if (analyses & ANALYSIS_CFG) {
+        auto cfgs = stale(ANALYSIS_CFG);
+        if (!cfgs.empty()) {
+            TimeReport::Scope timer(time_report, "BuildCFG");
+            WorkStealingExecutor(IRPass::GetJobs()).Run(cfgs.size(), [&](size_t i, int worker) {
+                cfgs[i]->BuildCFG();
+            });
+            for (auto cfg : cfgs) {
+                valid[cfg] |= ANALYSIS_CFG;
+            }
+        }
+    }
+    if (analyses & ANALYSIS_DOM) {
+        auto cfgs = stale(ANALYSIS_DOM);
+        if (!cfgs.empty()) {
+            TimeReport::Scope timer(time_report, "DomAnalysis");
+            dom.Execute(cfgs);
+            for (auto cfg : cfgs) {
+                valid[cfg] |= ANALYSIS_DOM;
+            }
+        }
+    }
+}
+
+void AnalysisManager::Invalidate(CFG *C, unsigned analyses) {
+    if (analyses & ANALYSIS_CFG) {
+        analyses |= ANALYSIS_DOM;
+    }
+    valid[C] &= ~analyses;
+}
+
+void AnalysisManager::InvalidateAllExcept(unsigned preserved) {
+    for (auto [defI, cfg] : llvmIR->llvm_cfg) {
+        Invalidate(cfg, ~preserved & ANALYSIS_ALL);
+    }
+}
+
+bool PassManager::Parse(std::string_view passes, std::string &unknown) {
+    pipeline.clear();
+    while (!passes.empty()) {
+        size_t comma = passes.find(',');
+        std::string_view name = passes.substr(0, comma);
+        passes = comma == std::string_view::npos ? std::string_view() : passes.substr(comma + 1);
+        if (name.empty()) {
+            continue;
+        }
+        const PassInfo *found = nullptr;
+        for (auto &info : PassRegistry) {
+            if (name == info.name) {
+                found = &info;
+            }
+        }
+        if (found == nullptr) {
+            unknown = name;
+            return false;
+        }
+        pipeline.push_back(found);
+    }
+    return true;
+}
+
+void PassManager::Run() {
+    for (auto info : pipeline) {
+        analyses.Require(info->required);
+        {
+            TimeReport::Scope timer(time_report, info->stage);
+            info->run(llvmIR, analyses);
+        }
+        analyses.InvalidateAllExcept(info->preserved);
+    }
+}
+
+std::string PassManager::AvailablePasses() {
+    std::string names;
+    for (auto &info : PassRegistry) {
+        if (!names.empty()) {
+            names += ",";
+        }
+        names += info.name;
+    }
+    return names;
+}
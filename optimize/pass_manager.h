@@ -0,0 +1,87 @@
+#ifndef PASS_MANAGER_H
+#define PASS_MANAGER_H
+#include "../include/ir.h"
+#include "analysis/dominator_tree.h"
+#include "pass.h"
+#include <functional>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*
+    中端的分析结果, 以位掩码表示一组分析
+    CFG: 控制流图(G/invG, 逆后序), 由LLVMIR::CFGInit建立, 失效后对该函数重新BuildCFG
+    DOM: 支配树和支配边界
+    DOM依赖CFG, CFG失效时DOM也随之失效
+*/
+enum AnalysisKind : unsigned {
+    ANALYSIS_NONE = 0,
+    ANALYSIS_CFG = 1u << 0,
+    ANALYSIS_DOM = 1u << 1,
+    ANALYSIS_ALL = ANALYSIS_CFG | ANALYSIS_DOM,
+};
+
+/*
+    按函数缓存分析结果: 记录每个函数当前有效的分析, 只有在被需要且已经失效时才重新计算
+    分析结果在pass之间共享, 例如连续多个不修改控制流的pass只需要计算一次支配树
+*/
+class AnalysisManager {
+private:
+    LLVMIR *llvmIR;
+    DomAnalysis dom;
+    // key: 函数的CFG, value: 该函数当前有效的分析
+    std::map<CFG *, unsigned> valid{};
+
+public:
+    // 构造时认为所有函数的CFG已经由CFGInit建立
+    AnalysisManager(LLVMIR *IR);
+
+    // 保证所有函数的analyses有效, 只重新计算已经失效的函数, 不同函数可以并行计算
+    void Require(unsigned analyses);
+    // 函数C的analyses失效
+    void Invalidate(CFG *C, unsigned analyses);
+    // 所有函数中除preserved以外的分析失效
+    void InvalidateAllExcept(unsigned preserved);
+
+    DomAnalysis *GetDomAnalysis() { return &dom; }
+};
+
+/*
+    中端pass: 声明执行前需要的分析(required)和执行后仍然有效的分析(preserved)
+    执行前由PassManager保证required中的分析有效, 执行后不在preserved中的分析失效
+    pass如果只修改了部分函数, 可以自行调用AnalysisManager::Invalidate, 并在preserved中声明其余分析
+*/
+struct PassInfo {
+    const char *name;
+    // -time-report中的阶段名
+    const char *stage;
+    unsigned required;
+    unsigned preserved;
+    std::function<void(LLVMIR *, AnalysisManager &)> run;
+};
+
+/*
+    由pass名组成的流水线, 通过 -passes=a,b,c 指定, 未指定时使用默认流水线
+    所有可用的pass在pass_manager.cc的PassRegistry中注册
+*/
+class PassManager {
+private:
+    LLVMIR *llvmIR;
+    AnalysisManager analyses;
+    std::vector<const PassInfo *> pipeline{};
+
+public:
+    PassManager(LLVMIR *IR) : llvmIR(IR), analyses(IR) {}
+
+    // 未开启优化时只进行消除不可达基本块等基本优化
+    static const char *DefaultPipeline(bool optimize) { return optimize ? "simplifycfg,mem2reg" : "simplifycfg"; }
+    // 解析逗号分隔的pass名, 遇到未注册的pass名时返回false, 并将其写入unknown
+    bool Parse(std::string_view passes, std::string &unknown);
+    void Run();
+
+    // 所有已注册的pass名, 以逗号分隔
+    static std::string AvailablePasses();
+};
+
+#endif
@@ -1,15 +1,12 @@
 #include "mem2reg.h"
 #include <algorithm>
-#include <deque>
 #include <map>
 #include <set>
 #include <tuple>
 #include <utility>
+#include <memory>
 #include <vector>
 
-static std::map<PhiInstruction *, int> phi_map;
-static std::set<int> common_allocas;
-
 // 检查该条alloca指令是否可以被mem2reg
 // eg. 数组不可以mem2reg
 // eg. 如果该指针直接被使用不可以mem2reg(在SysY一般不可能发生,SysY不支持指针语法)
@@ -28,13 +25,13 @@ void Mem2RegPass::IsPromotable(CFG *C, Instruction AllocaInst) {
     // 遍历基本块中的指令，标记无用的alloca指令
     for (auto &block_pair : *block_list) {
         auto &inst_list = block_pair.second->Instruction_list;
-        for (auto &inst : inst_list) {
+        for (auto inst : inst_list) {
             // 如果指令是alloca并且没有被使用
             if (inst->GetOpcode() == BasicInstruction::LLVMIROpcode::ALLOCA) {
                 bool is_used = false;
 
                 // 检查是否有load指令使用了该alloca分配的内存
-                for (auto &use_inst : inst_list) {
+                for (auto use_inst : inst_list) {
                     if (use_inst->GetOpcode() == BasicInstruction::LLVMIROpcode::LOAD) {
                         // 如果该alloca被加载，则认为它被使用过
                         is_used = true;
@@ -50,20 +47,9 @@ void Mem2RegPass::IsPromotable(CFG *C, Instruction AllocaInst) {
         }
     }
 
-    // 创建新的指令列表，仅保留未被标记删除的指令
-    for (auto &block_pair : *block_list) {
-        auto &inst_list = block_pair.second->Instruction_list;
-        std::deque<Instruction> new_inst_list;
-
-        for (auto &inst : inst_list) {
-            if (allocas_to_delete.find(inst) == allocas_to_delete.end()) {
-                // 只有没有被删除的指令才加入新的列表
-                new_inst_list.push_back(inst);
-            }
-        }
-
-        // 更新基本块的指令列表
-        block_pair.second->Instruction_list = new_inst_list;
+    // 从所在基本块中删除被标记的指令
+    for (auto inst : allocas_to_delete) {
+        inst->GetParent()->Instruction_list.erase(inst);
     }
 }
 
@@ -93,7 +79,7 @@ pseudo IR is:
 
 // vset is the set of alloca regno that only store but not load
 // 该函数对你的时间复杂度有一定要求, 你需要保证你的时间复杂度小于等于O(nlognlogn), n为该函数的指令数
-// 提示:deque直接在中间删除是O(n)的, 可以先标记要删除的指令, 最后想一个快速的方法统一删除
+// 提示:先标记要删除的指令, 最后统一从指令链表中删除, 每条指令的删除是O(1)的
 
 void Mem2RegPass::Mem2RegNoUseAlloca(CFG *C, std::set<int> &vset) {
     std::vector<int> allocas;
@@ -131,19 +117,16 @@ void Mem2RegPass::Mem2RegNoUseAlloca(CFG *C, std::set<int> &vset) {
         }
     }
 
-    std::map<int, std::set<int>> needDel;
-    int index = -1;
+    std::unordered_set<Instruction> needDel;
     for (auto [id, bb] : (*C->block_map)) {
-        index = -1;
         for (auto ins : bb->Instruction_list) {
-            index++;
             if (ins->GetOpcode() == BasicInstruction::LLVMIROpcode::ALLOCA) {
                 auto alloc_ins = (AllocaInstruction *)ins;
                 auto op = alloc_ins->GetResult();
                 if (alloc_ins->GetDims().size() == 0 && op && op->GetOperandType() == BasicOperand::REG) {
                     auto reg = ((RegOperand *)op)->GetRegNo();
                     if (used_alloc[reg] == false) {
-                        needDel[id].insert(index);
+                        needDel.insert(ins);
                     }
                 }
             }
@@ -154,7 +137,7 @@ void Mem2RegPass::Mem2RegNoUseAlloca(CFG *C, std::set<int> &vset) {
                     auto target_reg = ((RegOperand *)op)->GetRegNo();
                     if (std::find(allocas.begin(), allocas.end(), target_reg) != allocas.end()) {
                         if (used_alloc[target_reg] == false) {
-                            needDel[id].insert(index);
+                            needDel.insert(ins);
                         }
                     }
                 }
@@ -163,18 +146,15 @@ void Mem2RegPass::Mem2RegNoUseAlloca(CFG *C, std::set<int> &vset) {
     }
 
     // 执行删除
-    for (auto [label, dels] : needDel) {
-        for (auto it = dels.rbegin(); it != dels.rend(); ++it) {
-            auto index = *it;
-            (*C->block_map)[label]->Instruction_list.erase((*C->block_map)[label]->Instruction_list.begin() + index);
-        }
+    for (auto I : needDel) {
+        I->GetParent()->Instruction_list.erase(I);
     }
 }
 
 void Mem2RegPass::Mem2RegUseDefInSameBlock(CFG *C, std::set<int> &vset1, int block_id) {
     std::map<int, std::set<int>> defs, uses;    // 变量在哪些块中定义、变量在哪些块中使用
     std::map<int, int> def_num;                 // 变量定义次数
-    std::map<int, std::set<int>> needDel;
+    std::unordered_set<Instruction> needDel;
     std::map<int, int> replace_map;
     std::map<int, std::set<int>> allocaUseDefInSameBlock;    //<blockid,<alloca regno>>
 
@@ -197,10 +177,8 @@ void Mem2RegPass::Mem2RegUseDefInSameBlock(CFG *C, std::set<int> &vset1, int blo
         }
     }
 
-    int index = -1;
     LLVMBlock entry_BB = (*C->block_map)[0];
     for (auto I : entry_BB->Instruction_list) {
-        index++;
         if (I->GetOpcode() != BasicInstruction::LLVMIROpcode::ALLOCA) {
             continue;
         }
@@ -219,7 +197,7 @@ void Mem2RegPass::Mem2RegUseDefInSameBlock(CFG *C, std::set<int> &vset1, int blo
         if (alloca_defs.size() == 1) {
             int block_id = *(alloca_defs.begin());
             if (alloca_uses.size() == 1 && *(alloca_uses.begin()) == block_id) {
-                needDel[0].insert(index);
+                needDel.insert(I);
                 allocaUseDefInSameBlock[block_id].insert(v);
                 continue;
             }
@@ -228,9 +206,7 @@ void Mem2RegPass::Mem2RegUseDefInSameBlock(CFG *C, std::set<int> &vset1, int blo
     for (auto [id, vset] : allocaUseDefInSameBlock) {
         // 记录alloca寄存器最近被赋值的寄存器号
         std::map<int, int> curr_reg_map;
-        index = -1;
         for (auto I : (*C->block_map)[id]->Instruction_list) {
-            index++;
             if (I->GetOpcode() == BasicInstruction::LLVMIROpcode::STORE) {
                 auto StoreI = (StoreInstruction *)I;
                 if (StoreI->GetPointer()->GetOperandType() != BasicOperand::REG) {
@@ -241,7 +217,7 @@ void Mem2RegPass::Mem2RegUseDefInSameBlock(CFG *C, std::set<int> &vset1, int blo
                     continue;
                 }
                 curr_reg_map[v] = ((RegOperand *)(StoreI->GetValue()))->GetRegNo();
-                needDel[id].insert(index);
+                needDel.insert(I);
             }
             if (I->GetOpcode() == BasicInstruction::LLVMIROpcode::LOAD) {
                 auto LoadI = (LoadInstruction *)I;
@@ -253,42 +229,18 @@ void Mem2RegPass::Mem2RegUseDefInSameBlock(CFG *C, std::set<int> &vset1, int blo
                     continue;
                 }
                 replace_map[LoadI->GetResultRegNo()] = curr_reg_map[v];
-                needDel[id].insert(index);
-            }
-        }
-    }
-
-    for (auto [id, bb] : *C->block_map) {
-        for (auto I : bb->Instruction_list) {
-            if (I->GetOpcode() == BasicInstruction::LLVMIROpcode::LOAD &&
-                ((LoadInstruction *)I)->GetPointer()->GetOperandType() == BasicOperand::REG) {
-                auto LoadI = (LoadInstruction *)I;
-                int result = LoadI->GetResultRegNo();
-                if (replace_map.find(result) != replace_map.end()) {
-                    int result2 = replace_map[result];
-                    while (replace_map.find(result2) != replace_map.end()) {
-                        replace_map[result] = replace_map[result2];
-                        result2 = replace_map[result];
-                    }
-                }
+                needDel.insert(I);
             }
         }
     }
 
     // 删除指令
-    for (auto [label, dels] : needDel) {
-        for (auto it = dels.rbegin(); it != dels.rend(); ++it) {
-            auto index = *it;
-            (*C->block_map)[label]->Instruction_list.erase((*C->block_map)[label]->Instruction_list.begin() + index);
-        }
+    for (auto I : needDel) {
+        I->GetParent()->Instruction_list.erase(I);
     }
 
     // 寄存器号替换
-    for (auto [id, BB] : *C->block_map) {
-        for (auto I : BB->Instruction_list) {
-            I->ReplaceRegByMap(replace_map);    // 替换寄存器号
-        }
-    }
+    ReplaceUsesByMap(C, replace_map);
 }
 
 // vset is the set of alloca regno that one store dominators all load instructions
@@ -297,7 +249,7 @@ void Mem2RegPass::Mem2RegOneDefDomAllUses(CFG *C, std::set<int> &vset1) {
     // Step 1: Calculate defs, uses, and def_num
     std::map<int, std::set<int>> defs, uses;    // 变量在哪些块中定义、变量在哪些块中使用
     std::map<int, int> def_num;                 // 变量定义次数
-    std::map<int, std::set<int>> needDel;
+    std::unordered_set<Instruction> needDel;
     std::map<int, int> mem2reg_map;
     auto domtree = domtrees->GetDomTree(C);
 
@@ -323,9 +275,7 @@ void Mem2RegPass::Mem2RegOneDefDomAllUses(CFG *C, std::set<int> &vset1) {
     // 确定一个 store 是否支配所有 load
     std::set<int> vset;    // Set of variables to optimize
     LLVMBlock entry_BB = (*C->block_map)[0];
-    int index = -1;
     for (auto I : entry_BB->Instruction_list) {
-        index++;
         if (I->GetOpcode() != BasicInstruction::LLVMIROpcode::ALLOCA) {
             continue;
         }
@@ -350,7 +300,7 @@ void Mem2RegPass::Mem2RegOneDefDomAllUses(CFG *C, std::set<int> &vset1) {
                 }
             }
             if (dom_flag) {    // one def dominate all uses
-                needDel[0].insert(index);
+                needDel.insert(I);
 
                 vset.insert(v);
                 continue;
@@ -361,9 +311,7 @@ void Mem2RegPass::Mem2RegOneDefDomAllUses(CFG *C, std::set<int> &vset1) {
     // 执行寄存器替换
     std::map<int, int> v_result_map;    // 变量最后一个store对应的value的寄存器号
     for (auto [id, BB] : *C->block_map) {
-        index = -1;
         for (auto I : BB->Instruction_list) {
-            index++;
             if (I->GetOpcode() == BasicInstruction::LLVMIROpcode::STORE) {
                 auto StoreI = (StoreInstruction *)I;
                 if (StoreI->GetPointer()->GetOperandType() != BasicOperand::REG) {
@@ -374,15 +322,13 @@ void Mem2RegPass::Mem2RegOneDefDomAllUses(CFG *C, std::set<int> &vset1) {
                     continue;
                 }
                 v_result_map[v] = ((RegOperand *)(StoreI->GetValue()))->GetRegNo();
-                needDel[id].insert(index);
+                needDel.insert(I);
             }
         }
     }
 
     for (auto [id, BB] : *C->block_map) {
-        index = -1;
         for (auto I : BB->Instruction_list) {
-            index++;
             if (I->GetOpcode() == BasicInstruction::LLVMIROpcode::LOAD) {
                 auto LoadI = (LoadInstruction *)I;
                 if (LoadI->GetPointer()->GetOperandType() != BasicOperand::REG) {
@@ -394,46 +340,18 @@ void Mem2RegPass::Mem2RegOneDefDomAllUses(CFG *C, std::set<int> &vset1) {
                     continue;
                 }
                 mem2reg_map[LoadI->GetResultRegNo()] = v_result_map[v];
-                needDel[id].insert(index);
-            }
-        }
-    }
-
-    // 处理 LOAD 指令的间接映射
-    for (auto [id, bb] : *C->block_map) {
-        for (auto I : bb->Instruction_list) {
-            if (I->GetOpcode() == BasicInstruction::LLVMIROpcode::LOAD &&
-                ((LoadInstruction *)I)->GetPointer()->GetOperandType() == BasicOperand::REG) {
-                int result = ((LoadInstruction *)I)->GetResultRegNo();
-
-                // 检查目标寄存器是否在重命名映射中
-                if (mem2reg_map.find(result) != mem2reg_map.end()) {
-                    int result2 = mem2reg_map[result];    // 获取目标寄存器的映射
-
-                    // 处理间接映射：如果映射的寄存器本身也有映射，递归找到最终的寄存器编号
-                    while (mem2reg_map.find(result2) != mem2reg_map.end()) {
-                        mem2reg_map[result] = mem2reg_map[result2];
-                        result2 = mem2reg_map[result];
-                    }
-                }
+                needDel.insert(I);
             }
         }
     }
 
     // 删除指令
-    for (auto [label, dels] : needDel) {
-        for (auto it = dels.rbegin(); it != dels.rend(); ++it) {
-            auto index = *it;
-            (*C->block_map)[label]->Instruction_list.erase((*C->block_map)[label]->Instruction_list.begin() + index);
-        }
+    for (auto I : needDel) {
+        I->GetParent()->Instruction_list.erase(I);
     }
 
     // 寄存器号替换
-    for (auto B1 : *C->block_map) {
-        for (auto I : B1.second->Instruction_list) {
-            I->ReplaceRegByMap(mem2reg_map);
-        }
-    }
+    ReplaceUsesByMap(C, mem2reg_map);
 
     mem2reg_map.clear();
 }
@@ -508,8 +426,10 @@ void Mem2RegPass::InsertPhi(CFG *C) {
                     for (auto Y : domtree->GetDF(X)) {
                         if (std::find(F.begin(), F.end(), Y) == F.end()) {
                             // 如果该支配边界没有插入 phi 则插入
-                            auto phi = new PhiInstruction(type, GetNewRegOperand(++C->max_reg));
+                            auto phi =
+                            llvmIR->GetArena(C->function_def).New<PhiInstruction>(type, GetNewRegOperand(++C->max_reg));
                             (*C->block_map)[Y]->InsertInstruction(0, phi);
+                            defuse.AddInstruction(C, phi);
                             phi_map[phi] = reg_no;
                             F.insert(Y);
                             if (std::find(defs_id[reg_no].begin(), defs_id[reg_no].end(), Y) == defs_id[reg_no].end()) {
@@ -525,7 +445,7 @@ void Mem2RegPass::InsertPhi(CFG *C) {
 }
 
 // 辅助函数: 判断 load/store 指令是否指向 alloca 的 reg
-int pointer2allocas(Instruction ins) {
+int Mem2RegPass::pointer2allocas(Instruction ins) {
     if (ins->GetOpcode() == BasicInstruction::LLVMIROpcode::LOAD ||
         ins->GetOpcode() == BasicInstruction::LLVMIROpcode::STORE) {
         Operand pointer;
@@ -559,10 +479,9 @@ void Mem2RegPass::VarRename(CFG *C) {
     // 标记基本块是否已访问
     std::vector<int> BBvis(C->max_label + 1, 0);
 
-    std::map<int, std::set<int>> needDel;
+    std::unordered_set<Instruction> needDel;
     std::map<int, int> mem2reg_map;
     BBvis.resize(C->max_label + 1);
-    int index = -1;
     while (!WorkList.empty()) {
         int BB = (*WorkList.begin()).first;
         auto IncomingVals = (*WorkList.begin()).second;
@@ -572,16 +491,14 @@ void Mem2RegPass::VarRename(CFG *C) {
         }
         // BBvis[BB] = 1;
         if (wait_proc.find(BB) != wait_proc.end()) {
-            index = -1;
-            for (auto &I : (*C->block_map)[BB]->Instruction_list) {
-                index++;
+            for (auto I : (*C->block_map)[BB]->Instruction_list) {
                 if (I->GetOpcode() == BasicInstruction::LLVMIROpcode::LOAD) {
                     auto LoadI = (LoadInstruction *)I;
                     int v = pointer2allocas(I);
 
                     // 如果 LOAD 指令操作的是 common_allocas 中的变量
                     if (v >= 0 && IncomingVals.find(v) != IncomingVals.end()) {
-                        needDel[BB].insert(index);    // 标记该 LOAD 指令为待删除
+                        needDel.insert(I);    // 标记该 LOAD 指令为待删除
                         mem2reg_map[LoadI->GetResultRegNo()] = IncomingVals[v];
                     } else {
                         wait_proc[BB].insert(I);
@@ -593,14 +510,14 @@ void Mem2RegPass::VarRename(CFG *C) {
                     // 如果 STORE 指令操作的是 common_allocas 中的变量
                     if (v >= 0) {
                         // 标记该 STORE 指令为待删除
-                        needDel[BB].insert(index);
+                        needDel.insert(I);
                         IncomingVals[v] = ((RegOperand *)(StoreI->GetValue()))->GetRegNo();
                     }
                 } else if (I->GetOpcode() == BasicInstruction::LLVMIROpcode::PHI) {
                     auto PhiI = (PhiInstruction *)I;
 
                     // 如果 PHI 指令已经被标记为待删除，跳过
-                    if (std::find(needDel[BB].begin(), needDel[BB].end(), index) != needDel[BB].end()) {
+                    if (needDel.find(I) != needDel.end()) {
                         continue;
                     }
                     auto it = phi_map.find(PhiI);
@@ -612,9 +529,7 @@ void Mem2RegPass::VarRename(CFG *C) {
                 }
             }
         } else {
-            index = -1;
-            for (auto &I : (*C->block_map)[BB]->Instruction_list) {
-                index++;
+            for (auto I : (*C->block_map)[BB]->Instruction_list) {
                 if (I->GetOpcode() == BasicInstruction::LLVMIROpcode::LOAD &&
                     wait_proc[BB].find(I) != wait_proc[BB].end()) {
                     auto LoadI = (LoadInstruction *)I;
@@ -623,7 +538,7 @@ void Mem2RegPass::VarRename(CFG *C) {
                     // 如果 LOAD 指令操作的是 common_allocas 中的变量
                     if (v >= 0 && IncomingVals.find(v) != IncomingVals.end()) {
                         // 标记该 LOAD 指令为待删除
-                        needDel[BB].insert(index);
+                        needDel.insert(I);
 
                         mem2reg_map[LoadI->GetResultRegNo()] = IncomingVals[v];
                         wait_proc[BB].erase(I);
@@ -645,19 +560,18 @@ void Mem2RegPass::VarRename(CFG *C) {
 
             WorkList.insert({BBv, IncomingVals});
 
-            index = -1;
             // 处理后继块中的PHI指令
             for (auto I : (*C->block_map)[BBv]->Instruction_list) {
-                index++;
                 if (I->GetOpcode() == BasicInstruction::LLVMIROpcode::PHI) {
                     auto PhiI = dynamic_cast<PhiInstruction *>(I);
                     auto it = phi_map.find(PhiI);
                     if (it != phi_map.end()) {
                         int v = it->second;
                         if (IncomingVals.find(v) == IncomingVals.end()) {
-                            needDel[BBv].insert(index);    // 删除未初始化的PHI指令
+                            needDel.insert(I);    // 删除未初始化的PHI指令
                         } else {
                             PhiI->InsertPhi(std::make_pair(GetNewLabelOperand(BB), GetNewRegOperand(IncomingVals[v])));
+                            defuse.AddUse(C, IncomingVals[v], PhiI);
                         }
                     }
                 }
@@ -665,70 +579,62 @@ void Mem2RegPass::VarRename(CFG *C) {
         }
     }
 
-    // 处理 LOAD 指令的间接映射
-    for (auto [id, bb] : *C->block_map) {
-        for (auto I : bb->Instruction_list) {
-            if (I->GetOpcode() == BasicInstruction::LLVMIROpcode::LOAD &&
-                ((LoadInstruction *)I)->GetPointer()->GetOperandType() == BasicOperand::REG) {
-                int result = ((LoadInstruction *)I)->GetResultRegNo();
-
-                // 检查目标寄存器是否在重命名映射中
-                if (mem2reg_map.find(result) != mem2reg_map.end()) {
-                    int result2 = mem2reg_map[result];    // 获取目标寄存器的映射
-
-                    // 处理间接映射：如果映射的寄存器本身也有映射，递归找到最终的寄存器编号
-                    while (mem2reg_map.find(result2) != mem2reg_map.end()) {
-                        mem2reg_map[result] = mem2reg_map[result2];
-                        result2 = mem2reg_map[result];
-                    }
-                }
-            }
-        }
-    }
-
     // for (auto [a,b]:mem2reg_map)
     //{std::cout<<"("<<a<<","<<b<<")   ";}
 
     // 删除待删除的指令
-    for (auto [label, dels] : needDel) {
-        for (auto it = dels.rbegin(); it != dels.rend(); ++it) {
-            auto index = *it;
-            (*C->block_map)[label]->Instruction_list.erase((*C->block_map)[label]->Instruction_list.begin() + index);
-        }
+    for (auto I : needDel) {
+        I->GetParent()->Instruction_list.erase(I);
     }
 
     // 替换指令中寄存器编号
-    for (auto B1 : *C->block_map) {
-        for (auto I : B1.second->Instruction_list) {
-            I->ReplaceRegByMap(mem2reg_map);
-        }
-    }
+    ReplaceUsesByMap(C, mem2reg_map);
 
     mem2reg_map.clear();
     phi_map.clear();
     common_allocas.clear();
 }
 
+// 按replace_map替换寄存器: 映射可能是链式的(load的结果被映射到另一个load的结果), 先找到链上最终的寄存器,
+// 再通过def-use链只修改使用了被替换寄存器的指令, 不需要遍历整个函数
+void Mem2RegPass::ReplaceUsesByMap(CFG *C, std::map<int, int> &replace_map) {
+    for (auto &[reg, target] : replace_map) {
+        for (auto it = replace_map.find(target); it != replace_map.end(); it = replace_map.find(target)) {
+            target = it->second;
+        }
+        defuse.ReplaceAllUsesWith(C, reg, target);
+    }
+}
+
 void Mem2RegPass::Mem2Reg(CFG *C) {
     InsertPhi(C);
     // VarRename(C);
 }
 
-void Mem2RegPass::Execute() {
+void Mem2RegPass::ExecuteInFunc(CFG *cfg) {
     int a;
-    for (auto [defI, cfg] : llvmIR->llvm_cfg) {
-        DCE(cfg);
-        std::set<int> vset;
-        Mem2RegNoUseAlloca(cfg, vset);
-        Mem2RegOneDefDomAllUses(cfg, vset);
-        Mem2RegUseDefInSameBlock(cfg, vset, a);
-        Mem2RegOneDefDomAllUses(cfg, vset);
-        Mem2RegNoUseAlloca(cfg, vset);
-        Mem2Reg(cfg);
-        VarRename(cfg);
-        Mem2RegNoUseAlloca(cfg, vset);
-        DCE(cfg);
+    defuse.GetDefUseInSingleCFG(cfg);
+    DCE(cfg);
+    std::set<int> vset;
+    Mem2RegNoUseAlloca(cfg, vset);
+    Mem2RegOneDefDomAllUses(cfg, vset);
+    Mem2RegUseDefInSameBlock(cfg, vset, a);
+    Mem2RegOneDefDomAllUses(cfg, vset);
+    Mem2RegNoUseAlloca(cfg, vset);
+    Mem2Reg(cfg);
+    VarRename(cfg);
+    Mem2RegNoUseAlloca(cfg, vset);
+    DCE(cfg);
+    defuse.Release(cfg);
+}
+
+void Mem2RegPass::Execute() {
+    // 处理一个函数时的临时状态都保存在Mem2RegPass对象中, 因此每个线程使用各自的对象
+    std::vector<std::unique_ptr<Mem2RegPass>> workers;
+    for (int i = 0; i < jobs; ++i) {
+        workers.push_back(std::make_unique<Mem2RegPass>(llvmIR, domtrees));
     }
+    ForEachFunction([&](CFG *cfg, int worker) { workers[worker]->ExecuteInFunc(cfg); });
 }
 
 // 辅助函数: 计算 varUsed, varDefines, vars
@@ -737,10 +643,7 @@ void Mem2RegPass::FindDefsAndUses_DCE(CFG *c) {
     varDefines.clear();
     vars.clear();
 
-    // offset 是指令在块内的下标
-    int offset = 0;
     for (auto [id, bb] : *c->block_map) {
-        offset = 0;
         for (auto ins : bb->Instruction_list) {
             if (ins->GetOpcode() == BasicInstruction::LLVMIROpcode::GETELEMENTPTR) {
                 auto gep = ins->GetModified();
@@ -751,7 +654,7 @@ void Mem2RegPass::FindDefsAndUses_DCE(CFG *c) {
             // Modified: 该指令修改的变量
             auto Modified = ins->GetModified();
             if (Modified) {
-                varDefines[Modified].push_back(std::make_pair(id, offset));
+                varDefines[Modified].push_back(ins);
                 vars.insert(Modified);
             }
 
@@ -763,7 +666,6 @@ void Mem2RegPass::FindDefsAndUses_DCE(CFG *c) {
                     vars.insert(op);
                 }
             }
-            offset++;
         }
     }
 }
@@ -775,8 +677,8 @@ int arr[..][..];
 */
 void Mem2RegPass::DCE(CFG *c) {
     FindDefsAndUses_DCE(c);
-    // 需要删除的指令表 key:label, value:块中需要删除的指令下标
-    std::map<int, std::set<int>> needDel;
+    // 需要删除的指令
+    std::unordered_set<Instruction> needDel;
     // 初始化 worklist 为所有Alloca声明的变量
     auto workList = vars;
     while (!workList.empty()) {
@@ -785,10 +687,9 @@ void Mem2RegPass::DCE(CFG *c) {
         workList.erase(workList.begin());
         // 如果 var 没有被使用
         if (varUsed[var].empty()) {
-            auto defines = varDefines[var];
-            for (auto def : defines) {
-                // ins 是对 var 赋值的指令
-                auto ins = (*c->block_map)[def.first]->Instruction_list[def.second];
+            auto &defines = varDefines[var];
+            // ins 是对 var 赋值的指令
+            for (auto ins : defines) {
                 if (ins->GetOpcode() == BasicInstruction::LLVMIROpcode::BR_COND ||
                     ins->GetOpcode() == BasicInstruction::LLVMIROpcode::BR_UNCOND ||
                     ins->GetOpcode() == BasicInstruction::LLVMIROpcode::RET ||
@@ -798,7 +699,7 @@ void Mem2RegPass::DCE(CFG *c) {
                     continue;
                 }
                 // 删除 ins
-                needDel[def.first].insert(def.second);
+                needDel.insert(ins);
                 for (auto x : ins->GetUses()) {
                     // 从 x 的使用列表中删除 ins
                     if (varUsed[x].find(ins) != varUsed[x].end()) {
@@ -811,11 +712,7 @@ void Mem2RegPass::DCE(CFG *c) {
         }
     }
     // 执行删除
-    for (auto [label, dels] : needDel) {
-        for (auto it = dels.rbegin(); it != dels.rend(); ++it) {
-            auto index = *it;
-            // std::cout << label << " " << index << "\n";
-            (*c->block_map)[label]->Instruction_list.erase((*c->block_map)[label]->Instruction_list.begin() + index);
-        }
+    for (auto I : needDel) {
+        I->GetParent()->Instruction_list.erase(I);
     }
 }
\ No newline at end of file
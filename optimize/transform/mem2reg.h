@@ -3,6 +3,7 @@
 #include "../../include/ir.h"
 #include "../pass.h"
 
+#include "../analysis/def_use.h"
 #include "../analysis/dominator_tree.h"
 #include <map>
 #include <set>
@@ -14,6 +15,7 @@
 class Mem2RegPass : public IRPass {
 private:
     DomAnalysis *domtrees;
+    DefUseAnalysis defuse;
     // TODO():添加更多你需要的成员变量
     void IsPromotable(CFG *C, Instruction AllocaInst);
     void Mem2RegNoUseAlloca(CFG *C, std::set<int> &vset);
@@ -23,6 +25,7 @@ private:
     void InsertPhi(CFG *C);
     void VarRename(CFG *C);
     void Mem2Reg(CFG *C);
+    void ReplaceUsesByMap(CFG *C, std::map<int, int> &replace_map);
 
     // 添加的成员函数
     void FindDefs(CFG *c);
@@ -34,14 +37,21 @@ private:
     std::map<int, std::map<int, int>> var2defs;
     // key: 变量, value: 使用该变量的指令集合
     std::map<Operand, std::set<Instruction>> varUsed;
-    // key: 变量, value: 定义该变量的指令(pair.first: label, pair.second: 块内的指令位置)
-    std::map<Operand, std::vector<std::pair<int, int>>> varDefines;
+    // key: 变量, value: 定义该变量的指令
+    std::map<Operand, std::vector<Instruction>> varDefines;
     // 变量集合
     std::set<Operand> vars;
 
+    // key: InsertPhi插入的phi指令, value: 该phi对应的变量(alloca的寄存器)
+    std::map<PhiInstruction *, int> phi_map;
+    // 可以提升为寄存器的变量(非数组alloca的寄存器)
+    std::set<int> common_allocas;
+    int pointer2allocas(Instruction ins);
+
 public:
-    Mem2RegPass(LLVMIR *IR, DomAnalysis *dom) : IRPass(IR) { domtrees = dom; }
+    Mem2RegPass(LLVMIR *IR, DomAnalysis *dom) : IRPass(IR), defuse(IR) { domtrees = dom; }
     void Execute();
+    void ExecuteInFunc(CFG *cfg);
     void DCE_Execute();
     void DCE(CFG *c);
 };
@@ -4,9 +4,7 @@
 #include <vector>
 
 void SimplifyCFGPass::Execute() {
-    for (auto [defI, cfg] : llvmIR->llvm_cfg) {
-        EliminateUnreachedBlocksInsts(cfg);
-    }
+    ForEachFunction([this](CFG *cfg, int worker) { EliminateUnreachedBlocksInsts(cfg); });
 }
 
 // 删除从函数入口开始到达不了的基本块和指令
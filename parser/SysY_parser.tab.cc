@@ -70,6 +70,7 @@
 #include "type.h"
 #include <fstream>
 Program ast_root;
+Arena ast_arena;
 
 void yyerror(char *s, ...);
 int yylex();
@@ -1243,7 +1244,7 @@ yyreduce:
 #line 69 "parser/SysY_parser.y"
     {
         (yyloc) = (yylsp[0]);
-        ast_root = new __Program((yyvsp[0].comps));
+        ast_root = ast_arena.New<__Program>((yyvsp[0].comps));
         ast_root->SetLineNumber(line_number);
     }
 #line 1433 "SysY_parser.tab.c"
@@ -1252,7 +1253,7 @@ yyreduce:
     case 3: /* Comp_list: CompUnit  */
 #line 77 "parser/SysY_parser.y"
     {
-        (yyval.comps) = new std::vector<CompUnit>;
+        (yyval.comps) = ast_arena.New<std::vector<CompUnit>>();
         ((yyval.comps))->push_back((yyvsp[0].comp_unit));
     }
 #line 1442 "SysY_parser.tab.c"
@@ -1270,7 +1271,7 @@ yyreduce:
     case 5: /* CompUnit: Decl  */
 #line 88 "parser/SysY_parser.y"
     {
-        (yyval.comp_unit) = new CompUnit_Decl((yyvsp[0].decl));
+        (yyval.comp_unit) = ast_arena.New<CompUnit_Decl>((yyvsp[0].decl));
         (yyval.comp_unit)->SetLineNumber(line_number);
     }
 #line 1460 "SysY_parser.tab.c"
@@ -1279,7 +1280,7 @@ yyreduce:
     case 6: /* CompUnit: FuncDef  */
 #line 92 "parser/SysY_parser.y"
     {
-        (yyval.comp_unit) = new CompUnit_FuncDef((yyvsp[0].func_def));
+        (yyval.comp_unit) = ast_arena.New<CompUnit_FuncDef>((yyvsp[0].func_def));
         (yyval.comp_unit)->SetLineNumber(line_number);
     }
 #line 1469 "SysY_parser.tab.c"
@@ -1306,7 +1307,7 @@ yyreduce:
     case 9: /* VarDecl: INT VarDef_list ';'  */
 #line 110 "parser/SysY_parser.y"
     {
-        (yyval.decl) = new VarDecl(Type::INT, (yyvsp[-1].defs));
+        (yyval.decl) = ast_arena.New<VarDecl>(Type::INT, (yyvsp[-1].defs));
         (yyval.decl)->SetLineNumber(line_number);
     }
 #line 1496 "SysY_parser.tab.c"
@@ -1315,7 +1316,7 @@ yyreduce:
     case 10: /* VarDecl: FLOAT VarDef_list ';'  */
 #line 118 "parser/SysY_parser.y"
     {
-        (yyval.decl) = new VarDecl(Type::FLOAT, (yyvsp[-1].defs));
+        (yyval.decl) = ast_arena.New<VarDecl>(Type::FLOAT, (yyvsp[-1].defs));
         (yyval.decl)->SetLineNumber(line_number);
     }
 #line 1505 "SysY_parser.tab.c"
@@ -1324,7 +1325,7 @@ yyreduce:
     case 11: /* ConstDecl: CONST INT ConstDef_list ';'  */
 #line 125 "parser/SysY_parser.y"
     {
-        (yyval.decl) = new ConstDecl(Type::INT, (yyvsp[-1].defs));
+        (yyval.decl) = ast_arena.New<ConstDecl>(Type::INT, (yyvsp[-1].defs));
         (yyval.decl)->SetLineNumber(line_number);
     }
 #line 1514 "SysY_parser.tab.c"
@@ -1333,7 +1334,7 @@ yyreduce:
     case 12: /* ConstDecl: CONST FLOAT ConstDef_list ';'  */
 #line 133 "parser/SysY_parser.y"
     {
-        (yyval.decl) = new ConstDecl(Type::FLOAT, (yyvsp[-1].defs));
+        (yyval.decl) = ast_arena.New<ConstDecl>(Type::FLOAT, (yyvsp[-1].defs));
         (yyval.decl)->SetLineNumber(line_number);
     }
 #line 1523 "SysY_parser.tab.c"
@@ -1342,7 +1343,7 @@ yyreduce:
     case 13: /* VarDef_list: VarDef  */
 #line 140 "parser/SysY_parser.y"
     {
-        (yyval.defs) = new std::vector<Def>;
+        (yyval.defs) = ast_arena.New<std::vector<Def>>();
         ((yyval.defs))->push_back((yyvsp[0].def));
     }
 #line 1532 "SysY_parser.tab.c"
@@ -1360,7 +1361,7 @@ yyreduce:
     case 15: /* ConstDef_list: ConstDef  */
 #line 151 "parser/SysY_parser.y"
     {
-        (yyval.defs) = new std::vector<Def>;
+        (yyval.defs) = ast_arena.New<std::vector<Def>>();
         ((yyval.defs))->push_back((yyvsp[0].def));
     }
 #line 1550 "SysY_parser.tab.c"
@@ -1378,7 +1379,8 @@ yyreduce:
     case 17: /* FuncDef: INT IDENT '(' FuncFParams ')' Block  */
 #line 163 "parser/SysY_parser.y"
     {
-        (yyval.func_def) = new __FuncDef(Type::INT, (yyvsp[-4].symbol_token), (yyvsp[-2].formals), (yyvsp[0].block));
+        (yyval.func_def) = ast_arena.New<__FuncDef>(Type::INT, (yyvsp[-4].symbol_token), (yyvsp[-2].formals),
+                                                    (yyvsp[0].block));
         (yyval.func_def)->SetLineNumber(line_number);
     }
 #line 1568 "SysY_parser.tab.c"
@@ -1387,8 +1389,8 @@ yyreduce:
     case 18: /* FuncDef: INT IDENT '(' ')' Block  */
 #line 168 "parser/SysY_parser.y"
     {
-        (yyval.func_def) =
-        new __FuncDef(Type::INT, (yyvsp[-3].symbol_token), new std::vector<FuncFParam>(), (yyvsp[0].block));
+        (yyval.func_def) = ast_arena.New<__FuncDef>(Type::INT, (yyvsp[-3].symbol_token),
+                                                    ast_arena.New<std::vector<FuncFParam>>(), (yyvsp[0].block));
         (yyval.func_def)->SetLineNumber(line_number);
     }
 #line 1577 "SysY_parser.tab.c"
@@ -1398,7 +1400,8 @@ yyreduce:
 #line 176 "parser/SysY_parser.y"
     {
         // float 返回类型
-        (yyval.func_def) = new __FuncDef(Type::FLOAT, (yyvsp[-4].symbol_token), (yyvsp[-2].formals), (yyvsp[0].block));
+        (yyval.func_def) = ast_arena.New<__FuncDef>(Type::FLOAT, (yyvsp[-4].symbol_token), (yyvsp[-2].formals),
+                                                    (yyvsp[0].block));
         (yyval.func_def)->SetLineNumber(line_number);
     }
 #line 1587 "SysY_parser.tab.c"
@@ -1407,8 +1410,8 @@ yyreduce:
     case 20: /* FuncDef: FLOAT IDENT '(' ')' Block  */
 #line 182 "parser/SysY_parser.y"
     {
-        (yyval.func_def) =
-        new __FuncDef(Type::FLOAT, (yyvsp[-3].symbol_token), new std::vector<FuncFParam>(), (yyvsp[0].block));
+        (yyval.func_def) = ast_arena.New<__FuncDef>(Type::FLOAT, (yyvsp[-3].symbol_token),
+                                                    ast_arena.New<std::vector<FuncFParam>>(), (yyvsp[0].block));
         (yyval.func_def)->SetLineNumber(line_number);
     }
 #line 1596 "SysY_parser.tab.c"
@@ -1418,7 +1421,8 @@ yyreduce:
 #line 187 "parser/SysY_parser.y"
     {
         // void 返回类型
-        (yyval.func_def) = new __FuncDef(Type::VOID, (yyvsp[-4].symbol_token), (yyvsp[-2].formals), (yyvsp[0].block));
+        (yyval.func_def) = ast_arena.New<__FuncDef>(Type::VOID, (yyvsp[-4].symbol_token), (yyvsp[-2].formals),
+                                                    (yyvsp[0].block));
         (yyval.func_def)->SetLineNumber(line_number);
     }
 #line 1606 "SysY_parser.tab.c"
@@ -1427,8 +1431,8 @@ yyreduce:
     case 22: /* FuncDef: NONE_TYPE IDENT '(' ')' Block  */
 #line 193 "parser/SysY_parser.y"
     {
-        (yyval.func_def) =
-        new __FuncDef(Type::VOID, (yyvsp[-3].symbol_token), new std::vector<FuncFParam>(), (yyvsp[0].block));
+        (yyval.func_def) = ast_arena.New<__FuncDef>(Type::VOID, (yyvsp[-3].symbol_token),
+                                                    ast_arena.New<std::vector<FuncFParam>>(), (yyvsp[0].block));
         (yyval.func_def)->SetLineNumber(line_number);
     }
 #line 1615 "SysY_parser.tab.c"
@@ -1437,7 +1441,7 @@ yyreduce:
     case 23: /* VarDef: IDENT '=' VarInitVal  */
 #line 200 "parser/SysY_parser.y"
     {
-        (yyval.def) = new VarDef((yyvsp[-2].symbol_token), nullptr, (yyvsp[0].initval));
+        (yyval.def) = ast_arena.New<VarDef>((yyvsp[-2].symbol_token), nullptr, (yyvsp[0].initval));
         (yyval.def)->SetLineNumber(line_number);
     }
 #line 1621 "SysY_parser.tab.c"
@@ -1446,7 +1450,7 @@ yyreduce:
     case 24: /* VarDef: IDENT  */
 #line 202 "parser/SysY_parser.y"
     {
-        (yyval.def) = new VarDef_no_init((yyvsp[0].symbol_token), nullptr);
+        (yyval.def) = ast_arena.New<VarDef_no_init>((yyvsp[0].symbol_token), nullptr);
         (yyval.def)->SetLineNumber(line_number);
     }
 #line 1627 "SysY_parser.tab.c"
@@ -1455,7 +1459,7 @@ yyreduce:
     case 25: /* VarDef: IDENT ArrayDims '=' VarInitVal  */
 #line 208 "parser/SysY_parser.y"
     {
-        (yyval.def) = new VarDef((yyvsp[-3].symbol_token), (yyvsp[-2].expressions), (yyvsp[0].initval));
+        (yyval.def) = ast_arena.New<VarDef>((yyvsp[-3].symbol_token), (yyvsp[-2].expressions), (yyvsp[0].initval));
         (yyval.def)->SetLineNumber(line_number);
     }
 #line 1636 "SysY_parser.tab.c"
@@ -1464,7 +1468,7 @@ yyreduce:
     case 26: /* VarDef: IDENT ArrayDims  */
 #line 213 "parser/SysY_parser.y"
     {
-        (yyval.def) = new VarDef_no_init((yyvsp[-1].symbol_token), (yyvsp[0].expressions));
+        (yyval.def) = ast_arena.New<VarDef_no_init>((yyvsp[-1].symbol_token), (yyvsp[0].expressions));
         (yyval.def)->SetLineNumber(line_number);
     }
 #line 1645 "SysY_parser.tab.c"
@@ -1473,7 +1477,7 @@ yyreduce:
     case 27: /* ConstDef: IDENT '=' ConstInitVal  */
 #line 221 "parser/SysY_parser.y"
     {
-        (yyval.def) = new ConstDef((yyvsp[-2].symbol_token), nullptr, (yyvsp[0].initval));
+        (yyval.def) = ast_arena.New<ConstDef>((yyvsp[-2].symbol_token), nullptr, (yyvsp[0].initval));
         (yyval.def)->SetLineNumber(line_number);
     }
 #line 1654 "SysY_parser.tab.c"
@@ -1482,7 +1486,7 @@ yyreduce:
     case 28: /* ConstDef: IDENT ConstArrayDims '=' ConstInitVal  */
 #line 226 "parser/SysY_parser.y"
     {
-        (yyval.def) = new ConstDef((yyvsp[-3].symbol_token), (yyvsp[-2].expressions), (yyvsp[0].initval));
+        (yyval.def) = ast_arena.New<ConstDef>((yyvsp[-3].symbol_token), (yyvsp[-2].expressions), (yyvsp[0].initval));
         (yyval.def)->SetLineNumber(line_number);
     }
 #line 1663 "SysY_parser.tab.c"
@@ -1491,7 +1495,7 @@ yyreduce:
     case 29: /* ConstInitVal: ConstExp  */
 #line 235 "parser/SysY_parser.y"
     {
-        (yyval.initval) = new ConstInitVal_exp((yyvsp[0].expression));
+        (yyval.initval) = ast_arena.New<ConstInitVal_exp>((yyvsp[0].expression));
         (yyval.initval)->SetLineNumber(line_number);
     }
 #line 1672 "SysY_parser.tab.c"
@@ -1500,7 +1504,7 @@ yyreduce:
     case 30: /* ConstInitVal: '{' ConstInitVal_list '}'  */
 #line 240 "parser/SysY_parser.y"
     {
-        (yyval.initval) = new ConstInitVal((yyvsp[-1].initvals));
+        (yyval.initval) = ast_arena.New<ConstInitVal>((yyvsp[-1].initvals));
         (yyval.initval)->SetLineNumber(line_number);
     }
 #line 1681 "SysY_parser.tab.c"
@@ -1509,7 +1513,7 @@ yyreduce:
     case 31: /* ConstInitVal: '{' '}'  */
 #line 245 "parser/SysY_parser.y"
     {
-        (yyval.initval) = new ConstInitVal(new std::vector<InitVal>());
+        (yyval.initval) = ast_arena.New<ConstInitVal>(ast_arena.New<std::vector<InitVal>>());
         (yyval.initval)->SetLineNumber(line_number);
     }
 #line 1690 "SysY_parser.tab.c"
@@ -1518,7 +1522,7 @@ yyreduce:
     case 32: /* VarInitVal: Exp  */
 #line 254 "parser/SysY_parser.y"
     {
-        (yyval.initval) = new VarInitVal_exp((yyvsp[0].expression));
+        (yyval.initval) = ast_arena.New<VarInitVal_exp>((yyvsp[0].expression));
         (yyval.initval)->SetLineNumber(line_number);
     }
 #line 1699 "SysY_parser.tab.c"
@@ -1527,7 +1531,7 @@ yyreduce:
     case 33: /* VarInitVal: '{' VarInitVal_list '}'  */
 #line 259 "parser/SysY_parser.y"
     {
-        (yyval.initval) = new VarInitVal((yyvsp[-1].initvals));
+        (yyval.initval) = ast_arena.New<VarInitVal>((yyvsp[-1].initvals));
         (yyval.initval)->SetLineNumber(line_number);
     }
 #line 1708 "SysY_parser.tab.c"
@@ -1536,7 +1540,7 @@ yyreduce:
     case 34: /* VarInitVal: '{' '}'  */
 #line 264 "parser/SysY_parser.y"
     {
-        (yyval.initval) = new VarInitVal(new std::vector<InitVal>());
+        (yyval.initval) = ast_arena.New<VarInitVal>(ast_arena.New<std::vector<InitVal>>());
         (yyval.initval)->SetLineNumber(line_number);
     }
 #line 1717 "SysY_parser.tab.c"
@@ -1545,7 +1549,7 @@ yyreduce:
     case 35: /* ConstInitVal_list: ConstInitVal  */
 #line 273 "parser/SysY_parser.y"
     {
-        (yyval.initvals) = new std::vector<InitVal>;
+        (yyval.initvals) = ast_arena.New<std::vector<InitVal>>();
         ((yyval.initvals))->push_back((yyvsp[0].initval));
     }
 #line 1726 "SysY_parser.tab.c"
@@ -1563,7 +1567,7 @@ yyreduce:
     case 37: /* VarInitVal_list: VarInitVal  */
 #line 287 "parser/SysY_parser.y"
     {
-        (yyval.initvals) = new std::vector<InitVal>;
+        (yyval.initvals) = ast_arena.New<std::vector<InitVal>>();
         ((yyval.initvals))->push_back((yyvsp[0].initval));
     }
 #line 1744 "SysY_parser.tab.c"
@@ -1581,7 +1585,7 @@ yyreduce:
     case 39: /* FuncFParams: FuncFParam  */
 #line 300 "parser/SysY_parser.y"
     {
-        (yyval.formals) = new std::vector<FuncFParam>;
+        (yyval.formals) = ast_arena.New<std::vector<FuncFParam>>();
         ((yyval.formals))->push_back((yyvsp[0].formal));
     }
 #line 1762 "SysY_parser.tab.c"
@@ -1599,7 +1603,7 @@ yyreduce:
     case 41: /* FuncFParam: INT IDENT  */
 #line 311 "parser/SysY_parser.y"
     {
-        (yyval.formal) = new __FuncFParam(Type::INT, (yyvsp[0].symbol_token), nullptr);
+        (yyval.formal) = ast_arena.New<__FuncFParam>(Type::INT, (yyvsp[0].symbol_token), nullptr);
         (yyval.formal)->SetLineNumber(line_number);
     }
 #line 1780 "SysY_parser.tab.c"
@@ -1608,7 +1612,7 @@ yyreduce:
     case 42: /* FuncFParam: FLOAT IDENT  */
 #line 318 "parser/SysY_parser.y"
     {
-        (yyval.formal) = new __FuncFParam(Type::FLOAT, (yyvsp[0].symbol_token), nullptr);
+        (yyval.formal) = ast_arena.New<__FuncFParam>(Type::FLOAT, (yyvsp[0].symbol_token), nullptr);
         (yyval.formal)->SetLineNumber(line_number);
     }
 #line 1789 "SysY_parser.tab.c"
@@ -1618,7 +1622,7 @@ yyreduce:
 #line 325 "parser/SysY_parser.y"
     {
         (yyvsp[0].expressions)->insert((yyvsp[0].expressions)->begin(), nullptr);
-        (yyval.formal) = new __FuncFParam(Type::INT, (yyvsp[-3].symbol_token), (yyvsp[0].expressions));
+        (yyval.formal) = ast_arena.New<__FuncFParam>(Type::INT, (yyvsp[-3].symbol_token), (yyvsp[0].expressions));
         (yyval.formal)->SetLineNumber(line_number);
     }
 #line 1799 "SysY_parser.tab.c"
@@ -1628,7 +1632,7 @@ yyreduce:
 #line 330 "parser/SysY_parser.y"
     {
         (yyvsp[0].expressions)->insert((yyvsp[0].expressions)->begin(), nullptr);
-        (yyval.formal) = new __FuncFParam(Type::FLOAT, (yyvsp[-3].symbol_token), (yyvsp[0].expressions));
+        (yyval.formal) = ast_arena.New<__FuncFParam>(Type::FLOAT, (yyvsp[-3].symbol_token), (yyvsp[0].expressions));
         (yyval.formal)->SetLineNumber(line_number);
     }
 #line 1809 "SysY_parser.tab.c"
@@ -1637,9 +1641,9 @@ yyreduce:
     case 45: /* FuncFParam: INT IDENT '[' ']'  */
 #line 335 "parser/SysY_parser.y"
     {
-        std::vector<Expression> *temp = new std::vector<Expression>;
+        std::vector<Expression> *temp = ast_arena.New<std::vector<Expression>>();
         temp->push_back(nullptr);
-        (yyval.formal) = new __FuncFParam(Type::INT, (yyvsp[-2].symbol_token), temp);
+        (yyval.formal) = ast_arena.New<__FuncFParam>(Type::INT, (yyvsp[-2].symbol_token), temp);
         (yyval.formal)->SetLineNumber(line_number);
     }
 #line 1820 "SysY_parser.tab.c"
@@ -1648,9 +1652,9 @@ yyreduce:
     case 46: /* FuncFParam: FLOAT IDENT '[' ']'  */
 #line 341 "parser/SysY_parser.y"
     {
-        std::vector<Expression> *temp = new std::vector<Expression>;
+        std::vector<Expression> *temp = ast_arena.New<std::vector<Expression>>();
         temp->push_back(nullptr);
-        (yyval.formal) = new __FuncFParam(Type::FLOAT, (yyvsp[-2].symbol_token), temp);
+        (yyval.formal) = ast_arena.New<__FuncFParam>(Type::FLOAT, (yyvsp[-2].symbol_token), temp);
         (yyval.formal)->SetLineNumber(line_number);
     }
 #line 1831 "SysY_parser.tab.c"
@@ -1659,7 +1663,7 @@ yyreduce:
     case 47: /* Block: '{' BlockItem_list '}'  */
 #line 351 "parser/SysY_parser.y"
     {
-        (yyval.block) = new __Block((yyvsp[-1].block_items));
+        (yyval.block) = ast_arena.New<__Block>((yyvsp[-1].block_items));
         (yyval.block)->SetLineNumber(line_number);
     }
 #line 1840 "SysY_parser.tab.c"
@@ -1668,7 +1672,7 @@ yyreduce:
     case 48: /* Block: '{' '}'  */
 #line 355 "parser/SysY_parser.y"
     {
-        (yyval.block) = new __Block(new std::vector<BlockItem>);
+        (yyval.block) = ast_arena.New<__Block>(ast_arena.New<std::vector<BlockItem>>());
         (yyval.block)->SetLineNumber(line_number);
     }
 #line 1849 "SysY_parser.tab.c"
@@ -1677,7 +1681,7 @@ yyreduce:
     case 49: /* BlockItem_list: BlockItem  */
 #line 364 "parser/SysY_parser.y"
     {
-        (yyval.block_items) = new std::vector<BlockItem>;
+        (yyval.block_items) = ast_arena.New<std::vector<BlockItem>>();
         ((yyval.block_items))->push_back((yyvsp[0].block_item));
     }
 #line 1858 "SysY_parser.tab.c"
@@ -1695,7 +1699,7 @@ yyreduce:
     case 51: /* BlockItem: Decl  */
 #line 378 "parser/SysY_parser.y"
     {
-        (yyval.block_item) = new BlockItem_Decl((yyvsp[0].decl));
+        (yyval.block_item) = ast_arena.New<BlockItem_Decl>((yyvsp[0].decl));
         (yyval.block_item)->SetLineNumber(line_number);
     }
 #line 1876 "SysY_parser.tab.c"
@@ -1704,7 +1708,7 @@ yyreduce:
     case 52: /* BlockItem: Stmt  */
 #line 383 "parser/SysY_parser.y"
     {
-        (yyval.block_item) = new BlockItem_Stmt((yyvsp[0].stmt));
+        (yyval.block_item) = ast_arena.New<BlockItem_Stmt>((yyvsp[0].stmt));
         (yyval.block_item)->SetLineNumber(line_number);
     }
 #line 1885 "SysY_parser.tab.c"
@@ -1713,7 +1717,7 @@ yyreduce:
     case 53: /* Stmt: Lval '=' Exp ';'  */
 #line 392 "parser/SysY_parser.y"
     {
-        (yyval.stmt) = new assign_stmt((yyvsp[-3].expression), (yyvsp[-1].expression));
+        (yyval.stmt) = ast_arena.New<assign_stmt>((yyvsp[-3].expression), (yyvsp[-1].expression));
         (yyval.stmt)->SetLineNumber(line_number);
     }
 #line 1894 "SysY_parser.tab.c"
@@ -1722,7 +1726,7 @@ yyreduce:
     case 54: /* Stmt: Exp ';'  */
 #line 397 "parser/SysY_parser.y"
     {
-        (yyval.stmt) = new expr_stmt((yyvsp[-1].expression));
+        (yyval.stmt) = ast_arena.New<expr_stmt>((yyvsp[-1].expression));
         (yyval.stmt)->SetLineNumber(line_number);
     }
 #line 1903 "SysY_parser.tab.c"
@@ -1731,7 +1735,7 @@ yyreduce:
     case 55: /* Stmt: Block  */
 #line 402 "parser/SysY_parser.y"
     {
-        (yyval.stmt) = new block_stmt((yyvsp[0].block));
+        (yyval.stmt) = ast_arena.New<block_stmt>((yyvsp[0].block));
         (yyval.stmt)->SetLineNumber(line_number);
     }
 #line 1912 "SysY_parser.tab.c"
@@ -1740,7 +1744,7 @@ yyreduce:
     case 56: /* Stmt: ';'  */
 #line 407 "parser/SysY_parser.y"
     {
-        (yyval.stmt) = new null_stmt();
+        (yyval.stmt) = ast_arena.New<null_stmt>();
         (yyval.stmt)->SetLineNumber(line_number);
     }
 #line 1921 "SysY_parser.tab.c"
@@ -1749,7 +1753,7 @@ yyreduce:
     case 57: /* Stmt: IF '(' Cond ')' Stmt  */
 #line 412 "parser/SysY_parser.y"
     {
-        (yyval.stmt) = new if_stmt((yyvsp[-2].expression), (yyvsp[0].stmt));
+        (yyval.stmt) = ast_arena.New<if_stmt>((yyvsp[-2].expression), (yyvsp[0].stmt));
         (yyval.stmt)->SetLineNumber(line_number);
     }
 #line 1930 "SysY_parser.tab.c"
@@ -1758,7 +1762,7 @@ yyreduce:
     case 58: /* Stmt: IF '(' Cond ')' Stmt ELSE Stmt  */
 #line 417 "parser/SysY_parser.y"
     {
-        (yyval.stmt) = new ifelse_stmt((yyvsp[-4].expression), (yyvsp[-2].stmt), (yyvsp[0].stmt));
+        (yyval.stmt) = ast_arena.New<ifelse_stmt>((yyvsp[-4].expression), (yyvsp[-2].stmt), (yyvsp[0].stmt));
         (yyval.stmt)->SetLineNumber(line_number);
     }
 #line 1939 "SysY_parser.tab.c"
@@ -1767,7 +1771,7 @@ yyreduce:
     case 59: /* Stmt: WHILE '(' Cond ')' Stmt  */
 #line 422 "parser/SysY_parser.y"
     {
-        (yyval.stmt) = new while_stmt((yyvsp[-2].expression), (yyvsp[0].stmt));
+        (yyval.stmt) = ast_arena.New<while_stmt>((yyvsp[-2].expression), (yyvsp[0].stmt));
         (yyval.stmt)->SetLineNumber(line_number);
     }
 #line 1948 "SysY_parser.tab.c"
@@ -1776,7 +1780,7 @@ yyreduce:
     case 60: /* Stmt: BREAK ';'  */
 #line 427 "parser/SysY_parser.y"
     {
-        (yyval.stmt) = new break_stmt();
+        (yyval.stmt) = ast_arena.New<break_stmt>();
         (yyval.stmt)->SetLineNumber(line_number);
     }
 #line 1957 "SysY_parser.tab.c"
@@ -1785,7 +1789,7 @@ yyreduce:
     case 61: /* Stmt: CONTINUE ';'  */
 #line 432 "parser/SysY_parser.y"
     {
-        (yyval.stmt) = new continue_stmt();
+        (yyval.stmt) = ast_arena.New<continue_stmt>();
         (yyval.stmt)->SetLineNumber(line_number);
     }
 #line 1966 "SysY_parser.tab.c"
@@ -1794,7 +1798,7 @@ yyreduce:
     case 62: /* Stmt: RETURN ';'  */
 #line 437 "parser/SysY_parser.y"
     {
-        (yyval.stmt) = new return_stmt_void();
+        (yyval.stmt) = ast_arena.New<return_stmt_void>();
         (yyval.stmt)->SetLineNumber(line_number);
     }
 #line 1975 "SysY_parser.tab.c"
@@ -1803,7 +1807,7 @@ yyreduce:
     case 63: /* Stmt: RETURN Exp ';'  */
 #line 442 "parser/SysY_parser.y"
     {
-        (yyval.stmt) = new return_stmt((yyvsp[-1].expression));
+        (yyval.stmt) = ast_arena.New<return_stmt>((yyvsp[-1].expression));
         (yyval.stmt)->SetLineNumber(line_number);
     }
 #line 1984 "SysY_parser.tab.c"
@@ -1830,7 +1834,7 @@ yyreduce:
     case 66: /* Lval: IDENT  */
 #line 459 "parser/SysY_parser.y"
     {
-        (yyval.expression) = new Lval((yyvsp[0].symbol_token), nullptr);
+        (yyval.expression) = ast_arena.New<Lval>((yyvsp[0].symbol_token), nullptr);
         (yyval.expression)->SetLineNumber(line_number);
     }
 #line 2005 "SysY_parser.tab.c"
@@ -1839,7 +1843,7 @@ yyreduce:
     case 67: /* Lval: IDENT ArrayDims  */
 #line 467 "parser/SysY_parser.y"
     {
-        (yyval.expression) = new Lval((yyvsp[-1].symbol_token), (yyvsp[0].expressions));
+        (yyval.expression) = ast_arena.New<Lval>((yyvsp[-1].symbol_token), (yyvsp[0].expressions));
         (yyval.expression)->SetLineNumber(line_number);
     }
 #line 2014 "SysY_parser.tab.c"
@@ -1848,7 +1852,7 @@ yyreduce:
     case 68: /* PrimaryExp: '(' Exp ')'  */
 #line 476 "parser/SysY_parser.y"
     {
-        (yyval.expression) = new PrimaryExp_branch((yyvsp[-1].expression));
+        (yyval.expression) = ast_arena.New<PrimaryExp_branch>((yyvsp[-1].expression));
         (yyval.expression)->SetLineNumber(line_number);
     }
 #line 2023 "SysY_parser.tab.c"
@@ -1884,7 +1888,7 @@ yyreduce:
     case 72: /* IntConst: INT_CONST  */
 #line 498 "parser/SysY_parser.y"
     {
-        (yyval.expression) = new IntConst((yyvsp[0].int_token));
+        (yyval.expression) = ast_arena.New<IntConst>((yyvsp[0].int_token));
         (yyval.expression)->SetLineNumber(line_number);
     }
 #line 2059 "SysY_parser.tab.c"
@@ -1893,7 +1897,7 @@ yyreduce:
     case 73: /* FloatConst: FLOAT_CONST  */
 #line 505 "parser/SysY_parser.y"
     {
-        (yyval.expression) = new FloatConst((yyvsp[0].float_token));
+        (yyval.expression) = ast_arena.New<FloatConst>((yyvsp[0].float_token));
         (yyval.expression)->SetLineNumber(line_number);
     }
 #line 2068 "SysY_parser.tab.c"
@@ -1910,7 +1914,7 @@ yyreduce:
     case 75: /* UnaryExp: IDENT '(' FuncRParams ')'  */
 #line 513 "parser/SysY_parser.y"
     {
-        (yyval.expression) = new Func_call((yyvsp[-3].symbol_token), (yyvsp[-1].expression));
+        (yyval.expression) = ast_arena.New<Func_call>((yyvsp[-3].symbol_token), (yyvsp[-1].expression));
         (yyval.expression)->SetLineNumber(line_number);
     }
 #line 2083 "SysY_parser.tab.c"
@@ -1924,19 +1928,19 @@ yyreduce:
         // 我们在语法分析中将其替换为_sysy_starttime(line_number)
         // stoptime同理
         if ((yyvsp[-2].symbol_token)->get_string() == "starttime") {
-            auto params = new std::vector<Expression>;
-            params->push_back(new IntConst(line_number));
-            Expression temp = new FuncRParams(params);
-            (yyval.expression) = new Func_call(id_table.add_id("_sysy_starttime"), temp);
+            auto params = ast_arena.New<std::vector<Expression>>();
+            params->push_back(ast_arena.New<IntConst>(line_number));
+            Expression temp = ast_arena.New<FuncRParams>(params);
+            (yyval.expression) = ast_arena.New<Func_call>(id_table.add_id("_sysy_starttime"), temp);
             (yyval.expression)->SetLineNumber(line_number);
         } else if ((yyvsp[-2].symbol_token)->get_string() == "stoptime") {
-            auto params = new std::vector<Expression>;
-            params->push_back(new IntConst(line_number));
-            Expression temp = new FuncRParams(params);
-            (yyval.expression) = new Func_call(id_table.add_id("_sysy_stoptime"), temp);
+            auto params = ast_arena.New<std::vector<Expression>>();
+            params->push_back(ast_arena.New<IntConst>(line_number));
+            Expression temp = ast_arena.New<FuncRParams>(params);
+            (yyval.expression) = ast_arena.New<Func_call>(id_table.add_id("_sysy_stoptime"), temp);
             (yyval.expression)->SetLineNumber(line_number);
         } else {
-            (yyval.expression) = new Func_call((yyvsp[-2].symbol_token), nullptr);
+            (yyval.expression) = ast_arena.New<Func_call>((yyvsp[-2].symbol_token), nullptr);
             (yyval.expression)->SetLineNumber(line_number);
         }
     }
@@ -1946,7 +1950,7 @@ yyreduce:
     case 77: /* UnaryExp: '+' UnaryExp  */
 #line 541 "parser/SysY_parser.y"
     {
-        (yyval.expression) = new UnaryExp_plus((yyvsp[0].expression));
+        (yyval.expression) = ast_arena.New<UnaryExp_plus>((yyvsp[0].expression));
         (yyval.expression)->SetLineNumber(line_number);
     }
 #line 2121 "SysY_parser.tab.c"
@@ -1955,7 +1959,7 @@ yyreduce:
     case 78: /* UnaryExp: '-' UnaryExp  */
 #line 545 "parser/SysY_parser.y"
     {
-        (yyval.expression) = new UnaryExp_neg((yyvsp[0].expression));
+        (yyval.expression) = ast_arena.New<UnaryExp_neg>((yyvsp[0].expression));
         (yyval.expression)->SetLineNumber(line_number);
     }
 #line 2130 "SysY_parser.tab.c"
@@ -1964,7 +1968,7 @@ yyreduce:
     case 79: /* UnaryExp: '!' UnaryExp  */
 #line 549 "parser/SysY_parser.y"
     {
-        (yyval.expression) = new UnaryExp_not((yyvsp[0].expression));
+        (yyval.expression) = ast_arena.New<UnaryExp_not>((yyvsp[0].expression));
         (yyval.expression)->SetLineNumber(line_number);
     }
 #line 2139 "SysY_parser.tab.c"
@@ -1973,7 +1977,7 @@ yyreduce:
     case 80: /* FuncRParams: Exp_list  */
 #line 558 "parser/SysY_parser.y"
     {
-        (yyval.expression) = new FuncRParams((yyvsp[0].expressions));
+        (yyval.expression) = ast_arena.New<FuncRParams>((yyvsp[0].expressions));
         (yyval.expression)->SetLineNumber(line_number);
     }
 #line 2148 "SysY_parser.tab.c"
@@ -1982,7 +1986,7 @@ yyreduce:
     case 81: /* Exp_list: Exp  */
 #line 567 "parser/SysY_parser.y"
     {
-        (yyval.expressions) = new std::vector<Expression>;
+        (yyval.expressions) = ast_arena.New<std::vector<Expression>>();
         ((yyval.expressions))->push_back((yyvsp[0].expression));
     }
 #line 2157 "SysY_parser.tab.c"
@@ -2009,7 +2013,7 @@ yyreduce:
     case 84: /* MulExp: MulExp '*' UnaryExp  */
 #line 586 "parser/SysY_parser.y"
     {
-        (yyval.expression) = new MulExp_mul((yyvsp[-2].expression), (yyvsp[0].expression));
+        (yyval.expression) = ast_arena.New<MulExp_mul>((yyvsp[-2].expression), (yyvsp[0].expression));
         (yyval.expression)->SetLineNumber(line_number);
     }
 #line 2184 "SysY_parser.tab.c"
@@ -2018,7 +2022,7 @@ yyreduce:
     case 85: /* MulExp: MulExp '/' UnaryExp  */
 #line 591 "parser/SysY_parser.y"
     {
-        (yyval.expression) = new MulExp_div((yyvsp[-2].expression), (yyvsp[0].expression));
+        (yyval.expression) = ast_arena.New<MulExp_div>((yyvsp[-2].expression), (yyvsp[0].expression));
         (yyval.expression)->SetLineNumber(line_number);
     }
 #line 2193 "SysY_parser.tab.c"
@@ -2027,7 +2031,7 @@ yyreduce:
     case 86: /* MulExp: MulExp '%' UnaryExp  */
 #line 596 "parser/SysY_parser.y"
     {
-        (yyval.expression) = new MulExp_mod((yyvsp[-2].expression), (yyvsp[0].expression));
+        (yyval.expression) = ast_arena.New<MulExp_mod>((yyvsp[-2].expression), (yyvsp[0].expression));
         (yyval.expression)->SetLineNumber(line_number);
     }
 #line 2202 "SysY_parser.tab.c"
@@ -2045,7 +2049,7 @@ yyreduce:
     case 88: /* AddExp: AddExp '+' MulExp  */
 #line 607 "parser/SysY_parser.y"
     {
-        (yyval.expression) = new AddExp_plus((yyvsp[-2].expression), (yyvsp[0].expression));
+        (yyval.expression) = ast_arena.New<AddExp_plus>((yyvsp[-2].expression), (yyvsp[0].expression));
         (yyval.expression)->SetLineNumber(line_number);
     }
 #line 2220 "SysY_parser.tab.c"
@@ -2054,7 +2058,7 @@ yyreduce:
     case 89: /* AddExp: AddExp '-' MulExp  */
 #line 611 "parser/SysY_parser.y"
     {
-        (yyval.expression) = new AddExp_sub((yyvsp[-2].expression), (yyvsp[0].expression));
+        (yyval.expression) = ast_arena.New<AddExp_sub>((yyvsp[-2].expression), (yyvsp[0].expression));
         (yyval.expression)->SetLineNumber(line_number);
     }
 #line 2229 "SysY_parser.tab.c"
@@ -2072,7 +2076,7 @@ yyreduce:
     case 91: /* RelExp: RelExp '<' AddExp  */
 #line 625 "parser/SysY_parser.y"
     {
-        (yyval.expression) = new RelExp_lt((yyvsp[-2].expression), (yyvsp[0].expression));
+        (yyval.expression) = ast_arena.New<RelExp_lt>((yyvsp[-2].expression), (yyvsp[0].expression));
         (yyval.expression)->SetLineNumber(line_number);
     }
 #line 2247 "SysY_parser.tab.c"
@@ -2081,7 +2085,7 @@ yyreduce:
     case 92: /* RelExp: RelExp '>' AddExp  */
 #line 630 "parser/SysY_parser.y"
     {
-        (yyval.expression) = new RelExp_gt((yyvsp[-2].expression), (yyvsp[0].expression));
+        (yyval.expression) = ast_arena.New<RelExp_gt>((yyvsp[-2].expression), (yyvsp[0].expression));
         (yyval.expression)->SetLineNumber(line_number);
     }
 #line 2256 "SysY_parser.tab.c"
@@ -2090,7 +2094,7 @@ yyreduce:
     case 93: /* RelExp: RelExp LEQ AddExp  */
 #line 635 "parser/SysY_parser.y"
     {
-        (yyval.expression) = new RelExp_leq((yyvsp[-2].expression), (yyvsp[0].expression));
+        (yyval.expression) = ast_arena.New<RelExp_leq>((yyvsp[-2].expression), (yyvsp[0].expression));
         (yyval.expression)->SetLineNumber(line_number);
     }
 #line 2265 "SysY_parser.tab.c"
@@ -2099,7 +2103,7 @@ yyreduce:
     case 94: /* RelExp: RelExp GEQ AddExp  */
 #line 640 "parser/SysY_parser.y"
     {
-        (yyval.expression) = new RelExp_geq((yyvsp[-2].expression), (yyvsp[0].expression));
+        (yyval.expression) = ast_arena.New<RelExp_geq>((yyvsp[-2].expression), (yyvsp[0].expression));
         (yyval.expression)->SetLineNumber(line_number);
     }
 #line 2274 "SysY_parser.tab.c"
@@ -2117,7 +2121,7 @@ yyreduce:
     case 96: /* EqExp: EqExp EQ RelExp  */
 #line 654 "parser/SysY_parser.y"
     {
-        (yyval.expression) = new EqExp_eq((yyvsp[-2].expression), (yyvsp[0].expression));
+        (yyval.expression) = ast_arena.New<EqExp_eq>((yyvsp[-2].expression), (yyvsp[0].expression));
         (yyval.expression)->SetLineNumber(line_number);
     }
 #line 2292 "SysY_parser.tab.c"
@@ -2126,7 +2130,7 @@ yyreduce:
     case 97: /* EqExp: EqExp NE RelExp  */
 #line 659 "parser/SysY_parser.y"
     {
-        (yyval.expression) = new EqExp_neq((yyvsp[-2].expression), (yyvsp[0].expression));
+        (yyval.expression) = ast_arena.New<EqExp_neq>((yyvsp[-2].expression), (yyvsp[0].expression));
         (yyval.expression)->SetLineNumber(line_number);
     }
 #line 2301 "SysY_parser.tab.c"
@@ -2144,7 +2148,7 @@ yyreduce:
     case 99: /* LAndExp: LAndExp AND EqExp  */
 #line 673 "parser/SysY_parser.y"
     {
-        (yyval.expression) = new LAndExp_and((yyvsp[-2].expression), (yyvsp[0].expression));
+        (yyval.expression) = ast_arena.New<LAndExp_and>((yyvsp[-2].expression), (yyvsp[0].expression));
         (yyval.expression)->SetLineNumber(line_number);
     }
 #line 2319 "SysY_parser.tab.c"
@@ -2162,7 +2166,7 @@ yyreduce:
     case 101: /* LOrExp: LOrExp OR LAndExp  */
 #line 687 "parser/SysY_parser.y"
     {
-        (yyval.expression) = new LOrExp_or((yyvsp[-2].expression), (yyvsp[0].expression));
+        (yyval.expression) = ast_arena.New<LOrExp_or>((yyvsp[-2].expression), (yyvsp[0].expression));
         (yyval.expression)->SetLineNumber(line_number);
     }
 #line 2337 "SysY_parser.tab.c"
@@ -2189,7 +2193,7 @@ yyreduce:
     case 104: /* ArrayDims: ArrayDim  */
 #line 713 "parser/SysY_parser.y"
     {
-        (yyval.expressions) = new std::vector<Expression>;
+        (yyval.expressions) = ast_arena.New<std::vector<Expression>>();
         ((yyval.expressions))->push_back((yyvsp[0].expression));
     }
 #line 2364 "SysY_parser.tab.c"
@@ -2216,7 +2220,7 @@ yyreduce:
     case 107: /* ConstArrayDims: ConstArrayDim  */
 #line 734 "parser/SysY_parser.y"
     {
-        (yyval.expressions) = new std::vector<Expression>;
+        (yyval.expressions) = ast_arena.New<std::vector<Expression>>();
         ((yyval.expressions))->push_back((yyvsp[0].expression));
     }
 #line 2391 "SysY_parser.tab.c"
@@ -3,6 +3,7 @@
 #include "SysY_tree.h"
 #include "type.h"
 Program ast_root;
+Arena ast_arena;
 
 void yyerror(char *s, ...);
 int yylex();
@@ -68,14 +69,14 @@ Program
 :Comp_list
 {
     @$ = @1;
-    ast_root = new __Program($1);
+    ast_root = ast_arena.New<__Program>($1);
     ast_root->SetLineNumber(line_number);
 };
 
 Comp_list
 :CompUnit 
 {
-    $$ = new std::vector<CompUnit>;
+    $$ = ast_arena.New<std::vector<CompUnit>>();
     ($$)->push_back($1);
 }
 |Comp_list CompUnit
@@ -86,11 +87,11 @@ Comp_list
 
 CompUnit
 :Decl{
-    $$ = new CompUnit_Decl($1); 
+    $$ = ast_arena.New<CompUnit_Decl>($1); 
     $$->SetLineNumber(line_number);
 }
 |FuncDef{
-    $$ = new CompUnit_FuncDef($1); 
+    $$ = ast_arena.New<CompUnit_FuncDef>($1); 
     $$->SetLineNumber(line_number);
 }
 ;
@@ -108,7 +109,7 @@ Decl
 
 VarDecl
 :INT VarDef_list ';'{
-    $$ = new VarDecl(Type::INT,$2); 
+    $$ = ast_arena.New<VarDecl>(Type::INT,$2); 
     $$->SetLineNumber(line_number);
 }
 ;
@@ -116,14 +117,14 @@ VarDecl
 // TODO(): 考虑变量定义更多情况 
 VarDecl
 :FLOAT VarDef_list ';'{
-    $$ = new VarDecl(Type::FLOAT,$2);
+    $$ = ast_arena.New<VarDecl>(Type::FLOAT,$2);
     $$->SetLineNumber(line_number);
 }
 ;
 
 ConstDecl
 :CONST INT ConstDef_list ';'{
-    $$ = new ConstDecl(Type::INT,$3); 
+    $$ = ast_arena.New<ConstDecl>(Type::INT,$3); 
     $$->SetLineNumber(line_number);
 }
 ;
@@ -131,14 +132,14 @@ ConstDecl
 // TODO(): 考虑变量定义更多情况 
 ConstDecl
 :CONST FLOAT ConstDef_list ';'{
-    $$ = new ConstDecl(Type::FLOAT,$3);
+    $$ = ast_arena.New<ConstDecl>(Type::FLOAT,$3);
     $$->SetLineNumber(line_number);
 } 
 ;
 
 VarDef_list
 :VarDef{
-    $$ = new std::vector<Def>;
+    $$ = ast_arena.New<std::vector<Def>>();
     ($$)->push_back($1);
 }
 |VarDef_list ',' VarDef{
@@ -149,7 +150,7 @@ VarDef_list
 
 ConstDef_list
 :ConstDef{
-    $$ = new std::vector<Def>;
+    $$ = ast_arena.New<std::vector<Def>>();
     ($$)->push_back($1);
 }
 |ConstDef_list ',' ConstDef{
@@ -161,12 +162,12 @@ ConstDef_list
 FuncDef
 :INT IDENT '(' FuncFParams ')' Block
 {
-    $$ = new __FuncDef(Type::INT,$2,$4,$6);
+    $$ = ast_arena.New<__FuncDef>(Type::INT,$2,$4,$6);
     $$->SetLineNumber(line_number);
 }
 |INT IDENT '(' ')' Block
 {
-    $$ = new __FuncDef(Type::INT,$2,new std::vector<FuncFParam>(),$5); 
+    $$ = ast_arena.New<__FuncDef>(Type::INT,$2,ast_arena.New<std::vector<FuncFParam>>(),$5); 
     $$->SetLineNumber(line_number);
 }
 ;
@@ -175,43 +176,43 @@ FuncDef
 :FLOAT IDENT '(' FuncFParams ')' Block
 {
     // float 返回类型
-    $$ = new __FuncDef(Type::FLOAT,$2,$4,$6);
+    $$ = ast_arena.New<__FuncDef>(Type::FLOAT,$2,$4,$6);
     $$->SetLineNumber(line_number);
 }
 |FLOAT IDENT '(' ')' Block
 {
-    $$ = new __FuncDef(Type::FLOAT,$2,new std::vector<FuncFParam>(),$5); 
+    $$ = ast_arena.New<__FuncDef>(Type::FLOAT,$2,ast_arena.New<std::vector<FuncFParam>>(),$5); 
     $$->SetLineNumber(line_number);
 }
 |NONE_TYPE IDENT '(' FuncFParams ')' Block
 {
     // void 返回类型
-    $$ = new __FuncDef(Type::VOID,$2,$4,$6);
+    $$ = ast_arena.New<__FuncDef>(Type::VOID,$2,$4,$6);
     $$->SetLineNumber(line_number);
 }
 |NONE_TYPE IDENT '(' ')' Block
 {
-    $$ = new __FuncDef(Type::VOID,$2,new std::vector<FuncFParam>(),$5); 
+    $$ = ast_arena.New<__FuncDef>(Type::VOID,$2,ast_arena.New<std::vector<FuncFParam>>(),$5); 
     $$->SetLineNumber(line_number);
 }
 
 VarDef
 :IDENT '=' VarInitVal
-{$$ = new VarDef($1,nullptr,$3); $$->SetLineNumber(line_number);}
+{$$ = ast_arena.New<VarDef>($1,nullptr,$3); $$->SetLineNumber(line_number);}
 |IDENT
-{$$ = new VarDef_no_init($1,nullptr); $$->SetLineNumber(line_number);}
+{$$ = ast_arena.New<VarDef_no_init>($1,nullptr); $$->SetLineNumber(line_number);}
 ;   
 // TODO(): 考虑变量定义更多情况
 // 数组
 VarDef
 :IDENT ArrayDims '=' VarInitVal
 {
-    $$ = new VarDef($1,$2,$4); 
+    $$ = ast_arena.New<VarDef>($1,$2,$4); 
     $$->SetLineNumber(line_number);
 }
 |IDENT ArrayDims
 {
-    $$ = new VarDef_no_init($1,$2); 
+    $$ = ast_arena.New<VarDef_no_init>($1,$2); 
     $$->SetLineNumber(line_number);
 }
 
@@ -219,12 +220,12 @@ VarDef
 ConstDef
 :IDENT '=' ConstInitVal
 {
-    $$ = new ConstDef($1,nullptr,$3);
+    $$ = ast_arena.New<ConstDef>($1,nullptr,$3);
     $$->SetLineNumber(line_number);
 }
 |IDENT ConstArrayDims '=' ConstInitVal
 {
-    $$ = new ConstDef($1,$2,$4);
+    $$ = ast_arena.New<ConstDef>($1,$2,$4);
     $$->SetLineNumber(line_number);
 }
 ;
@@ -233,17 +234,17 @@ ConstDef
 ConstInitVal
 :ConstExp
 {
-    $$ = new ConstInitVal_exp($1);
+    $$ = ast_arena.New<ConstInitVal_exp>($1);
     $$->SetLineNumber(line_number);
 }
 |'{' ConstInitVal_list '}'
 {
-    $$ = new ConstInitVal($2);
+    $$ = ast_arena.New<ConstInitVal>($2);
     $$->SetLineNumber(line_number);
 }
 |'{' '}'
 {
-    $$ = new ConstInitVal(new std::vector<InitVal>());
+    $$ = ast_arena.New<ConstInitVal>(ast_arena.New<std::vector<InitVal>>());
     $$->SetLineNumber(line_number);
 }
 ;
@@ -252,17 +253,17 @@ ConstInitVal
 VarInitVal
 :Exp
 {
-    $$ = new VarInitVal_exp($1);
+    $$ = ast_arena.New<VarInitVal_exp>($1);
     $$->SetLineNumber(line_number);
 }
 |'{' VarInitVal_list '}'
 {
-    $$ = new VarInitVal($2);
+    $$ = ast_arena.New<VarInitVal>($2);
     $$->SetLineNumber(line_number);
 }
 |'{' '}'
 {
-    $$ = new VarInitVal(new std::vector<InitVal>());
+    $$ = ast_arena.New<VarInitVal>(ast_arena.New<std::vector<InitVal>>());
     $$->SetLineNumber(line_number);
 }
 ;
@@ -271,7 +272,7 @@ VarInitVal
 ConstInitVal_list
 :ConstInitVal
 {
-    $$ = new std::vector<InitVal>;
+    $$ = ast_arena.New<std::vector<InitVal>>();
     ($$)->push_back($1);
 }
 |ConstInitVal_list ',' ConstInitVal
@@ -285,7 +286,7 @@ ConstInitVal_list
 VarInitVal_list
 :VarInitVal
 {
-    $$ = new std::vector<InitVal>;
+    $$ = ast_arena.New<std::vector<InitVal>>();
     ($$)->push_back($1);
 }
 |VarInitVal_list ',' VarInitVal
@@ -298,7 +299,7 @@ VarInitVal_list
 
 FuncFParams
 :FuncFParam{
-    $$ = new std::vector<FuncFParam>;
+    $$ = ast_arena.New<std::vector<FuncFParam>>();
     ($$)->push_back($1);
 }
 |FuncFParams ',' FuncFParam{
@@ -309,14 +310,14 @@ FuncFParams
 
 FuncFParam
 :INT IDENT{
-    $$ = new __FuncFParam(Type::INT,$2,nullptr);
+    $$ = ast_arena.New<__FuncFParam>(Type::INT,$2,nullptr);
     $$->SetLineNumber(line_number);
 }
 ;
 // TODO(): 考虑函数形参更多情况
 FuncFParam
 :FLOAT IDENT{
-    $$ = new __FuncFParam(Type::FLOAT,$2,nullptr);
+    $$ = ast_arena.New<__FuncFParam>(Type::FLOAT,$2,nullptr);
     $$->SetLineNumber(line_number);
 }
 
@@ -324,24 +325,24 @@ FuncFParam
 FuncFParam
 :INT IDENT '[' ']' ArrayDims{
     $5->insert($5->begin(),nullptr);
-    $$ = new __FuncFParam(Type::INT,$2,$5);
+    $$ = ast_arena.New<__FuncFParam>(Type::INT,$2,$5);
     $$->SetLineNumber(line_number);
 }
 |FLOAT IDENT '[' ']' ArrayDims{
     $5->insert($5->begin(),nullptr);
-    $$ = new __FuncFParam(Type::FLOAT,$2,$5);
+    $$ = ast_arena.New<__FuncFParam>(Type::FLOAT,$2,$5);
     $$->SetLineNumber(line_number);
 }
 |INT IDENT '['  ']' {
-    std::vector<Expression>* temp = new std::vector<Expression>;
+    std::vector<Expression>* temp = ast_arena.New<std::vector<Expression>>();
     temp->push_back(nullptr);
-    $$ = new __FuncFParam(Type::INT,$2,temp);
+    $$ = ast_arena.New<__FuncFParam>(Type::INT,$2,temp);
     $$->SetLineNumber(line_number);
 }
 |FLOAT IDENT '['  ']' {
-    std::vector<Expression>* temp = new std::vector<Expression>;
+    std::vector<Expression>* temp = ast_arena.New<std::vector<Expression>>();
     temp->push_back(nullptr);
-    $$ = new __FuncFParam(Type::FLOAT,$2,temp);
+    $$ = ast_arena.New<__FuncFParam>(Type::FLOAT,$2,temp);
     $$->SetLineNumber(line_number);
 }
 ;
@@ -349,11 +350,11 @@ FuncFParam
 
 Block
 :'{' BlockItem_list '}'{
-    $$ = new __Block($2);
+    $$ = ast_arena.New<__Block>($2);
     $$->SetLineNumber(line_number);
 }
 |'{' '}'{
-    $$ = new __Block(new std::vector<BlockItem>);
+    $$ = ast_arena.New<__Block>(ast_arena.New<std::vector<BlockItem>>());
     $$->SetLineNumber(line_number);
 }
 ;
@@ -362,7 +363,7 @@ Block
 BlockItem_list
 :BlockItem
 {
-    $$ = new std::vector<BlockItem>;
+    $$ = ast_arena.New<std::vector<BlockItem>>();
     ($$)->push_back($1);
 }
 |BlockItem_list BlockItem
@@ -376,12 +377,12 @@ BlockItem_list
 BlockItem
 :Decl
 {
-    $$ = new BlockItem_Decl($1);
+    $$ = ast_arena.New<BlockItem_Decl>($1);
     $$->SetLineNumber(line_number);
 }
 |Stmt
 {
-    $$ = new BlockItem_Stmt($1);
+    $$ = ast_arena.New<BlockItem_Stmt>($1);
     $$->SetLineNumber(line_number);
 }
 ;
@@ -390,57 +391,57 @@ BlockItem
 Stmt
 :Lval '=' Exp ';'
 {
-    $$ = new assign_stmt($1,$3);
+    $$ = ast_arena.New<assign_stmt>($1,$3);
     $$->SetLineNumber(line_number);
 }
 |Exp ';'
 {
-    $$ = new expr_stmt($1);
+    $$ = ast_arena.New<expr_stmt>($1);
     $$->SetLineNumber(line_number);
 }
 |Block
 {
-    $$ = new block_stmt($1);
+    $$ = ast_arena.New<block_stmt>($1);
     $$->SetLineNumber(line_number);
 }
 |';'
 {
-    $$ = new null_stmt();
+    $$ = ast_arena.New<null_stmt>();
     $$->SetLineNumber(line_number);
 }
 |IF '(' Cond ')' Stmt %prec THEN
 {
-    $$ = new if_stmt($3,$5);
+    $$ = ast_arena.New<if_stmt>($3,$5);
     $$->SetLineNumber(line_number);
 }
 |IF '(' Cond ')' Stmt ELSE Stmt
 {
-    $$ = new ifelse_stmt($3,$5,$7);
+    $$ = ast_arena.New<ifelse_stmt>($3,$5,$7);
     $$->SetLineNumber(line_number);
 }
 |WHILE '(' Cond ')' Stmt
 {
-    $$ = new while_stmt($3,$5);
+    $$ = ast_arena.New<while_stmt>($3,$5);
     $$->SetLineNumber(line_number);
 }
 |BREAK ';'
 {
-    $$ = new break_stmt();
+    $$ = ast_arena.New<break_stmt>();
     $$->SetLineNumber(line_number);
 }
 |CONTINUE ';'
 {
-    $$ = new continue_stmt();
+    $$ = ast_arena.New<continue_stmt>();
     $$->SetLineNumber(line_number);
 }
 |RETURN ';'
 {
-    $$ = new return_stmt_void();
+    $$ = ast_arena.New<return_stmt_void>();
     $$->SetLineNumber(line_number);
 }
 |RETURN Exp ';'
 {
-    $$ = new return_stmt($2);
+    $$ = ast_arena.New<return_stmt>($2);
     $$->SetLineNumber(line_number);
 }
 ;
@@ -457,7 +458,7 @@ Cond
 Lval
 :IDENT
 {
-    $$ = new Lval($1,nullptr);
+    $$ = ast_arena.New<Lval>($1,nullptr);
     $$->SetLineNumber(line_number);
 }
 
@@ -465,7 +466,7 @@ Lval
 Lval
 :IDENT ArrayDims
 {
-    $$ = new Lval($1,$2);
+    $$ = ast_arena.New<Lval>($1,$2);
     $$->SetLineNumber(line_number);
 }
 ;
@@ -474,7 +475,7 @@ Lval
 PrimaryExp
 :'(' Exp ')'
 {
-    $$ = new PrimaryExp_branch($2);
+    $$ = ast_arena.New<PrimaryExp_branch>($2);
     $$->SetLineNumber(line_number);
 }
 |Lval
@@ -496,14 +497,14 @@ PrimaryExp
 
 IntConst
 :INT_CONST{
-    $$ = new IntConst($1);
+    $$ = ast_arena.New<IntConst>($1);
     $$->SetLineNumber(line_number);
 }
 ;
 
 FloatConst
 :FLOAT_CONST{
-    $$ = new FloatConst($1);
+    $$ = ast_arena.New<FloatConst>($1);
     $$->SetLineNumber(line_number);
 }
 ;
@@ -511,7 +512,7 @@ FloatConst
 UnaryExp
 :PrimaryExp{$$ = $1;}
 |IDENT '(' FuncRParams ')'{
-    $$ = new Func_call($1,$3);
+    $$ = ast_arena.New<Func_call>($1,$3);
     $$->SetLineNumber(line_number);
 }
 |IDENT '(' ')'{
@@ -520,34 +521,34 @@ UnaryExp
     // 我们在语法分析中将其替换为_sysy_starttime(line_number)
     // stoptime同理
     if($1->get_string() == "starttime"){
-        auto params = new std::vector<Expression>;
-        params->push_back(new IntConst(line_number));
-        Expression temp = new FuncRParams(params);
-        $$ = new Func_call(id_table.add_id("_sysy_starttime"),temp);
+        auto params = ast_arena.New<std::vector<Expression>>();
+        params->push_back(ast_arena.New<IntConst>(line_number));
+        Expression temp = ast_arena.New<FuncRParams>(params);
+        $$ = ast_arena.New<Func_call>(id_table.add_id("_sysy_starttime"),temp);
         $$->SetLineNumber(line_number);
     }
     else if($1->get_string() == "stoptime"){
-        auto params = new std::vector<Expression>;
-        params->push_back(new IntConst(line_number));
-        Expression temp = new FuncRParams(params);
-        $$ = new Func_call(id_table.add_id("_sysy_stoptime"),temp);
+        auto params = ast_arena.New<std::vector<Expression>>();
+        params->push_back(ast_arena.New<IntConst>(line_number));
+        Expression temp = ast_arena.New<FuncRParams>(params);
+        $$ = ast_arena.New<Func_call>(id_table.add_id("_sysy_stoptime"),temp);
         $$->SetLineNumber(line_number);
     }
     else{
-        $$ = new Func_call($1,nullptr);
+        $$ = ast_arena.New<Func_call>($1,nullptr);
         $$->SetLineNumber(line_number);
     }
 }
 |'+' UnaryExp{
-    $$ = new UnaryExp_plus($2);
+    $$ = ast_arena.New<UnaryExp_plus>($2);
     $$->SetLineNumber(line_number);
 }
 |'-' UnaryExp{
-    $$ = new UnaryExp_neg($2);
+    $$ = ast_arena.New<UnaryExp_neg>($2);
     $$->SetLineNumber(line_number);
 }
 |'!' UnaryExp{
-    $$ = new UnaryExp_not($2);
+    $$ = ast_arena.New<UnaryExp_not>($2);
     $$->SetLineNumber(line_number);
 }
 ;
@@ -556,7 +557,7 @@ UnaryExp
 FuncRParams
 :Exp_list
 {
-    $$ = new FuncRParams($1);
+    $$ = ast_arena.New<FuncRParams>($1);
     $$->SetLineNumber(line_number);
 }
 ;
@@ -565,7 +566,7 @@ FuncRParams
 Exp_list
 :Exp
 {
-    $$ = new std::vector<Expression>;
+    $$ = ast_arena.New<std::vector<Expression>>();
     ($$)->push_back($1);
 }
 |Exp_list ',' Exp
@@ -584,17 +585,17 @@ MulExp
 }
 |MulExp '*' UnaryExp
 {
-    $$ = new MulExp_mul($1,$3);
+    $$ = ast_arena.New<MulExp_mul>($1,$3);
     $$->SetLineNumber(line_number);
 }
 |MulExp '/' UnaryExp
 {
-    $$ = new MulExp_div($1,$3);
+    $$ = ast_arena.New<MulExp_div>($1,$3);
     $$->SetLineNumber(line_number);
 }
 |MulExp '%' UnaryExp
 {
-    $$ = new MulExp_mod($1,$3);
+    $$ = ast_arena.New<MulExp_mod>($1,$3);
     $$->SetLineNumber(line_number);
 }
 ;
@@ -605,11 +606,11 @@ AddExp
     $$->SetLineNumber(line_number);
 }
 |AddExp '+' MulExp{
-    $$ = new AddExp_plus($1,$3); 
+    $$ = ast_arena.New<AddExp_plus>($1,$3); 
     $$->SetLineNumber(line_number);
 }
 |AddExp '-' MulExp{
-    $$ = new AddExp_sub($1,$3); 
+    $$ = ast_arena.New<AddExp_sub>($1,$3); 
     $$->SetLineNumber(line_number);
 }
 ;
@@ -623,22 +624,22 @@ RelExp
 }
 |RelExp '<' AddExp
 {
-    $$ = new RelExp_lt($1,$3);
+    $$ = ast_arena.New<RelExp_lt>($1,$3);
     $$->SetLineNumber(line_number);
 }
 |RelExp '>' AddExp
 {
-    $$ = new RelExp_gt($1,$3);
+    $$ = ast_arena.New<RelExp_gt>($1,$3);
     $$->SetLineNumber(line_number);
 }
 |RelExp LEQ AddExp
 {
-    $$ = new RelExp_leq($1,$3);
+    $$ = ast_arena.New<RelExp_leq>($1,$3);
     $$->SetLineNumber(line_number);
 }
 |RelExp GEQ AddExp
 {
-    $$ = new RelExp_geq($1,$3);
+    $$ = ast_arena.New<RelExp_geq>($1,$3);
     $$->SetLineNumber(line_number);
 }
 ;
@@ -652,12 +653,12 @@ EqExp
 }
 |EqExp EQ RelExp
 {
-    $$ = new EqExp_eq($1,$3);
+    $$ = ast_arena.New<EqExp_eq>($1,$3);
     $$->SetLineNumber(line_number);
 }
 |EqExp NE RelExp
 {
-    $$ = new EqExp_neq($1,$3);
+    $$ = ast_arena.New<EqExp_neq>($1,$3);
     $$->SetLineNumber(line_number);
 }
 ;
@@ -671,7 +672,7 @@ LAndExp
 }
 |LAndExp AND EqExp
 {
-    $$ = new LAndExp_and($1,$3);
+    $$ = ast_arena.New<LAndExp_and>($1,$3);
     $$->SetLineNumber(line_number);
 }
 ;
@@ -685,7 +686,7 @@ LOrExp
 }
 |LOrExp OR LAndExp
 {
-    $$ = new LOrExp_or($1,$3);
+    $$ = ast_arena.New<LOrExp_or>($1,$3);
     $$->SetLineNumber(line_number);
 }
 ;
@@ -711,7 +712,7 @@ ArrayDim
 ArrayDims
 :ArrayDim
 {
-    $$ = new std::vector<Expression>;
+    $$ = ast_arena.New<std::vector<Expression>>();
     ($$)->push_back($1);
 }
 |ArrayDims ArrayDim
@@ -732,7 +733,7 @@ ConstArrayDim
 ConstArrayDims
 :ConstArrayDim
 {
-    $$ = new std::vector<Expression>;
+    $$ = ast_arena.New<std::vector<Expression>>();
     ($$)->push_back($1);
 }
 |ConstArrayDims ConstArrayDim
@@ -0,0 +1,144 @@
+import argparse
+import os
+
+# 生成用于测试编译时间的SysY程序, 每种形状由一个规模参数n控制
+# 对应main.cc中提到的long_line.sy, long_code.sy, long_func.sy等大型用例的特点
+
+def long_expr(n):
+    # 一行内有n项的表达式
+    terms = ["a", "b", "3", "c", "7"]
+    ops = [" + ", " - ", " * ", " + ", " / "]
+    parts = ["a"]
+    for i in range(1, n):
+        parts.append(ops[i % len(ops)])
+        parts.append(terms[i % len(terms)])
+    return ("int main() {\n"
+            "    int a = getint();\n"
+            "    int b = a + 1;\n"
+            "    int c = b + 2;\n"
+            "    int s = " + "".join(parts) + ";\n"
+            "    putint(s);\n"
+            "    return 0;\n"
+            "}\n")
+
+def deep_expr(n):
+    # 嵌套深度为n的括号表达式
+    ops = ["+", "*", "-"]
+    expr = "a"
+    for i in range(n):
+        expr = "(" + expr + " " + ops[i % 3] + " " + str(i % 7 + 1) + ")"
+    return ("int main() {\n"
+            "    int a = getint();\n"
+            "    int s = " + expr + ";\n"
+            "    putint(s);\n"
+            "    return 0;\n"
+            "}\n")
+
+def many_blocks(n):
+    # n个if-else, 每个if-else产生3个基本块
+    lines = ["int main() {", "    int x = getint();", "    int s = 0;"]
+    for i in range(n):
+        lines.append("    if (x % " + str(i % 13 + 2) + " == " + str(i % 2) + ") {")
+        lines.append("        s = s + " + str(i) + ";")
+        lines.append("    } else {")
+        lines.append("        s = s - x;")
+        lines.append("    }")
+    lines += ["    putint(s);", "    return 0;", "}"]
+    return "\n".join(lines) + "\n"
+
+def long_func(n, v=16):
+    # 一个有n条语句的函数, 语句之间共用v个局部变量
+    lines = ["int f(int p, int q) {"]
+    for k in range(v):
+        lines.append("    int v" + str(k) + " = p + " + str(k) + " * q;")
+    for i in range(n):
+        a, b, c = i % v, (i * 7 + 3) % v, (i * 13 + 5) % v
+        lines.append("    v" + str(a) + " = v" + str(b) + " + v" + str(c) + " * " + str(i % 5 + 1) + ";")
+    lines.append("    return " + " + ".join("v" + str(k) for k in range(v)) + ";")
+    lines.append("}")
+    lines += ["int main() {", "    putint(f(getint(), 3));", "    return 0;", "}"]
+    return "\n".join(lines) + "\n"
+
+def reg_pressure(n):
+    # n个同时活跃的局部变量, 寄存器不够用时需要溢出
+    return long_func(n, n)
+
+def many_funcs(n):
+    # n个小函数, 每个函数调用前一个函数
+    lines = ["int f0(int x, int y) {", "    return x + y;", "}"]
+    for i in range(1, n):
+        lines.append("int f" + str(i) + "(int x, int y) {")
+        lines.append("    if (x > y) {")
+        lines.append("        return f" + str(i - 1) + "(y, x) + " + str(i) + ";")
+        lines.append("    }")
+        lines.append("    return x * " + str(i % 5 + 1) + " + y;")
+        lines.append("}")
+    lines += ["int main() {", "    putint(f" + str(n - 1) + "(getint(), 3));", "    return 0;", "}"]
+    return "\n".join(lines) + "\n"
+
+def big_init(n):
+    # 有n个元素的全局数组初始化, 以及多维常量数组和局部数组的初始化
+    vals = [str(i % 10) if i % 4 != 0 else "0" for i in range(n)]
+    rows = max(n // 10, 1)
+    rows_init = ", ".join("{" + ", ".join(str((r + c) % 9) for c in range(10)) + "}" for r in range(rows))
+    local = max(n // 10, 1)
+    local_init = ", ".join(str(i % 7) for i in range(local))
+    return ("int g[" + str(n) + "] = {" + ", ".join(vals) + "};\n"
+            "const int c[" + str(rows) + "][10] = {" + rows_init + "};\n"
+            "int main() {\n"
+            "    int l[" + str(local) + "] = {" + local_init + "};\n"
+            "    int i = getint();\n"
+            "    putint(g[i] + c[i][i] + l[i]);\n"
+            "    return 0;\n"
+            "}\n")
+
+def loop_nest(n):
+    # 嵌套深度为n的while循环
+    lines = ["int main() {", "    int m = getint();", "    int s = 0;"]
+    for k in range(n):
+        lines.append("    " * (k + 1) + "int i" + str(k) + " = 0;")
+        lines.append("    " * (k + 1) + "while (i" + str(k) + " < m) {")
+    lines.append("    " * (n + 1) + "s = s + i" + str(n - 1) + ";")
+    for k in reversed(range(n)):
+        lines.append("    " * (k + 2) + "i" + str(k) + " = i" + str(k) + " + 1;")
+        lines.append("    " * (k + 1) + "}")
+    lines += ["    putint(s);", "    return 0;", "}"]
+    return "\n".join(lines) + "\n"
+
+SHAPES = {
+    "long_expr": long_expr,
+    "deep_expr": deep_expr,
+    "many_blocks": many_blocks,
+    "long_func": long_func,
+    "reg_pressure": reg_pressure,
+    "many_funcs": many_funcs,
+    "big_init": big_init,
+    "loop_nest": loop_nest,
+}
+
+# 每种形状的默认规模, 相邻两项相差一倍, 便于观察时间随规模的增长
+DEFAULT_SIZES = {
+    "long_expr": [2000, 4000, 8000, 16000],
+    "deep_expr": [250, 500, 1000, 2000],
+    "many_blocks": [500, 1000, 2000, 4000],
+    "long_func": [1000, 2000, 4000, 8000],
+    "reg_pressure": [8, 16, 32, 64],
+    "many_funcs": [250, 500, 1000, 2000],
+    "big_init": [25000, 50000, 100000, 200000],
+    "loop_nest": [25, 50, 100, 200],
+}
+
+def generate(shape, n, output_folder):
+    path = os.path.join(output_folder, shape + "_" + str(n) + ".sy")
+    with open(path, "w") as f:
+        f.write(SHAPES[shape](n))
+    return path
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="generate SysY stress inputs")
+    parser.add_argument("shape", choices=sorted(SHAPES.keys()))
+    parser.add_argument("n", type=int)
+    parser.add_argument("-o", "--output_folder", default=".")
+    args = parser.parse_args()
+    os.makedirs(args.output_folder, exist_ok=True)
+    print(generate(args.shape, args.n, args.output_folder))
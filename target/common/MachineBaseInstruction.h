@@ -187,6 +187,15 @@ public:
     }
 };
 
+struct RegisterHash {
+    size_t operator()(const Register &reg) const {
+        size_t h = (size_t)(unsigned)reg.reg_no;
+        h = h * 4 + reg.type.data_type;
+        h = h * 4 + reg.type.data_length;
+        return h * 2 + reg.is_virtual;
+    }
+};
+
 struct MachineBaseOperand {
     MachineDataType type;
     enum { REG, IMMI, IMMF, IMMD };
@@ -58,8 +58,6 @@ void MachineCFG::RemoveEdge(int edg_begin, int edg_end) {
 }
 
 Register MachineFunction::GetNewRegister(int regtype, int reglength) {
-    // new_regno 需要大一点，不然会出现编号重复问题
-    static int new_regno = 38000;
     Register new_reg;
     new_reg.is_virtual = true;
     new_reg.reg_no = new_regno++;
@@ -82,7 +82,14 @@ protected:
     int para_sz;
     MachineCFG *mcfg;
 
-    bool has_inpara_instack;
+    bool has_inpara_instack = false;
+
+    // 下一个新建虚拟寄存器的编号, 每个函数单独编号, 因此不同函数可以同时申请新的虚拟寄存器
+    // 编号需要大一点, 不然会与中间代码寄存器对应的虚拟寄存器重复
+    int new_regno = 38000;
+
+    // 该函数所有指令所在的指令池, 函数输出后通过ReleaseInstructions整体释放
+    Arena instruction_pool;
 
 public:
     bool HasInParaInStack() { return has_inpara_instack; }
@@ -117,6 +124,16 @@ public:
     // 获取函数名
     std::string getFunctionName() { return func_name; }
 
+    // 获取指令池
+    Arena &GetInstructionPool() { return instruction_pool; }
+    // 释放该函数的所有指令, 之后不能再访问该函数中的指令
+    void ReleaseInstructions() {
+        for (auto block : blocks) {
+            block->clear();
+        }
+        instruction_pool.Release();
+    }
+
     // 设置MachineUnit
     void SetParent(MachineUnit *parent) { this->parent = parent; }
     // 设置CFG
@@ -129,6 +146,8 @@ public:
     std::set<MachineBlock *> ret_blocks{};
 
 public:
+    // 函数中已有的虚拟寄存器编号都小于regno时调用, 保证之后新建的虚拟寄存器编号不会与之重复
+    void ReserveRegNo(int regno) { new_regno = new_regno > regno ? new_regno : regno; }
     // 获取新的虚拟寄存器
     Register GetNewRegister(int regtype, int regwidth);
     // 获取新的虚拟寄存器，等同于GetNewRegister(type.data_type, type.data_length)
@@ -172,8 +191,8 @@ public:
     void RemoveEdge(int edg_begin, int edg_end);
 
     MachineCFGNode *GetNodeByBlockId(int id) { return block_map[id]; }
-    std::vector<MachineCFGNode *> GetSuccessorsByBlockId(int id) { return G[id]; }
-    std::vector<MachineCFGNode *> GetPredecessorsByBlockId(int id) { return invG[id]; }
+    const std::vector<MachineCFGNode *> &GetSuccessorsByBlockId(int id) { return G[id]; }
+    const std::vector<MachineCFGNode *> &GetPredecessorsByBlockId(int id) { return invG[id]; }
 
 private:
     class Iterator {
@@ -1,33 +1,37 @@
 #include "basic_register_allocation.h"
+#include "../../../../include/time_report.h"
 
 void RegisterAllocation::Execute() {
     // 你需要保证此时不存在phi指令
     for (auto func : unit->functions) {
-        not_allocated_funcs.push(func);
+        TimeReport::FunctionScope timer(time_report, func->getFunctionName());
+        ExecuteInFunc(func);
     }
-    while (!not_allocated_funcs.empty()) {
-        current_func = not_allocated_funcs.front();
+}
+
+void RegisterAllocation::ExecuteInFunc(MachineFunction *func) {
+    current_func = func;
+    while (true) {
         numbertoins.clear();
         // 对每条指令进行编号
         InstructionNumber(unit, numbertoins).ExecuteInFunc(current_func);
 
         // 需要清除之前分配的结果
         alloc_result[current_func].clear();
-        not_allocated_funcs.pop();
 
         // 计算活跃区间
         UpdateIntervalsInCurrentFunc();
 
-        if (DoAllocInCurrentFunc()) {    // 尝试进行分配
-            // 如果发生溢出，插入spill指令后将所有物理寄存器退回到虚拟寄存器，重新分配
-            spiller->ExecuteInFunc(current_func, &alloc_result[current_func]);    // 生成溢出代码
-            current_func->AddStackSize(phy_regs_tools->getSpillSize());           // 调整栈的大小
-            not_allocated_funcs.push(current_func);                               // 重新分配直到不再spill
+        if (!DoAllocInCurrentFunc()) {    // 尝试进行分配
+            break;
         }
-        // std::cout << current_func->GetStackSize() << "-cur\n";
+        // 如果发生溢出，插入spill指令后将所有物理寄存器退回到虚拟寄存器，重新分配
+        spiller->ExecuteInFunc(current_func, &alloc_result[current_func]);    // 生成溢出代码
+        current_func->AddStackSize(phy_regs_tools->getSpillSize());           // 调整栈的大小
     }
     // 重写虚拟寄存器，全部转换为物理寄存器
-    VirtualRegisterRewrite(unit, alloc_result).Execute();
+    VirtualRegisterRewrite(unit, alloc_result).ExecuteInFunc(current_func);
+    alloc_result.erase(current_func);
 }
 
 void InstructionNumber::Execute() {
@@ -75,7 +79,8 @@ void RegisterAllocation::UpdateIntervalsInCurrentFunc() {
         auto mblock = mcfg_node->Mblock;
         auto cur_id = mcfg_node->Mblock->getLabelId();
         // For pseudo code see https://www.cnblogs.com/AANA/p/16311477.html
-        for (auto reg : liveness.GetOUT(cur_id)) {
+        for (auto reg_id : liveness.GetOUT(cur_id)) {
+            auto &reg = liveness.GetRegister(reg_id);
             if (intervals.find(reg) == intervals.end()) {
                 intervals[reg] = LiveInterval(reg);
             }
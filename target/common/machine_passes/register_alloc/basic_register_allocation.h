@@ -33,7 +33,6 @@ public:
 class RegisterAllocation : public MachinePass {
 private:
     void UpdateIntervalsInCurrentFunc();
-    std::queue<MachineFunction *> not_allocated_funcs;
     SpillCodeGen *spiller;
 
 protected:
@@ -80,6 +79,9 @@ public:
         : MachinePass(unit), phy_regs_tools(phy), spiller(spiller) {}
     // 对所有函数进行寄存器分配
     void Execute();
+    // 对单个函数进行寄存器分配(直到不再溢出)并重写其虚拟寄存器
+    // 分配过程只使用本对象及phy_regs_tools, spiller的状态, 不同线程使用各自的对象即可并行分配不同函数
+    void ExecuteInFunc(MachineFunction *func);
 };
 
 class InstructionNumber : public MachinePass {
@@ -104,7 +106,7 @@ public:
                            const std::map<MachineFunction *, std::map<Register, AllocResult>> &alloc_result)
         : MachinePass(unit), alloc_result(alloc_result) {}
     void Execute();
-    void ExecuteInFunc();
+    void ExecuteInFunc(MachineFunction *func);
 };
 
 class SpillCodeGen {
@@ -1,5 +1,5 @@
 #include "fast_linear_scan.h"
-bool IntervalsPrioCmp(LiveInterval a, LiveInterval b) { return a.begin()->begin > b.begin()->begin; }
+bool IntervalsPrioCmp(const LiveInterval &a, const LiveInterval &b) { return a.begin()->begin > b.begin()->begin; }
 FastLinearScan::FastLinearScan(MachineUnit *unit, PhysicalRegistersAllocTools *phy, SpillCodeGen *spiller)
     : RegisterAllocation(unit, phy, spiller), unalloc_queue(IntervalsPrioCmp) {}
 bool FastLinearScan::DoAllocInCurrentFunc() {
@@ -8,7 +8,7 @@ bool FastLinearScan::DoAllocInCurrentFunc() {
     PRINT("FastLinearScan: %s", mfun->getFunctionName().c_str());
     // std::cerr<<"FastLinearScan: "<<mfun->getFunctionName()<<"\n";
     phy_regs_tools->clear();
-    for (auto interval : intervals) {
+    for (auto &interval : intervals) {
         Assert(interval.first == interval.second.getReg());
         if (interval.first.is_virtual) {
             // 需要分配的虚拟寄存器
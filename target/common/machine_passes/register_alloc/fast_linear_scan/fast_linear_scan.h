@@ -2,7 +2,7 @@
 #define FAST_LINEAR_SCAN_H
 #include "../basic_register_allocation.h"
 
-bool IntervalsPrioCmp(LiveInterval a, LiveInterval b);
+bool IntervalsPrioCmp(const LiveInterval &a, const LiveInterval &b);
 class FastLinearScan : public RegisterAllocation {
 private:
     std::priority_queue<LiveInterval, std::vector<LiveInterval>, decltype(IntervalsPrioCmp) *> unalloc_queue;
@@ -12,60 +12,130 @@ private:
     struct LiveSegment {
         int begin;
         int end;
+        // 段中最后一个编号, 段可以统一看作闭区间 [begin, last()]
+        int last() const { return end - 1 > begin ? end - 1 : begin; }
         bool inside(int pos) const {
             if (begin == end)
                 return begin == pos;
             return begin <= pos && pos < end;
         }
         bool operator&(const struct LiveSegment &that) const {
-            return this->inside(that.begin) || this->inside(that.end - 1 > that.begin ? that.end - 1 : that.begin) ||
-                   that.inside(this->begin) || that.inside(this->end - 1 > this->begin ? this->end - 1 : this->begin);
+            return this->begin <= that.last() && that.begin <= this->last();
         }
         bool operator==(const struct LiveSegment &that) const {
             return this->begin == that.begin && this->end == that.end;
         }
     };
-    std::list<LiveSegment> segments{};
+    // 活跃区间按编号从后往前构建(PushFront), 因此连续数组中按 begin 降序存放,
+    // 对外通过反向迭代器按升序访问, 首段即数组末尾
+    std::vector<LiveSegment> segments{};
     int reference_count;
 
 public:
     // 检测两个活跃区间是否重叠
-    // 保证两个活跃区间各个段各自都是不降序（升序）排列的
+    // 保证两个活跃区间各个段各自都是不降序（升序）排列的, 因此可以像归并一样线性扫描:
+    // 每次丢弃结束得更早的段, 它不可能再与对方后面的段重叠
     bool operator&(const LiveInterval &that) const {
-        // TODO("& operator in LiveInterval");
-
-        for (auto this_seg : segments) {
-            for (auto that_seg : that.segments) {
-                if (this_seg & that_seg) {
-                    return true;
-                }
+        auto it = begin(), jt = that.begin();
+        while (it != end() && jt != that.end()) {
+            if (*it & *jt) {
+                return true;
+            }
+            if (it->last() < jt->last()) {
+                ++it;
+            } else {
+                ++jt;
             }
         }
-
         return false;
     }
 
     // 更新引用计数
     void IncreaseReferenceCount(int count) { reference_count += count; }
-    int getReferenceCount() { return reference_count; }
+    int getReferenceCount() const { return reference_count; }
     // 返回活跃区间长度
-    int getIntervalLen() {
+    int getIntervalLen() const {
         int ret = 0;
-        for (auto seg : segments) {
+        for (auto &seg : segments) {
             ret += (seg.end - seg.begin + 1);
         }
         return ret;
     }
-    Register getReg() { return reg; }
+    Register getReg() const { return reg; }
     LiveInterval() : reference_count(0) {}    // Temp
     LiveInterval(Register reg) : reg(reg), reference_count(0) {}
 
-    void PushFront(int begin, int end) { segments.push_front({begin = begin, end = end}); }
-    void SetMostBegin(int begin) { segments.begin()->begin = begin; }
+    void PushFront(int begin, int end) { segments.push_back({begin, end}); }
+    void SetMostBegin(int begin) { segments.back().begin = begin; }
+
+    // 可以直接 for(auto segment : liveinterval), 按 begin 升序访问
+    decltype(segments.crbegin()) begin() const { return segments.crbegin(); }
+    decltype(segments.crend()) end() const { return segments.crend(); }
+};
+
+// 按 64 位字压缩的位向量, 下标为 Liveness 中寄存器的稠密编号
+class RegisterBitset {
+private:
+    std::vector<Uint64> words{};
+
+public:
+    // 依次返回所有被置位的下标
+    class iterator {
+    private:
+        const Uint64 *words;
+        int nwords;
+        int word_id;
+        Uint64 cur;
+        void skip() {
+            while (cur == 0 && word_id + 1 < nwords) {
+                cur = words[++word_id];
+            }
+            if (cur == 0) {
+                word_id = nwords;
+            }
+        }
+
+    public:
+        iterator(const Uint64 *words, int nwords, int word_id)
+            : words(words), nwords(nwords), word_id(word_id), cur(word_id < nwords ? words[word_id] : 0) {
+            skip();
+        }
+        int operator*() const { return word_id * 64 + __builtin_ctzll(cur); }
+        iterator &operator++() {
+            cur &= cur - 1;
+            skip();
+            return *this;
+        }
+        bool operator!=(const iterator &that) const { return word_id != that.word_id || cur != that.cur; }
+    };
+
+    void resize(int n) { words.assign((n + 63) / 64, 0); }
+    void set(int i) { words[i >> 6] |= 1ull << (i & 63); }
+    bool test(int i) const { return (words[i >> 6] >> (i & 63)) & 1; }
+
+    // this |= that, 返回是否发生变化
+    bool UnionWith(const RegisterBitset &that) {
+        Uint64 changed = 0;
+        for (size_t i = 0; i < words.size(); ++i) {
+            Uint64 w = words[i] | that.words[i];
+            changed |= w ^ words[i];
+            words[i] = w;
+        }
+        return changed != 0;
+    }
+    // this = use | (out - def), 返回是否发生变化
+    bool AssignTransfer(const RegisterBitset &use, const RegisterBitset &out, const RegisterBitset &def) {
+        Uint64 changed = 0;
+        for (size_t i = 0; i < words.size(); ++i) {
+            Uint64 w = use.words[i] | (out.words[i] & ~def.words[i]);
+            changed |= w ^ words[i];
+            words[i] = w;
+        }
+        return changed != 0;
+    }
 
-    // 可以直接 for(auto segment : liveinterval)
-    decltype(segments.begin()) begin() { return segments.begin(); }
-    decltype(segments.end()) end() { return segments.end(); }
+    iterator begin() const { return iterator(words.data(), words.size(), 0); }
+    iterator end() const { return iterator(words.data(), words.size(), words.size()); }
 };
 
 class Liveness {
@@ -73,9 +143,14 @@ private:
     MachineFunction *current_func;
     // 更新所有块DEF和USE集合
     void UpdateDefUse();
-    // Key: Block_Number
+    // 只有在某个块中"先用后定义"的寄存器才可能跨块活跃, 只对这些寄存器进行稠密编号
+    // 块内临时寄存器不进入位向量, 位向量的长度因此远小于函数中寄存器的总数
+    std::vector<Register> regs{};
+    // 按逆后序排列的基本块编号, 求解时逆序遍历
+    std::vector<int> rpo{};
+    // 下标: Block_Number
     // 存储活跃变量分析的结果
-    std::map<int, std::set<Register>> IN{}, OUT{}, DEF{}, USE{};
+    std::vector<RegisterBitset> IN{}, OUT{}, DEF{}, USE{};
 
 public:
     // 对所有块进行活跃变量分析并保存结果
@@ -85,10 +160,12 @@ public:
             Execute();
         }
     }
-    // 获取基本块的IN/OUT/DEF/USE集合
-    std::set<Register> GetIN(int bid) { return IN[bid]; }
-    std::set<Register> GetOUT(int bid) { return OUT[bid]; }
-    std::set<Register> GetDef(int bid) { return DEF[bid]; }
-    std::set<Register> GetUse(int bid) { return USE[bid]; }
+    // 获取基本块的IN/OUT/DEF/USE集合, 集合中的元素为寄存器的稠密编号
+    const RegisterBitset &GetIN(int bid) { return IN[bid]; }
+    const RegisterBitset &GetOUT(int bid) { return OUT[bid]; }
+    const RegisterBitset &GetDef(int bid) { return DEF[bid]; }
+    const RegisterBitset &GetUse(int bid) { return USE[bid]; }
+    // 稠密编号 -> 寄存器
+    const Register &GetRegister(int id) { return regs[id]; }
 };
 #endif
\ No newline at end of file
@@ -1,33 +1,11 @@
 #include "../../machine_instruction_structures/machine.h"
 #include "liveinterval.h"
+#include <algorithm>
+#include <deque>
+#include <unordered_map>
 
-// 为了实现方便，这里直接使用set进行活跃变量分析，如果你不满意，可以自行更换更高效的数据结构(例如bitset)
-template <class T> std::set<T> SetIntersect(const std::set<T> &a, const std::set<T> &b) {
-    std::set<T> ret;
-    for (auto x : b) {
-        if (a.count(x) != 0) {
-            ret.insert(x);
-        }
-    }
-    return ret;
-}
-
-template <class T> std::set<T> SetUnion(const std::set<T> &a, const std::set<T> &b) {
-    std::set<T> ret(a);
-    for (auto x : b) {
-        ret.insert(x);
-    }
-    return ret;
-}
-
-// a-b
-template <class T> std::set<T> SetDiff(const std::set<T> &a, const std::set<T> &b) {
-    std::set<T> ret(a);
-    for (auto x : b) {
-        ret.erase(x);
-    }
-    return ret;
-}
+// 活跃变量分析: 寄存器按函数稠密编号, IN/OUT/DEF/USE 使用按字压缩的位向量(RegisterBitset),
+// 并用按逆后序组织的工作表求解, 只有 IN 发生变化的块才会让其前驱重新入队
 
 std::vector<Register *> MachinePhiInstruction::GetReadReg() {
     std::vector<Register *> ret;
@@ -41,69 +19,145 @@ std::vector<Register *> MachinePhiInstruction::GetReadReg() {
 std::vector<Register *> MachinePhiInstruction::GetWriteReg() { return std::vector<Register *>({&result}); }
 
 void Liveness::UpdateDefUse() {
-
-    DEF.clear();
-    USE.clear();
-
     auto mcfg = current_func->getMachineCFG();
-    // 顺序遍历每个基本块
+
+    std::vector<MachineBlock *> blocks;
+    int max_id = -1;
     auto seq_it = mcfg->getSeqScanIterator();
     seq_it->open();
     while (seq_it->hasNext()) {
         auto node = seq_it->next();
+        blocks.push_back(node->Mblock);
+        max_id = std::max(max_id, node->Mblock->getLabelId());
+    }
+    delete seq_it;
 
+    // 先对函数中出现的所有寄存器编号, 用时间戳代替每个块中的 set 判重
+    std::unordered_map<Register, int, RegisterHash> all_id;
+    std::vector<Register> all_regs;
+    std::vector<int> def_stamp, use_stamp;
+    std::vector<char> is_global;
+    std::vector<std::vector<int>> block_def(max_id + 1), block_use(max_id + 1);
+    auto get_id = [&](const Register &reg) {
+        auto [it, inserted] = all_id.emplace(reg, all_regs.size());
+        if (inserted) {
+            all_regs.push_back(reg);
+            def_stamp.push_back(-1);
+            use_stamp.push_back(-1);
+            is_global.push_back(0);
+        }
+        return it->second;
+    };
+
+    for (auto block : blocks) {
+        int bid = block->getLabelId();
         // DEF[B]: 在基本块B中定义，并且定义前在B中没有被使用的变量集合
         // USE[B]: 在基本块B中使用，并且使用前在B中没有被定义的变量集合
-        DEF[node->Mblock->getLabelId()].clear();
-        USE[node->Mblock->getLabelId()].clear();
-
-        auto &cur_def = DEF[node->Mblock->getLabelId()];
-        auto &cur_use = USE[node->Mblock->getLabelId()];
-
-        for (auto ins : *(node->Mblock)) {
+        for (auto ins : *block) {
             for (auto reg_r : ins->GetReadReg()) {
-                if (cur_def.find(*reg_r) == cur_def.end()) {
-                    cur_use.insert(*reg_r);
+                int id = get_id(*reg_r);
+                if (def_stamp[id] != bid && use_stamp[id] != bid) {
+                    use_stamp[id] = bid;
+                    block_use[bid].push_back(id);
+                    is_global[id] = 1;
                 }
             }
             for (auto reg_w : ins->GetWriteReg()) {
-                if (cur_use.find(*reg_w) == cur_use.end()) {
-                    cur_def.insert(*reg_w);
+                int id = get_id(*reg_w);
+                if (use_stamp[id] != bid && def_stamp[id] != bid) {
+                    def_stamp[id] = bid;
+                    block_def[bid].push_back(id);
                 }
             }
         }
     }
+
+    // 从未出现在任何 USE 中的寄存器不会跨块活跃, 不参与数据流求解
+    regs.clear();
+    std::vector<int> dense_id(all_regs.size(), -1);
+    for (size_t id = 0; id < all_regs.size(); ++id) {
+        if (is_global[id]) {
+            dense_id[id] = regs.size();
+            regs.push_back(all_regs[id]);
+        }
+    }
+
+    IN.assign(max_id + 1, {});
+    OUT.assign(max_id + 1, {});
+    DEF.assign(max_id + 1, {});
+    USE.assign(max_id + 1, {});
+    for (int bid = 0; bid <= max_id; ++bid) {
+        IN[bid].resize(regs.size());
+        OUT[bid].resize(regs.size());
+        DEF[bid].resize(regs.size());
+        USE[bid].resize(regs.size());
+        for (auto id : block_use[bid]) {
+            USE[bid].set(dense_id[id]);
+        }
+        for (auto id : block_def[bid]) {
+            if (dense_id[id] != -1) {
+                DEF[bid].set(dense_id[id]);
+            }
+        }
+    }
+
+    // 逆后序, 从入口不可达的块放在最后
+    rpo.clear();
+    std::vector<char> visited(max_id + 1, 0);
+    std::vector<std::pair<int, size_t>> st;
+    if (max_id >= 0) {
+        st.push_back({0, 0});
+        visited[0] = 1;
+    }
+    while (!st.empty()) {
+        auto &[u, next] = st.back();
+        auto &succs = mcfg->GetSuccessorsByBlockId(u);
+        if (next < succs.size()) {
+            int v = succs[next++]->Mblock->getLabelId();
+            if (!visited[v]) {
+                visited[v] = 1;
+                st.push_back({v, 0});
+            }
+        } else {
+            rpo.push_back(u);
+            st.pop_back();
+        }
+    }
+    std::reverse(rpo.begin(), rpo.end());
+    for (auto block : blocks) {
+        if (!visited[block->getLabelId()]) {
+            rpo.push_back(block->getLabelId());
+        }
+    }
 }
 
 void Liveness::Execute() {
     UpdateDefUse();
 
-    OUT.clear();
-    IN.clear();
-
     auto mcfg = current_func->getMachineCFG();
-    bool changed = 1;
-    // 基于数据流分析的活跃变量分析
-    while (changed) {
-        changed = 0;
-        // 顺序遍历每个基本块
-        auto seq_it = mcfg->getSeqScanIterator();
-        seq_it->open();
-        while (seq_it->hasNext()) {
-            auto node = seq_it->next();
-            std::set<Register> out;
-            int cur_id = node->Mblock->getLabelId();
-            for (auto succ : mcfg->GetSuccessorsByBlockId(cur_id)) {
-                out = SetUnion<Register>(out, IN[succ->Mblock->getLabelId()]);
-            }
-            if (out != OUT[cur_id]) {
-                OUT[cur_id] = out;
-            }
-            std::set<Register> in = SetUnion<Register>(USE[cur_id], SetDiff<Register>(OUT[cur_id], DEF[cur_id]));
-            if (in != IN[cur_id]) {
-                changed = 1;
-                IN[cur_id] = in;
+    // 活跃变量分析是逆向数据流, 按逆后序的逆序(近似后序)初始化工作表, 使后继尽量先于前驱被处理
+    std::deque<int> worklist(rpo.rbegin(), rpo.rend());
+    std::vector<char> in_worklist(IN.size(), 0);
+    for (auto bid : rpo) {
+        in_worklist[bid] = 1;
+    }
+    while (!worklist.empty()) {
+        int cur_id = worklist.front();
+        worklist.pop_front();
+        in_worklist[cur_id] = 0;
+
+        // IN 只会单调增大, 因此 OUT 可以直接在原有结果上求并
+        for (auto succ : mcfg->GetSuccessorsByBlockId(cur_id)) {
+            OUT[cur_id].UnionWith(IN[succ->Mblock->getLabelId()]);
+        }
+        if (IN[cur_id].AssignTransfer(USE[cur_id], OUT[cur_id], DEF[cur_id])) {
+            for (auto pred : mcfg->GetPredecessorsByBlockId(cur_id)) {
+                int pred_id = pred->Mblock->getLabelId();
+                if (!in_worklist[pred_id]) {
+                    in_worklist[pred_id] = 1;
+                    worklist.push_back(pred_id);
+                }
             }
         }
     }
-}
\ No newline at end of file
+}
@@ -1,53 +1,75 @@
 #include "physical_register.h"
 #include "liveinterval.h"
-bool PhysicalRegistersAllocTools::OccupyReg(int phy_id, LiveInterval interval) {
-    // 你需要保证interval不与phy_id已有的冲突
-    // 或者增加判断分配失败返回false的代码
+#include <algorithm>
+#include <iterator>
+
+bool RegisterOccupancy::Overlap(const LiveInterval &interval) const {
+    for (auto &seg : interval) {
+        // ranges 互不相交, begin 不超过 seg.last() 的最后一个区间就是唯一可能与 seg 重叠的区间
+        auto it = ranges.upper_bound(seg.last());
+        if (it == ranges.begin()) {
+            continue;
+        }
+        --it;
+        if (it->second >= seg.begin) {
+            return true;
+        }
+    }
+    return false;
+}
 
-    auto occupies = phy_occupied[phy_id];
-    if (occupies.empty()) {
-        // 如果当前物理寄存器的使用区间为空，则可以分配
-        phy_occupied[phy_id].push_back(interval);
-    } else {
-        // 遍历所有占据的区间，只要有冲突就返回 false
-        for (auto ival : occupies) {
-            if (ival & interval) {
-                return false;
+void RegisterOccupancy::Insert(const LiveInterval &interval) {
+    for (auto &seg : interval) {
+        int begin = seg.begin, last = seg.last();
+        // 与前后相邻的区间合并, 保持 ranges 互不相交
+        auto it = ranges.upper_bound(last);
+        while (it != ranges.begin()) {
+            auto prev = std::prev(it);
+            if (prev->second + 1 < begin) {
+                break;
             }
+            begin = std::min(begin, prev->first);
+            last = std::max(last, prev->second);
+            ranges.erase(prev);
         }
-        phy_occupied[phy_id].push_back(interval);
+        ranges[begin] = last;
     }
+    intervals.push_back(interval);
+}
+
+bool PhysicalRegistersAllocTools::OccupyReg(int phy_id, const LiveInterval &interval) {
+    // 你需要保证interval不与phy_id已有的冲突
+    // 或者增加判断分配失败返回false的代码
+
+    // 只要与已占据的区间有冲突就返回 false
+    if (phy_occupied[phy_id].Overlap(interval)) {
+        return false;
+    }
+    phy_occupied[phy_id].Insert(interval);
     return true;
 }
 
-bool PhysicalRegistersAllocTools::ReleaseReg(int phy_id, LiveInterval interval) { TODO("ReleaseReg"); }
+bool PhysicalRegistersAllocTools::ReleaseReg(int phy_id, const LiveInterval &interval) { TODO("ReleaseReg"); }
 
-bool PhysicalRegistersAllocTools::OccupyMem(int offset, LiveInterval interval) {
+bool PhysicalRegistersAllocTools::OccupyMem(int offset, const LiveInterval &interval) {
     // TODO("OccupyMem");
 
     // offset /= 4;
     while (offset >= mem_occupied.size()) {
         mem_occupied.push_back({});
     }
-    auto occupies = mem_occupied[offset];
-    if (occupies.empty()) {
-        mem_occupied[offset].push_back(interval);
-    } else {
-        for (auto ival : occupies) {
-            if (ival & interval) {
-                return false;
-            }
-        }
-        mem_occupied[offset].push_back(interval);
+    if (mem_occupied[offset].Overlap(interval)) {
+        return false;
     }
+    mem_occupied[offset].Insert(interval);
     return true;
 }
-bool PhysicalRegistersAllocTools::ReleaseMem(int offset, LiveInterval interval) {
+bool PhysicalRegistersAllocTools::ReleaseMem(int offset, const LiveInterval &interval) {
     TODO("ReleaseMem");
     return true;
 }
 
-int PhysicalRegistersAllocTools::getIdleReg(LiveInterval interval) {
+int PhysicalRegistersAllocTools::getIdleReg(const LiveInterval &interval) {
     // TODO("getIdleReg");
 
     // 获取可用的物理寄存器
@@ -61,7 +83,7 @@ int PhysicalRegistersAllocTools::getIdleReg(LiveInterval interval) {
     }
     return -1;
 }
-int PhysicalRegistersAllocTools::getIdleMem(LiveInterval interval) {
+int PhysicalRegistersAllocTools::getIdleMem(const LiveInterval &interval) {
     // TODO("getIdleMem");
 
     if (mem_occupied.empty()) {
@@ -85,10 +107,10 @@ int PhysicalRegistersAllocTools::swapRegspill(int p_reg1, LiveInterval interval1
     return 0;
 }
 
-std::vector<LiveInterval> PhysicalRegistersAllocTools::getConflictIntervals(LiveInterval interval) {
+std::vector<LiveInterval> PhysicalRegistersAllocTools::getConflictIntervals(const LiveInterval &interval) {
     std::vector<LiveInterval> result;
-    for (auto phy_intervals : phy_occupied) {
-        for (auto other_interval : phy_intervals) {
+    for (auto &phy_intervals : phy_occupied) {
+        for (auto &other_interval : phy_intervals.GetIntervals()) {
             if (interval.getReg().type == other_interval.getReg().type && (interval & other_interval)) {
                 result.push_back(other_interval);
             }
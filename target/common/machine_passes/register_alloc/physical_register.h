@@ -1,8 +1,27 @@
 #ifndef PHYSICAL_REGISTER_INFO
 #define PHYSICAL_REGISTER_INFO
 #include "liveinterval.h"
+#include <map>
 #include <vector>
 
+// 一个物理寄存器(或一个栈槽)的占用情况
+// ranges 是所有占用者活跃区间的并集, 以互不相交的闭区间 begin -> last 存储,
+// 冲突检测对新区间的每一段只需在 ranges 中二分一次, 与占用者的数量无关
+class RegisterOccupancy {
+private:
+    std::map<int, int> ranges{};
+    std::vector<LiveInterval> intervals{};
+
+public:
+    // 检测interval是否与已有的占用冲突
+    bool Overlap(const LiveInterval &interval) const;
+    // 加入新的占用者, 调用前需保证不冲突
+    void Insert(const LiveInterval &interval);
+    bool empty() const { return intervals.empty(); }
+    // 所有占用者的活跃区间
+    const std::vector<LiveInterval> &GetIntervals() const { return intervals; }
+};
+
 // 维护物理寄存器以及溢出寄存器对内存的占用情况
 class PhysicalRegistersAllocTools {
     /*该类中有一些函数需要你自己实现，如果你认为这些成员函数不符合你的需求，
@@ -13,14 +32,14 @@ private:
 protected:
     // 物理寄存器占用情况
     // phy_occupied[phy_id] = {interval1, interval2, ...} 表示物理寄存器phy_id在interval1, interval2...中被占用
-    std::vector<std::vector<LiveInterval>> phy_occupied;
+    std::vector<RegisterOccupancy> phy_occupied;
 
     // 内存占用情况
     // mem_occupied[offset] = {interval1, interval2, ...} 表示内存offset在interval1, interval2...中被占用
-    std::vector<std::vector<LiveInterval>> mem_occupied;
+    std::vector<RegisterOccupancy> mem_occupied;
 
     // 由区间获取所有合法的物理寄存器(不考虑活跃区间是否冲突)
-    virtual std::vector<int> getValidRegs(LiveInterval interval) = 0;
+    virtual std::vector<int> getValidRegs(const LiveInterval &interval) = 0;
 
     // 由物理寄存器获取所有的别名物理寄存器
     // 例子1：RISCV中，a0是a0的别名；RISCV中，只有寄存器和寄存器自己构成别名
@@ -36,26 +55,26 @@ public:
     }
 
     // 将区间inteval分配到物理寄存器phy_id,返回是否成功
-    bool OccupyReg(int phy_id, LiveInterval interval);
+    bool OccupyReg(int phy_id, const LiveInterval &interval);
     // 释放物理寄存器,返回是否成功
-    bool ReleaseReg(int phy_id, LiveInterval interval);
+    bool ReleaseReg(int phy_id, const LiveInterval &interval);
 
     // 将区间inteval分配到内存,返回是否成功
-    bool OccupyMem(int offset, LiveInterval interval);
+    bool OccupyMem(int offset, const LiveInterval &interval);
     // 释放内存,返回是否成功
-    bool ReleaseMem(int offset, LiveInterval interval);
+    bool ReleaseMem(int offset, const LiveInterval &interval);
 
     // 获取空闲的（活跃区间不冲突的）物理寄存器, 返回物理寄存器编号
-    int getIdleReg(LiveInterval interval);
+    int getIdleReg(const LiveInterval &interval);
     // 获取空闲的（活跃区间不冲突的）内存, 返回栈上的offset
-    int getIdleMem(LiveInterval interval);
+    int getIdleMem(const LiveInterval &interval);
 
     // 交换分配结果（必须是一个溢出，一个不溢出), 用于在线性扫描的过程中选择溢出寄存器
     int swapRegspill(int p_reg1, LiveInterval interval1, int offset_spill2, int size, LiveInterval interval2);
 
     // 获得所有活跃区间与interval冲突的、已经分配在同数据类型的物理寄存器中的活跃区间
     // 用于在寄存器分配过程中选择溢出区间
-    std::vector<LiveInterval> getConflictIntervals(LiveInterval interval);
+    std::vector<LiveInterval> getConflictIntervals(const LiveInterval &interval);
 
     // 获取所有溢出寄存器占用内存大小之和
     int getSpillSize() {
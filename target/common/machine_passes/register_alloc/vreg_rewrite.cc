@@ -2,13 +2,13 @@
 
 void VirtualRegisterRewrite::Execute() {
     for (auto func : unit->functions) {
-        current_func = func;
-        ExecuteInFunc();
+        ExecuteInFunc(func);
     }
 }
 
-void VirtualRegisterRewrite::ExecuteInFunc() {
-    auto func = current_func;
+void VirtualRegisterRewrite::ExecuteInFunc(MachineFunction *func) {
+    current_func = func;
+    auto &maps = alloc_result.find(func)->second;
     auto block_it = func->getMachineCFG()->getSeqScanIterator();
     block_it->open();
     while (block_it->hasNext()) {
@@ -18,7 +18,6 @@ void VirtualRegisterRewrite::ExecuteInFunc() {
             // 根据alloc_result将ins的虚拟寄存器重写为物理寄存器
             // TODO("VirtualRegisterRewrite");
 
-            auto maps = alloc_result.find(func)->second;
             // for (auto [k, v] : maps) {
             //     std::cout << k.reg_no << "->" << v.phy_reg_no << "\n";
             // }
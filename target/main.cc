@@ -2,10 +2,7 @@
 #include "../ir_gen/semant.h"
 #include "../parser/SysY_parser.tab.h"
 
-#include "../optimize/transform/mem2reg.h"
-#include "../optimize/transform/simplify_cfg.h"
-
-#include "../optimize/analysis/dominator_tree.h"
+#include "../optimize/pass_manager.h"
 
 #include "./common/machine_passes/register_alloc/fast_linear_scan/fast_linear_scan.h"
 #include "./riscv64gc/instruction_print/riscv64_printer.h"
@@ -13,12 +10,26 @@
 #include "./riscv64gc/instruction_select/riscv64_lowerframe.h"
 #include "./riscv64gc/riscv64.h"
 
+#include "../include/compile_cache.h"
+#include "../include/ir_binary.h"
+#include "../include/ir_parser.h"
+#include "../include/output_buffer.h"
+#include "../include/parallel.h"
+#include "../include/time_report.h"
+
 #include <assert.h>
+#include <cerrno>
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
+#include <fcntl.h>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <memory>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #define ALIGNED_FORMAT_OUTPUT_HEAD(STR, CISU, PROP, STR3, STR4)                                                        \
     fout << std::fixed << std::setprecision(12) << std::setw(15) << std::left << STR << " " << std::setw(20)           \
@@ -32,20 +43,23 @@
 
 extern LLVMIR llvmIR;
 extern Program ast_root;
-extern FILE *yyin;
+typedef struct yy_buffer_state *YY_BUFFER_STATE;
+extern YY_BUFFER_STATE yy_scan_buffer(char *base, size_t size);
 extern int error_num;
 int line_number = 0;
 int col_number = 0;
 int cur_col_number = 0;
 std::ofstream fout;
 IdTable id_table;
+TimeReport time_report;
+CompileCache compile_cache;
 extern int yylex();
 extern YYSTYPE yylval;
 extern char *yytext;
 extern std::vector<std::string> error_msgs;
 void PrintLexerResult(std::ostream &s, char *yytext, YYSTYPE yylval, int token);
 
-/* 框架目前并没有对内存泄漏问题进行处理(例如没有编写语法树的析构函数)
+/* 框架目前并没有对内存泄漏问题进行完整的处理(语法树已经改为在中间代码生成之后整体释放, 见ast_arena)
    如果你只是想完成本学期的编译实验作业，可以忽略内存泄漏的问题，统一在编译结束后由操作系统帮忙回收
    如果你对自己有更高的要求或者对此感兴趣，可以尝试自己编写相关函数来解决内存泄漏问题
    将裸指针换为智能指针也许是个简单快捷的解决方案(虽然会对程序性能造成较大的影响)
@@ -79,23 +93,223 @@ void PrintLexerResult(std::ostream &s, char *yytext, YYSTYPE yylval, int token);
 -parser
 -llvm
 -S
-SysYc -S -o *.s *.sy (-O1)
+SysYc -S -o *.s *.sy|*.ll|snapshot (-O1) (-j N) (-time-report[=FILE.json]) (-passes=a,b,...)
+        (-cache-dir=DIR) (-cache-size=MB) (-save-ir=FILE)
 */
 
 enum Target { ARMV7 = 1, RV64GC = 2 } target;
 
 bool optimize_flag = false;
 
-int main(int argc, char **argv) {
-    target = RV64GC;
+// 中端的pass流水线, 未指定时根据是否开启O1使用默认流水线
+const char *passes = nullptr;
 
-    FILE *fin = fopen(argv[file_in], "r");
-    if (fin == NULL) {
-        std::cerr << "Could not open input file " << argv[file_in] << std::endl;
-        exit(1);
+// 执行完中端流水线后保存中间代码快照的文件
+const char *save_ir = nullptr;
+
+// 中端的函数级pass和后端使用的线程数, 通过 -j N 指定, -j 0 表示使用所有处理器核心
+int parallel_jobs = 1;
+
+/*
+    -time-report 在编译结束时向stderr输出各阶段和各函数的耗时与内存变化
+    -time-report=FILE 以JSON格式写入FILE
+    -passes=a,b,c 按顺序执行指定的中端pass, 代替-O1对应的默认流水线
+    -cache-dir=DIR 使用DIR作为按函数的编译缓存(见compile_cache.h), -cache-size=MB 指定缓存目录的大小上限
+    -save-ir=FILE 执行完中端流水线后将中间代码以二进制格式(见ir_binary.h)写入FILE
+        输入文件为这样的快照时跳过前端, 直接从快照继续执行, 通过-passes=指定之后的流水线
+    输入文件的扩展名为.ll时, 读取-llvm输出的文本中间代码(见ir_parser.h), 同样跳过前端
+*/
+void ParseOptions(int argc, char **argv) {
+    const char *cache_dir = nullptr;
+    long long cache_size = CompileCache::DEFAULT_SIZE_MB;
+    for (int i = optimize_tag; i < argc; i++) {
+        if (strcmp(argv[i], "-O1") == 0) {
+            optimize_flag = true;
+        } else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+            parallel_jobs = atoi(argv[++i]);
+        } else if (strncmp(argv[i], "-j", 2) == 0) {
+            parallel_jobs = atoi(argv[i] + 2);
+        } else if (strcmp(argv[i], "-time-report") == 0) {
+            time_report.Enable("");
+        } else if (strncmp(argv[i], "-time-report=", 13) == 0) {
+            time_report.Enable(argv[i] + 13);
+        } else if (strncmp(argv[i], "-passes=", 8) == 0) {
+            passes = argv[i] + 8;
+        } else if (strncmp(argv[i], "-cache-dir=", 11) == 0) {
+            cache_dir = argv[i] + 11;
+        } else if (strncmp(argv[i], "-cache-size=", 12) == 0) {
+            cache_size = atoll(argv[i] + 12);
+        } else if (strncmp(argv[i], "-save-ir=", 9) == 0) {
+            save_ir = argv[i] + 9;
+        }
     }
-    yyin = fin;
-    fout.open(argv[file_out]);
+    parallel_jobs = ResolveJobs(parallel_jobs);
+    if (cache_dir != nullptr && strcmp(argv[step_tag], "-S") == 0) {
+        compile_cache.Enable(cache_dir, cache_size);
+        // 中间代码已经体现了-O1和-passes的效果, 这里仍然将它们加入键, 避免不同选项的结果互相影响
+        std::string flags = "rv64gc";
+        flags += optimize_flag ? " -O1" : " -O0";
+        flags += passes != nullptr ? std::string(" -passes=") + passes : "";
+        compile_cache.SetContext(flags);
+    }
+}
+
+/*
+    后端按函数并行: 函数之间在指令选择之后互不依赖, 每个线程领取一个函数,
+    依次完成指令选择、LowerFrame、寄存器分配、LowerStack并输出到该函数自己的缓冲区
+    全部完成后按函数顺序拼接缓冲区, 因此输出与串行执行完全相同
+    开启编译缓存时, 先以函数的中间代码查找缓存, 命中的函数直接使用保存的汇编, 未命中的函数输出后写入缓存
+    函数使用的最大寄存器编号决定了后端新建虚拟寄存器的编号, 也会影响输出, 因此一并加入键
+*/
+void EmitAssemblyParallel(MachineUnit *m_unit, int jobs, OutputBuffer &out) {
+    std::vector<std::pair<FuncDefInstruction, CFG *>> funcs;
+    for (auto defI : llvmIR.function_order) {
+        funcs.push_back({defI, llvmIR.llvm_cfg[defI]});
+    }
+    std::vector<OutputBuffer> buffers(funcs.size());
+    m_unit->global_def = llvmIR.global_def;
+    m_unit->functions.resize(funcs.size());
+
+    // 每个线程私有的pass状态
+    struct Worker {
+        RiscV64Selector selector;
+        RiscV64RegisterAllocTools regs;
+        RiscV64Spiller spiller;
+        FastLinearScan allocator;
+        Worker(MachineUnit *m_unit) : selector(m_unit, &llvmIR), allocator(m_unit, &regs, &spiller) {}
+    };
+    std::vector<std::unique_ptr<Worker>> workers;
+    for (int i = 0; i < jobs; i++) {
+        workers.push_back(std::make_unique<Worker>(m_unit));
+    }
+
+    // 每个函数依次经过后端的各个阶段, 函数级的耗时按阶段分别记录
+    ParallelFor(jobs, funcs.size(), [&](size_t i, int worker) {
+        auto &w = *workers[worker];
+        std::string name = funcs[i].first->GetFunctionName();
+        std::string key;
+        if (compile_cache.IsEnabled()) {
+            TimeReport::FunctionScope timer(time_report, "CacheLookup", name);
+            OutputBuffer ir;
+            ir << "max_reg " << funcs[i].second->max_reg << "\n";
+            llvmIR.printFunctionIR(ir, funcs[i].first);
+            key = compile_cache.MakeKey(ir.View());
+            std::string code;
+            if (compile_cache.Lookup(key, code)) {
+                buffers[i] << code;
+                llvmIR.ReleaseFunction(funcs[i].first);
+                return;
+            }
+        }
+        MachineFunction *func;
+        {
+            TimeReport::FunctionScope timer(time_report, "InstSelect", name);
+            func = w.selector.SelectFunction(funcs[i].first, funcs[i].second);
+            m_unit->functions[i] = func;
+        }
+        {
+            TimeReport::FunctionScope timer(time_report, "LowerFrame", name);
+            RiscV64LowerFrame(m_unit).ExecuteInFunc(func);
+        }
+        {
+            TimeReport::FunctionScope timer(time_report, "FastLinearScan", name);
+            w.allocator.ExecuteInFunc(func);
+        }
+        {
+            TimeReport::FunctionScope timer(time_report, "LowerStack", name);
+            RiscV64LowerStack(m_unit).ExecuteInFunc(func);
+        }
+        {
+            TimeReport::FunctionScope timer(time_report, "emit", name);
+            RiscV64Printer(buffers[i], m_unit).emitFunction(func);
+        }
+        func->ReleaseInstructions();
+        if (compile_cache.IsEnabled()) {
+            TimeReport::FunctionScope timer(time_report, "CacheStore", name);
+            compile_cache.Store(key, buffers[i].View());
+        }
+    });
+    compile_cache.Trim();
+
+    RiscV64Printer printer(out, m_unit);
+    printer.emitHeader();
+    out.WriteBuffers(buffers);
+    printer.emitGlobals();
+}
+
+/*
+    将输入文件映射到内存, 词法分析直接在映射的内存上进行(yy_scan_buffer), 不再经过FILE和flex自己的缓冲区
+    yy_scan_buffer要求缓冲区末尾有两个'\0', 并且词法分析时会临时修改缓冲区, 因此使用可写的私有映射
+    先映射一段全为0的匿名内存, 再将文件映射到其开头, 这样即使文件大小恰好是页大小的整数倍, 末尾的'\0'也是可访问的
+    管道等不是普通文件的输入没有确定的大小, 也不能映射, 读入堆上的缓冲区
+*/
+static char *ReadInputStream(int fd, size_t &size) {
+    size_t capacity = 1 << 16;
+    char *buf = (char *)malloc(capacity);
+    size = 0;
+    while (buf != nullptr) {
+        if (capacity - size <= 2) {
+            char *new_buf = (char *)realloc(buf, capacity * 2);
+            if (new_buf == nullptr) {
+                break;
+            }
+            buf = new_buf;
+            capacity *= 2;
+        }
+        // 保留末尾两个'\0'的位置
+        ssize_t n = read(fd, buf + size, capacity - size - 2);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0) {
+            break;
+        }
+        if (n == 0) {
+            buf[size] = buf[size + 1] = '\0';
+            close(fd);
+            return buf;
+        }
+        size += n;
+    }
+    free(buf);
+    close(fd);
+    return nullptr;
+}
+
+char *MapInputFile(const char *path, size_t &size) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return nullptr;
+    }
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        close(fd);
+        return nullptr;
+    }
+    if (!S_ISREG(st.st_mode)) {
+        return ReadInputStream(fd, size);
+    }
+    size = st.st_size;
+    char *base = (char *)mmap(nullptr, size + 2, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) {
+        close(fd);
+        return nullptr;
+    }
+    if (size > 0 && mmap(base, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED) {
+        munmap(base, size + 2);
+        close(fd);
+        return nullptr;
+    }
+    close(fd);
+    return base;
+}
+
+/*
+    前端: 词法分析、语法分析、类型检查和中间代码生成
+    -lexer/-parser/-semant或者输入有错误时, 输出结果后返回false, 编译到此结束
+*/
+bool RunFrontEnd(char **argv, char *input, size_t input_size) {
+    yy_scan_buffer(input, input_size + 2);
     line_number = 1;
 
     if (strcmp(argv[step_tag], "-lexer") == 0) {
@@ -114,14 +328,17 @@ int main(int argc, char **argv) {
             PrintLexerResult(fout, yytext, yylval, token);
         }
         fout.close();
-        return 0;
+        return false;
+    }
+    {
+        TimeReport::Scope timer(time_report, "parse");
+        yyparse();
     }
-    yyparse();
 
     if (error_num > 0) {
         fout << "Parser error" << std::endl;
         fout.close();
-        return 0;
+        return false;
     }
 
     if (strcmp(argv[step_tag], "-parser") == 0) {
@@ -132,60 +349,153 @@ int main(int argc, char **argv) {
         */
         ast_root->printAST(fout, 0);
         fout.close();
-        return 0;
+        return false;
     }
 
-    ast_root->TypeCheck();
+    {
+        TimeReport::Scope timer(time_report, "TypeCheck");
+        ast_root->TypeCheck();
+    }
     if (error_msgs.size() > 0) {
         for (auto msg : error_msgs) {
             fout << msg << std::endl;
         }
         fout.close();
-        return 0;
+        return false;
     }
 
     if (strcmp(argv[step_tag], "-semant") == 0) {
         ast_root->printAST(fout, 0);
-        return 0;
+        return false;
+    }
+
+    {
+        TimeReport::Scope timer(time_report, "codeIR");
+        ast_root->codeIR();
     }
+    // 之后的阶段只使用中间代码, 释放语法树以降低后端运行时的内存峰值
+    ast_arena.Release();
+    ast_root = nullptr;
+    return true;
+}
 
-    ast_root->codeIR();
+int main(int argc, char **argv) {
+    target = RV64GC;
+    ParseOptions(argc, argv);
+    if (time_report.IsEnabled()) {
+        std::atexit([] { time_report.Print(); });
+    }
+
+    size_t input_size = 0;
+    char *input = MapInputFile(argv[file_in], input_size);
+    if (input == nullptr) {
+        std::cerr << "Could not open input file " << argv[file_in] << std::endl;
+        exit(1);
+    }
+    fout.open(argv[file_out]);
+    // 输入为中间代码(快照或.ll)时跳过前端
+    bool from_snapshot = IsIRBinary(input, input_size);
+    bool from_ir = from_snapshot || IsIRTextFile(argv[file_in]);
+    if (from_ir) {
+        if (strcmp(argv[step_tag], "-lexer") == 0 || strcmp(argv[step_tag], "-parser") == 0 ||
+            strcmp(argv[step_tag], "-semant") == 0) {
+            std::cerr << argv[file_in] << " is an IR file, " << argv[step_tag] << " is not available" << std::endl;
+            exit(1);
+        }
+        TimeReport::Scope timer(time_report, "LoadIR");
+        std::string error;
+        bool ok = from_snapshot ? LoadIRBinary(llvmIR, input, input_size, error)
+                                : ParseIRText(llvmIR, input, input_size, error);
+        if (!ok) {
+            std::cerr << "Invalid IR file " << argv[file_in] << ": " << error << std::endl;
+            exit(1);
+        }
+    } else if (!RunFrontEnd(argv, input, input_size)) {
+        return 0;
+    }
 
     // 当你完成控制流图建立后，将下面注释取消
-    llvmIR.CFGInit();
+    {
+        TimeReport::Scope timer(time_report, "CFGInit");
+        llvmIR.CFGInit(!from_ir);
+    }
 
     // 对于AnalysisPass后续应该由TransformPass更新信息, 维护Analysis的正确性
     // (例如在执行完SimplifyCFG后，需要保证控制流图依旧是正确的)
 
-    // 当你完成消除不可达基本块和指令后，将下面注释取消
-    SimplifyCFGPass(&llvmIR).Execute();
-    // 消除不可达基本块和指令在不开启O1的情况也需要进行，原因是这属于基本优化
+    // 中端的函数级pass与后端使用相同的线程数
+    IRPass::SetJobs(parallel_jobs);
 
-    optimize_flag = (argc == 6 && (strcmp(argv[optimize_tag], "-O1") == 0));
-    if (optimize_flag) {
-        DomAnalysis dom(&llvmIR);
-        dom.Execute();    // 完成支配树建立后，取消该行代码的注释
-        (Mem2RegPass(&llvmIR, &dom)).Execute();
+    // 消除不可达基本块和指令在不开启O1的情况也需要进行，原因是这属于基本优化
+    // 新的pass在optimize/pass_manager.cc中注册, 并加入默认流水线或通过-passes=使用
+    {
+        PassManager pm(&llvmIR);
+        std::string unknown;
+        if (!pm.Parse(passes == nullptr ? PassManager::DefaultPipeline(optimize_flag) : passes, unknown)) {
+            std::cerr << "Unknown pass " << unknown << ", available passes: " << PassManager::AvailablePasses()
+                      << std::endl;
+            exit(1);
+        }
+        pm.Run();
+    }
+    if (save_ir != nullptr) {
+        TimeReport::Scope timer(time_report, "SaveIR");
+        if (!SaveIRBinary(llvmIR, save_ir)) {
+            exit(1);
+        }
+    }
 
-        // TODO: add more passes
+    // 中间代码和汇编代码不经过fout, 由OutputBuffer整块写入输出文件
+    fout.close();
+    int out_fd = open(argv[file_out], O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (out_fd < 0) {
+        std::cerr << "Could not open output file " << argv[file_out] << std::endl;
+        exit(1);
     }
+    OutputBuffer out(out_fd);
 
     if (strcmp(argv[step_tag], "-llvm") == 0) {
-        llvmIR.printIR(fout);
-        fout.close();
+        TimeReport::Scope timer(time_report, "printIR");
+        llvmIR.printIR(out);
+        out.Flush();
+        close(out_fd);
         return 0;
     }
-    if (strcmp(argv[step_tag], "-S") == 0) {
+
+    if (strcmp(argv[step_tag], "-S") == 0 && (parallel_jobs > 1 || compile_cache.IsEnabled())) {
+        TimeReport::Scope timer(time_report, "backend");
+        EmitAssemblyParallel(new RiscV64Unit(), parallel_jobs, out);
+    } else if (strcmp(argv[step_tag], "-S") == 0) {
         MachineUnit *m_unit = new RiscV64Unit();
         RiscV64RegisterAllocTools regs;
         RiscV64Spiller spiller;
 
-        RiscV64Selector(m_unit, &llvmIR).SelectInstructionAndBuildCFG();
-        RiscV64LowerFrame(m_unit).Execute();
+        {
+            TimeReport::Scope timer(time_report, "InstSelect");
+            RiscV64Selector(m_unit, &llvmIR).SelectInstructionAndBuildCFG();
+        }
+        {
+            TimeReport::Scope timer(time_report, "LowerFrame");
+            RiscV64LowerFrame(m_unit).Execute();
+        }
+        {
+            TimeReport::Scope timer(time_report, "FastLinearScan");
+            FastLinearScan(m_unit, &regs, &spiller).Execute();
+        }
+        {
+            TimeReport::Scope timer(time_report, "LowerStack");
+            RiscV64LowerStack(m_unit).Execute();
+        }
+        {
+            TimeReport::Scope timer(time_report, "emit");
+            RiscV64Printer(out, m_unit).emit();
+            out.Flush();
+        }
 
-        FastLinearScan(m_unit, &regs, &spiller).Execute();
-        RiscV64LowerStack(m_unit).Execute();
-        RiscV64Printer(fout, m_unit).emit();
+        // 汇编已经输出, 整体释放每个函数的指令池
+        for (auto func : m_unit->functions) {
+            func->ReleaseInstructions();
+        }
     }
     if (strcmp(argv[step_tag], "-select") == 0) {
         MachineUnit *m_unit = new RiscV64Unit();
@@ -193,8 +503,14 @@ int main(int argc, char **argv) {
         RiscV64Selector(m_unit, &llvmIR).SelectInstructionAndBuildCFG();
         RiscV64LowerFrame(m_unit).Execute();
 
-        RiscV64Printer(fout, m_unit).emit();
+        RiscV64Printer(out, m_unit).emit();
+
+        // 汇编已经输出, 整体释放每个函数的指令池
+        for (auto func : m_unit->functions) {
+            func->ReleaseInstructions();
+        }
     }
-    fout.close();
+    out.Flush();
+    close(out_fd);
     return 0;
 }
@@ -1,8 +1,31 @@
 #include "riscv64_printer.h"
+#include "../../../include/time_report.h"
 #include <algorithm>
 #include <assert.h>
+#include <string>
+#include <string_view>
 #include <vector>
 
+// 预先计算的指令助记符(包含用于对齐的制表符)和物理寄存器名, 输出时直接拷贝, 不需要再计算长度
+static const std::vector<std::string> MnemonicTable = [] {
+    std::vector<std::string> table(RISCV_FNEG_D + 1);
+    for (int op = 0; op <= RISCV_FNEG_D; op++) {
+        if (OpTable[op].name != nullptr) {
+            table[op] = OpTable[op].name;
+            table[op] += strlen(OpTable[op].name) <= 3 ? "\t\t\t" : "\t\t";
+        }
+    }
+    return table;
+}();
+
+static const std::vector<std::string_view> RegisterNameTable = [] {
+    std::vector<std::string_view> table(RISCV_spilled_in_memory + 1);
+    for (int reg = 0; reg <= RISCV_spilled_in_memory; reg++) {
+        table[reg] = RiscV64Registers[reg].name;
+    }
+    return table;
+}();
+
 bool isMemFormatOp(int opcode) {
     return opcode == RISCV_LB || opcode == RISCV_LBU || opcode == RISCV_LH || opcode == RISCV_LHU ||
            opcode == RISCV_LW || opcode == RISCV_LWU || opcode == RISCV_LD || opcode == RISCV_FLW ||
@@ -11,17 +34,17 @@ bool isMemFormatOp(int opcode) {
 
 template <> void RiscV64Printer::printRVfield<Register *>(Register *printee) {
     if (!printee->is_virtual) {
-        s << RiscV64Registers[printee->reg_no].name;
+        s << RegisterNameTable[printee->reg_no];
     } else {
-        s << "%" << printee->reg_no;
+        s << '%' << printee->reg_no;
     }
 }
 
 template <> void RiscV64Printer::printRVfield<Register>(Register printee) {
     if (!printee.is_virtual) {
-        s << RiscV64Registers[printee.reg_no].name;
+        s << RegisterNameTable[printee.reg_no];
     } else {
-        s << "%" << printee.reg_no;
+        s << '%' << printee.reg_no;
     }
 }
 
@@ -33,7 +56,7 @@ template <> void RiscV64Printer::printRVfield<RiscVLabel *>(RiscVLabel *ins) {
             s << "%lo(" << ins->name << ")";
         }
     } else {
-        s << "." << current_func->getFunctionName() << "_" << ins->jmp_label_id;
+        s << '.' << current_func->getFunctionName() << "_" << ins->jmp_label_id;
     }
 }
 
@@ -45,7 +68,7 @@ template <> void RiscV64Printer::printRVfield<RiscVLabel>(RiscVLabel ins) {
             s << "%lo(" << ins.name << ")";
         }
     } else {
-        s << "." << current_func->getFunctionName() << "_" << ins.jmp_label_id;
+        s << '.' << current_func->getFunctionName() << "_" << ins.jmp_label_id;
     }
 }
 
@@ -64,21 +87,18 @@ template <> void RiscV64Printer::printRVfield<MachineBaseOperand *>(MachineBaseO
 
 template <> void RiscV64Printer::printAsm<MachineBaseInstruction *>(MachineBaseInstruction *ins);
 template <> void RiscV64Printer::printAsm<RiscV64Instruction *>(RiscV64Instruction *ins) {
-    s << OpTable[ins->getOpcode()].name << "\t\t";
-    if (strlen(OpTable[ins->getOpcode()].name) <= 3) {
-        s << "\t";
-    }
+    s << MnemonicTable[ins->getOpcode()];
     switch (OpTable[ins->getOpcode()].ins_formattype) {
     case RvOpInfo::R_type:
         printRVfield(ins->getRd());
-        s << ",";
+        s << ',';
         printRVfield(ins->getRs1());
-        s << ",";
+        s << ',';
         printRVfield(ins->getRs2());
         break;
     case RvOpInfo::R2_type:
         printRVfield(ins->getRd());
-        s << ",";
+        s << ',';
         printRVfield(ins->getRs1());
         if (ins->getOpcode() == RISCV_FCVT_W_S || ins->getOpcode() == RISCV_FCVT_WU_S) {
             s << ",rtz";
@@ -86,19 +106,19 @@ template <> void RiscV64Printer::printAsm<RiscV64Instruction *>(RiscV64Instructi
         break;
     case RvOpInfo::R4_type:
         printRVfield(ins->getRd());
-        s << ",";
+        s << ',';
         printRVfield(ins->getRs1());
-        s << ",";
+        s << ',';
         printRVfield(ins->getRs2());
-        s << ",";
+        s << ',';
         printRVfield(ins->getRs3());
         break;
     case RvOpInfo::I_type:
         printRVfield(ins->getRd());
-        s << ",";
+        s << ',';
         if (!isMemFormatOp(ins->getOpcode())) {
             printRVfield(ins->getRs1());
-            s << ",";
+            s << ',';
             if (ins->getUseLabel()) {
                 printRVfield(ins->getLabel());
             } else {
@@ -110,28 +130,28 @@ template <> void RiscV64Printer::printAsm<RiscV64Instruction *>(RiscV64Instructi
             } else {
                 s << ins->getImm();
             }
-            s << "(";
+            s << '(';
             printRVfield(ins->getRs1());
-            s << ")";
+            s << ')';
         }
         break;
     case RvOpInfo::S_type:
         printRVfield(ins->getRs1());
-        s << ",";
+        s << ',';
         if (ins->getUseLabel()) {
             printRVfield(ins->getLabel());
         } else {
             s << ins->getImm();
         }
-        s << "(";
+        s << '(';
         printRVfield(ins->getRs2());
-        s << ")";
+        s << ')';
         break;
     case RvOpInfo::B_type:
         printRVfield(ins->getRs1());
-        s << ",";
+        s << ',';
         printRVfield(ins->getRs2());
-        s << ",";
+        s << ',';
         if (ins->getUseLabel()) {
             printRVfield(ins->getLabel());
         } else {
@@ -140,7 +160,7 @@ template <> void RiscV64Printer::printAsm<RiscV64Instruction *>(RiscV64Instructi
         break;
     case RvOpInfo::U_type:
         printRVfield(ins->getRd());
-        s << ",";
+        s << ',';
         if (ins->getUseLabel()) {
             printRVfield(ins->getLabel());
         } else {
@@ -149,7 +169,7 @@ template <> void RiscV64Printer::printAsm<RiscV64Instruction *>(RiscV64Instructi
         break;
     case RvOpInfo::J_type:
         printRVfield(ins->getRd());
-        s << ",";
+        s << ',';
         if (ins->getUseLabel()) {
             printRVfield(ins->getLabel());
         } else {
@@ -170,7 +190,7 @@ template <> void RiscV64Printer::printAsm<MachinePhiInstruction *>(MachinePhiIns
     printRVfield(ins->GetResult());
     s << " = " << ins->GetResult().type.toString() << " PHI ";
     for (auto [label, op] : ins->GetPhiList()) {
-        s << "[";
+        s << '[';
         printRVfield(op);
         s << ",%L" << label;
         s << "] ";
@@ -195,80 +215,112 @@ void RiscV64Printer::SyncFunction(MachineFunction *func) { current_func = func;
 void RiscV64Printer::SyncBlock(MachineBlock *block) { cur_block = block; }
 
 void RiscV64Printer::emit() {
+    emitHeader();
+    for (auto func : printee->functions) {
+        TimeReport::FunctionScope timer(time_report, func->getFunctionName());
+        emitFunction(func);
+    }
+    emitGlobals();
+}
+
+void RiscV64Printer::emitHeader() {
     s << "\t.text\n\t.globl main\n";
     s << "\t.attribute arch, \"rv64i2p1_m2p0_a2p1_f2p2_d2p2_c2p0_zicsr2p0_zifencei2p0_zba1p0_zbb1p0\"\n";
-    for (auto func : printee->functions) {
-        current_func = func;
-        s << func->getFunctionName() << ":\n";
+}
 
-        // 这里直接采用顺序输出的方式，当然这种汇编代码布局效率非常低下，你可以自行编写一个更好的代码布局方法
-        // 你可以搜索指令cache, 软件分支预测等关键字来了解代码布局的作用及方法
+void RiscV64Printer::emitFunction(MachineFunction *func) {
+    current_func = func;
+    s << func->getFunctionName() << ":\n";
 
-        // std::vector<RiscV64Instruction *> alloca_insts;
-        // std::vector<RiscV64Instruction *> free_insts;
+    // 这里直接采用顺序输出的方式，当然这种汇编代码布局效率非常低下，你可以自行编写一个更好的代码布局方法
+    // 你可以搜索指令cache, 软件分支预测等关键字来了解代码布局的作用及方法
 
-        // auto size = func->GetStackSize();
-        // if (size > 2047) {
-        //     while (size > 2047) {
-        //         auto alloca_st =
-        //         rvconstructor->ConstructIImm(RISCV_ADDI, GetPhysicalReg(RISCV_sp), GetPhysicalReg(RISCV_sp), -1 *
-        //         2047); size -= 2047; alloca_insts.push_back(alloca_st);
+    // std::vector<RiscV64Instruction *> alloca_insts;
+    // std::vector<RiscV64Instruction *> free_insts;
 
-        //         auto free_st =
-        //         rvconstructor->ConstructIImm(RISCV_ADDI, GetPhysicalReg(RISCV_sp), GetPhysicalReg(RISCV_sp), 2047);
-        //         free_insts.push_back(free_st);
-        //     }
-        // }
-        // auto alloca_st =
-        // rvconstructor->ConstructIImm(RISCV_ADDI, GetPhysicalReg(RISCV_sp), GetPhysicalReg(RISCV_sp), -1 * size);
-        // alloca_insts.push_back(alloca_st);
+    // auto size = func->GetStackSize();
+    // if (size > 2047) {
+    //     while (size > 2047) {
+    //         auto alloca_st =
+    //         rvconstructor->ConstructIImm(RISCV_ADDI, GetPhysicalReg(RISCV_sp), GetPhysicalReg(RISCV_sp), -1 *
+    //         2047); size -= 2047; alloca_insts.push_back(alloca_st);
 
-        // auto free_st =
-        // rvconstructor->ConstructIImm(RISCV_ADDI, GetPhysicalReg(RISCV_sp), GetPhysicalReg(RISCV_sp), size);
-        // free_insts.push_back(free_st);
+    //         auto free_st =
+    //         rvconstructor->ConstructIImm(RISCV_ADDI, GetPhysicalReg(RISCV_sp), GetPhysicalReg(RISCV_sp), 2047);
+    //         free_insts.push_back(free_st);
+    //     }
+    // }
+    // auto alloca_st =
+    // rvconstructor->ConstructIImm(RISCV_ADDI, GetPhysicalReg(RISCV_sp), GetPhysicalReg(RISCV_sp), -1 * size);
+    // alloca_insts.push_back(alloca_st);
 
-        // auto free_st = rvconstructor->ConstructIImm(RISCV_ADDI, GetPhysicalReg(RISCV_sp), GetPhysicalReg(RISCV_sp),
-        // func->GetStackSize());
+    // auto free_st =
+    // rvconstructor->ConstructIImm(RISCV_ADDI, GetPhysicalReg(RISCV_sp), GetPhysicalReg(RISCV_sp), size);
+    // free_insts.push_back(free_st);
 
-        // for (auto ins : alloca_insts) {
-        //     func->blocks[0]->push_front(ins);
-        // }
+    // auto free_st = rvconstructor->ConstructIImm(RISCV_ADDI, GetPhysicalReg(RISCV_sp), GetPhysicalReg(RISCV_sp),
+    // func->GetStackSize());
 
-        // auto end = func->blocks[func->blocks.size() - 1]->end();
-        // end--;
-        // func->blocks[func->blocks.size() - 1]->insert(end, free_st);
+    // for (auto ins : alloca_insts) {
+    //     func->blocks[0]->push_front(ins);
+    // }
 
-        // for (auto ret_block : func->ret_blocks) {
-        //     for (auto &block : func->blocks) {
-        //         if (block == ret_block) {
-        //             auto end = block->end();
-        //             end--;
-        //             for (auto ins : free_insts) {
-        //                 block->insert(end, ins);
-        //             }
-        //         }
-        //     }
-        // }
+    // auto end = func->blocks[func->blocks.size() - 1]->end();
+    // end--;
+    // func->blocks[func->blocks.size() - 1]->insert(end, free_st);
 
-        for (auto block : func->blocks) {
-            int block_id = block->getLabelId();
-            s << "." << func->getFunctionName() << "_" << block_id << ":\n";
-            cur_block = block;
-            for (auto ins : *block) {
-                if (ins->arch == MachineBaseInstruction::RiscV) {
-                    s << "\t";
-                    printAsm((RiscV64Instruction *)ins);
-                    s << "\n";
-                } else if (ins->arch == MachineBaseInstruction::PHI) {
-                    s << "\t";
-                    printAsm((MachinePhiInstruction *)ins);
-                    s << "\n";
-                } else {
-                    ERROR("Unexpected arch");
-                }
+    // for (auto ret_block : func->ret_blocks) {
+    //     for (auto &block : func->blocks) {
+    //         if (block == ret_block) {
+    //             auto end = block->end();
+    //             end--;
+    //             for (auto ins : free_insts) {
+    //                 block->insert(end, ins);
+    //             }
+    //         }
+    //     }
+    // }
+
+    for (auto block : func->blocks) {
+        int block_id = block->getLabelId();
+        s << '.' << func->getFunctionName() << "_" << block_id << ":\n";
+        cur_block = block;
+        for (auto ins : *block) {
+            if (ins->arch == MachineBaseInstruction::RiscV) {
+                s << '\t';
+                printAsm((RiscV64Instruction *)ins);
+                s << '\n';
+            } else if (ins->arch == MachineBaseInstruction::PHI) {
+                s << '\t';
+                printAsm((MachinePhiInstruction *)ins);
+                s << '\n';
+            } else {
+                ERROR("Unexpected arch");
             }
         }
     }
+}
+
+// 只输出非0元素, 相邻非0元素之间以及末尾连续的0合并为一条.zero, 耗时只与非0元素的个数有关
+template <class T> void RiscV64Printer::emitArrayInitVals(const SparseArray<T> &vals, const std::vector<int> &dims) {
+    long long size = 1;
+    for (auto dim : dims) {
+        size *= dim;
+    }
+    long long next = 0;
+    for (auto [index, val] : vals.NonZeros()) {
+        if ((long long)index > next) {
+            s << "\t.zero\t" << ((long long)index - next) * 4 << "\n";
+        }
+        s << "\t.word\t" << *(int *)&val << "\n";
+        next = index + 1;
+    }
+    if (size > next) {
+        s << "\t.zero\t" << (size - next) * 4 << "\n";
+    }
+}
+
+void RiscV64Printer::emitGlobals() {
     s << "\t.data\n";    // 输出全局变量定义指令
     for (auto global : printee->global_def) {
         if (global->GetOpcode() == BasicInstruction::GLOBAL_VAR) {
@@ -284,29 +336,7 @@ void RiscV64Printer::emit() {
                         s << "\t.word\t0\n";
                     }
                 } else {
-                    int zero_cum = 0;
-                    for (auto val : global_ins->arrayval.IntInitVals) {
-                        if (val == 0) {
-                            zero_cum += 4;
-                        } else {
-                            if (zero_cum != 0) {
-                                s << "\t.zero\t" << zero_cum << "\n";
-                                zero_cum = 0;
-                            }
-                            s << "\t.word\t" << val << "\n";
-                        }
-                    }
-                    if (global_ins->arrayval.IntInitVals.empty()) {
-                        int prod = 1;
-                        for (auto dim : global_ins->arrayval.dims) {
-                            prod *= dim;
-                        }
-                        s << "\t.zero\t" << prod * 4 << "\n";
-                    }
-                    if (zero_cum != 0) {
-                        s << "\t.zero\t" << zero_cum << "\n";
-                        zero_cum = 0;
-                    }
+                    emitArrayInitVals(global_ins->arrayval.IntInitVals, global_ins->arrayval.dims);
                 }
             } else if (global_ins->type == BasicInstruction::FLOAT32) {
                 if (global_ins->arrayval.dims.empty()) {
@@ -319,29 +349,7 @@ void RiscV64Printer::emit() {
                         s << "\t.word\t0\n";
                     }
                 } else {
-                    int zero_cum = 0;
-                    for (auto val : global_ins->arrayval.FloatInitVals) {
-                        if (val == 0) {
-                            zero_cum += 4;
-                        } else {
-                            if (zero_cum != 0) {
-                                s << "\t.zero\t" << zero_cum << "\n";
-                                zero_cum = 0;
-                            }
-                            s << "\t.word\t" << *(int *)&val << "\n";
-                        }
-                    }
-                    if (global_ins->arrayval.FloatInitVals.empty()) {
-                        int prod = 1;
-                        for (auto dim : global_ins->arrayval.dims) {
-                            prod *= dim;
-                        }
-                        s << "\t.zero\t" << prod * 4 << "\n";
-                    }
-                    if (zero_cum != 0) {
-                        s << "\t.zero\t" << zero_cum << "\n";
-                        zero_cum = 0;
-                    }
+                    emitArrayInitVals(global_ins->arrayval.FloatInitVals, global_ins->arrayval.dims);
                 }
             } else if (global_ins->type == BasicInstruction::I64) {
                 Assert(global_ins->arrayval.dims.empty());
@@ -6,11 +6,17 @@ class RiscV64Printer : public MachinePrinter {
 private:
 public:
     void emit();
+    // emit = emitHeader + 依次emitFunction + emitGlobals
+    // 每个函数的输出只依赖该函数本身, 可以由不同的Printer输出到各自的缓冲区后再按顺序拼接
+    void emitHeader();
+    void emitFunction(MachineFunction *func);
+    void emitGlobals();
     void SyncFunction(MachineFunction *func);
     void SyncBlock(MachineBlock *block);
-    RiscV64Printer(std::ostream &s, MachineUnit *printee) : MachinePrinter(s, printee) {}
+    RiscV64Printer(OutputBuffer &s, MachineUnit *printee) : MachinePrinter(s, printee) {}
 
     template <class INSPTR> void printAsm(INSPTR ins);
     template <class FIELDORPTR> void printRVfield(FIELDORPTR);
+    template <class T> void emitArrayInitVals(const SparseArray<T> &vals, const std::vector<int> &dims);
 };
 #endif
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "riscv64_instSelect.h"
+#include "../../../include/time_report.h"
 #include <sstream>
 #include <utility>
 #include <vector>
@@ -1638,70 +1639,81 @@ void RiscV64Selector::SelectInstructionAndBuildCFG() {
     // 指令选择除了一些函数调用约定必须遵守的情况需要物理寄存器，其余情况必须均为虚拟寄存器
     dest->global_def = IR->global_def;
     // 遍历每个LLVM IR函数
-    for (auto [defI, cfg] : IR->llvm_cfg) {
-        if (cfg == nullptr) {
-            ERROR("LLVMIR CFG is Empty, you should implement BuildCFG in MidEnd first");
-        }
-        std::string name = cfg->function_def->GetFunctionName();
-
-        cur_func = new RiscV64Function(name);
-        cur_func->SetParent(dest);
-        // 你可以使用cur_func->GetNewRegister来获取新的虚拟寄存器
-        dest->functions.push_back(cur_func);
-
-        auto cur_mcfg = new MachineCFG;
-        cur_func->SetMachineCFG(cur_mcfg);
-
-        // 清空指令选择状态(可能需要自行添加初始化操作)
-        ClearFunctionSelectState();
-
-        // TODO: 添加函数参数(推荐先阅读一下riscv64_lowerframe.cc中的代码和注释)
-        // See MachineFunction::AddParameter()
-        // TODO("Add function parameter if you need");
-
-        for (int i = 0; i < defI->formals.size(); i++) {
-            // std::cout << "here\n";
-            if (defI->formals[i] == BasicInstruction::I32 || defI->formals[i] == BasicInstruction::PTR) {
-                cur_func->AddParameter(Register(true, ((RegOperand *)defI->formals_reg[i])->GetRegNo(), INT64, false));
-            } else if (defI->formals[i] == BasicInstruction::FLOAT32) {
-                cur_func->AddParameter(
-                Register(true, ((RegOperand *)defI->formals_reg[i])->GetRegNo(), FLOAT64, false));
-            } else {
-                TODO("异常");
-            }
+    for (auto defI : IR->function_order) {
+        CFG *cfg = IR->llvm_cfg[defI];
+        TimeReport::FunctionScope timer(time_report, defI->GetFunctionName());
+        dest->functions.push_back(SelectFunction(defI, cfg));
+    }
+}
+
+MachineFunction *RiscV64Selector::SelectFunction(FuncDefInstruction defI, CFG *cfg) {
+    if (cfg == nullptr) {
+        ERROR("LLVMIR CFG is Empty, you should implement BuildCFG in MidEnd first");
+    }
+    std::string name = cfg->function_def->GetFunctionName();
+
+    cur_func = new RiscV64Function(name);
+    cur_func->SetParent(dest);
+    // 中间代码寄存器直接作为虚拟寄存器使用, 新建的虚拟寄存器编号需要大于它们
+    cur_func->ReserveRegNo(cfg->max_reg + 1);
+    rvconstructor->SetInstructionPool(&cur_func->GetInstructionPool());
+    // 你可以使用cur_func->GetNewRegister来获取新的虚拟寄存器
+
+    auto cur_mcfg = new MachineCFG;
+    cur_func->SetMachineCFG(cur_mcfg);
+
+    // 清空指令选择状态(可能需要自行添加初始化操作)
+    ClearFunctionSelectState();
+
+    // TODO: 添加函数参数(推荐先阅读一下riscv64_lowerframe.cc中的代码和注释)
+    // See MachineFunction::AddParameter()
+    // TODO("Add function parameter if you need");
+
+    for (int i = 0; i < defI->formals.size(); i++) {
+        // std::cout << "here\n";
+        if (defI->formals[i] == BasicInstruction::I32 || defI->formals[i] == BasicInstruction::PTR) {
+            cur_func->AddParameter(Register(true, ((RegOperand *)defI->formals_reg[i])->GetRegNo(), INT64, false));
+        } else if (defI->formals[i] == BasicInstruction::FLOAT32) {
+            cur_func->AddParameter(Register(true, ((RegOperand *)defI->formals_reg[i])->GetRegNo(), FLOAT64, false));
+        } else {
+            TODO("异常");
         }
+    }
 
-        // 遍历每个LLVM IR基本块
-        for (auto [id, block] : *(cfg->block_map)) {
-            cur_block = new RiscV64Block(id);
-            // 将新块添加到Machine CFG中
-            cur_mcfg->AssignEmptyNode(id, cur_block);
-            cur_func->UpdateMaxLabel(id);
+    // 遍历每个LLVM IR基本块
+    for (auto [id, block] : *(cfg->block_map)) {
+        cur_block = new RiscV64Block(id);
+        // 将新块添加到Machine CFG中
+        cur_mcfg->AssignEmptyNode(id, cur_block);
+        cur_func->UpdateMaxLabel(id);
 
-            cur_block->setParent(cur_func);
-            cur_func->blocks.push_back(cur_block);
+        cur_block->setParent(cur_func);
+        cur_func->blocks.push_back(cur_block);
 
-            // 指令选择主要函数, 请注意指令选择时需要维护变量cur_offset
-            for (auto instruction : block->Instruction_list) {
-                // Log("Selecting Instruction");
-                ConvertAndAppend<Instruction>(instruction);
-            }
+        // 指令选择主要函数, 请注意指令选择时需要维护变量cur_offset
+        for (auto instruction : block->Instruction_list) {
+            // Log("Selecting Instruction");
+            ConvertAndAppend<Instruction>(instruction);
         }
+    }
 
-        // RISCV 8字节对齐（）
-        if (cur_offset % 8 != 0) {
-            cur_offset = ((cur_offset + 7) / 8) * 8;
-        }
-        cur_func->SetStackSize(cur_offset + cur_func->GetParaSize());
+    // RISCV 8字节对齐（）
+    if (cur_offset % 8 != 0) {
+        cur_offset = ((cur_offset + 7) / 8) * 8;
+    }
+    cur_func->SetStackSize(cur_offset + cur_func->GetParaSize());
 
-        // 控制流图连边
-        for (int i = 0; i < cfg->G.size(); i++) {
-            const auto &arcs = cfg->G[i];
-            for (auto arc : arcs) {
-                cur_mcfg->MakeEdge(i, arc->block_id);
-            }
+    // 控制流图连边
+    for (int i = 0; i < cfg->G.size(); i++) {
+        const auto &arcs = cfg->G[i];
+        for (auto arc : arcs) {
+            cur_mcfg->MakeEdge(i, arc->block_id);
         }
     }
+
+    // 该函数的中间代码已经全部翻译为机器指令, 释放其占用的内存
+    IR->ReleaseFunction(defI);
+    return cur_func;
 }
 
 void RiscV64Selector::ClearFunctionSelectState() {
@@ -26,6 +26,9 @@ private:
 public:
     RiscV64Selector(MachineUnit *dest, LLVMIR *IR) : MachineSelector(dest, IR) {}
     void SelectInstructionAndBuildCFG();
+    // 对单个函数进行指令选择并建立机器CFG, 返回的函数尚未加入MachineUnit
+    // 不同函数的指令选择互不影响, 每个线程使用各自的Selector即可并行地选择不同函数
+    MachineFunction *SelectFunction(FuncDefInstruction defI, CFG *cfg);
     void ClearFunctionSelectState();
     template <class INSPTR> void ConvertAndAppend(INSPTR);
 
@@ -1,5 +1,6 @@
 #include "riscv64_lowerframe.h"
 #include "../../common/machine_instruction_structures/machine.h"
+#include "../../../include/time_report.h"
 
 #ifdef PRINT_DBG
 #include "../instruction_print/riscv64_printer.h"
@@ -24,52 +25,56 @@ constexpr int saveregnum = 25;
 
 void RiscV64LowerFrame::Execute() {
     for (auto func : unit->functions) {
-        current_func = func;
-        for (auto &b : func->blocks) {
-            cur_block = b;
-            if (b->getLabelId() == 0) {
-                Register para_basereg = current_func->GetNewReg(INT64);
-                int i32_cnt = 0;
-                int f32_cnt = 0;
-                int para_offset = 0;
-                for (auto para : func->GetParameters()) {
-                    if (para.type.data_type == INT64.data_type) {
-                        if (i32_cnt < 8) {
-                            b->push_front(
-                            rvconstructor->ConstructR(RISCV_ADD, para, GetPhysicalReg(RISCV_a0 + i32_cnt),
-                                                      GetPhysicalReg(RISCV_x0)));
-                        }
-                        if (i32_cnt >= 8) {
-                            b->push_front(
-                            rvconstructor->ConstructIImm(RISCV_LD, para, GetPhysicalReg(RISCV_fp), para_offset));
-                            para_offset += 8;
-                        }
-                        i32_cnt++;
-                    } else if (para.type.data_type == FLOAT64.data_type) {
-                        if (f32_cnt < 8) {
-                            auto fp_zero = current_func->GetNewReg(FLOAT64);
-                            auto s2fp_inst =
-                            rvconstructor->ConstructR2(RISCV_FMV_W_X, fp_zero, GetPhysicalReg(RISCV_x0));
-                            b->push_front(rvconstructor->ConstructR(RISCV_FADD_S, para,
-                                                                    GetPhysicalReg(RISCV_fa0 + f32_cnt), fp_zero));
-                            b->push_front(s2fp_inst);
-                        }
-                        if (f32_cnt >= 8) {
-                            b->push_front(
-                            rvconstructor->ConstructIImm(RISCV_FLD, para, GetPhysicalReg(RISCV_fp), para_offset));
-                            para_offset += 8;
-                        }
-                        f32_cnt++;
-                    } else {
-                        ERROR("Unknown type");
+        TimeReport::FunctionScope timer(time_report, func->getFunctionName());
+        ExecuteInFunc(func);
+    }
+}
+
+void RiscV64LowerFrame::ExecuteInFunc(MachineFunction *func) {
+    current_func = func;
+    rvconstructor->SetInstructionPool(&func->GetInstructionPool());
+    for (auto &b : func->blocks) {
+        cur_block = b;
+        if (b->getLabelId() == 0) {
+            Register para_basereg = current_func->GetNewReg(INT64);
+            int i32_cnt = 0;
+            int f32_cnt = 0;
+            int para_offset = 0;
+            for (auto para : func->GetParameters()) {
+                if (para.type.data_type == INT64.data_type) {
+                    if (i32_cnt < 8) {
+                        b->push_front(rvconstructor->ConstructR(RISCV_ADD, para, GetPhysicalReg(RISCV_a0 + i32_cnt),
+                                                                GetPhysicalReg(RISCV_x0)));
+                    }
+                    if (i32_cnt >= 8) {
+                        b->push_front(
+                        rvconstructor->ConstructIImm(RISCV_LD, para, GetPhysicalReg(RISCV_fp), para_offset));
+                        para_offset += 8;
+                    }
+                    i32_cnt++;
+                } else if (para.type.data_type == FLOAT64.data_type) {
+                    if (f32_cnt < 8) {
+                        auto fp_zero = current_func->GetNewReg(FLOAT64);
+                        auto s2fp_inst = rvconstructor->ConstructR2(RISCV_FMV_W_X, fp_zero, GetPhysicalReg(RISCV_x0));
+                        b->push_front(rvconstructor->ConstructR(RISCV_FADD_S, para,
+                                                                GetPhysicalReg(RISCV_fa0 + f32_cnt), fp_zero));
+                        b->push_front(s2fp_inst);
                     }
+                    if (f32_cnt >= 8) {
+                        b->push_front(
+                        rvconstructor->ConstructIImm(RISCV_FLD, para, GetPhysicalReg(RISCV_fp), para_offset));
+                        para_offset += 8;
+                    }
+                    f32_cnt++;
+                } else {
+                    ERROR("Unknown type");
                 }
+            }
 
-                if (para_offset != 0) {
-                    current_func->SetHasInParaInStack(true);
-                    cur_block->push_front(
-                    rvconstructor->ConstructIImm(RISCV_ADDIW, para_basereg, GetPhysicalReg(RISCV_fp), 0));
-                }
+            if (para_offset != 0) {
+                current_func->SetHasInParaInStack(true);
+                cur_block->push_front(
+                rvconstructor->ConstructIImm(RISCV_ADDIW, para_basereg, GetPhysicalReg(RISCV_fp), 0));
             }
         }
     }
@@ -151,90 +156,96 @@ void RiscV64LowerStack::Execute() {
 
     // Log("RiscV64LowerStack");
     for (auto func : unit->functions) {
-        current_func = func;
-        std::vector<std::vector<int>> saveregs_occurblockids, saveregs_rwblockids;
-        GatherUseSregs(func, saveregs_occurblockids, saveregs_rwblockids);
-
-        int saveregnum = 0;
-        for (int i = 0; i < saveregs_occurblockids.size(); i++) {
-            if (!saveregs_rwblockids[i].empty()) {
-                saveregnum++;
-            }
+        TimeReport::FunctionScope timer(time_report, func->getFunctionName());
+        ExecuteInFunc(func);
+    }
+
+    // 到此我们就完成目标代码生成的所有工作了
+}
+
+void RiscV64LowerStack::ExecuteInFunc(MachineFunction *func) {
+    current_func = func;
+    rvconstructor->SetInstructionPool(&func->GetInstructionPool());
+    std::vector<std::vector<int>> saveregs_occurblockids, saveregs_rwblockids;
+    GatherUseSregs(func, saveregs_occurblockids, saveregs_rwblockids);
+
+    int saveregnum = 0;
+    for (int i = 0; i < saveregs_occurblockids.size(); i++) {
+        if (!saveregs_rwblockids[i].empty()) {
+            saveregnum++;
         }
-        func->AddStackSize(saveregnum * 8);
-
-        for (auto &b : func->blocks) {
-            cur_block = b;
-            if (b->getLabelId() == 0) {
-                if (func->GetStackSize() <= 2032) {
-                    b->push_front(rvconstructor->ConstructIImm(RISCV_ADDI, GetPhysicalReg(RISCV_sp),
-                                                               GetPhysicalReg(RISCV_sp),
-                                                               -func->GetStackSize()));    // sub sp
-                } else {
-                    auto stacksz_reg = GetPhysicalReg(RISCV_t0);
-                    b->push_front(rvconstructor->ConstructR(RISCV_SUB, GetPhysicalReg(RISCV_sp),
-                                                            GetPhysicalReg(RISCV_sp), stacksz_reg));
-                    b->push_front(rvconstructor->ConstructUImm(RISCV_LI, stacksz_reg, func->GetStackSize()));
-                }
-                if (func->HasInParaInStack()) {
-                    b->push_front(rvconstructor->ConstructR(RISCV_ADD, GetPhysicalReg(RISCV_fp),
-                                                            GetPhysicalReg(RISCV_sp), GetPhysicalReg(RISCV_x0)));
-                }
+    }
+    func->AddStackSize(saveregnum * 8);
 
-                int offset = 0;
-                for (int i = 0; i < 64; i++) {
-                    if (!saveregs_occurblockids[i].empty()) {
-                        int regno = i;
-                        offset -= 8;
-                        if (regno >= RISCV_x0 && regno <= RISCV_x31) {
-                            b->push_front(rvconstructor->ConstructSImm(RISCV_SD, GetPhysicalReg(regno),
-                                                                       GetPhysicalReg(RISCV_sp), offset));
-                        } else {
-                            b->push_front(rvconstructor->ConstructSImm(RISCV_FSD, GetPhysicalReg(regno),
-                                                                       GetPhysicalReg(RISCV_sp), offset));
-                        }
+    for (auto &b : func->blocks) {
+        cur_block = b;
+        if (b->getLabelId() == 0) {
+            if (func->GetStackSize() <= 2032) {
+                b->push_front(rvconstructor->ConstructIImm(RISCV_ADDI, GetPhysicalReg(RISCV_sp),
+                                                           GetPhysicalReg(RISCV_sp),
+                                                           -func->GetStackSize()));    // sub sp
+            } else {
+                auto stacksz_reg = GetPhysicalReg(RISCV_t0);
+                b->push_front(rvconstructor->ConstructR(RISCV_SUB, GetPhysicalReg(RISCV_sp),
+                                                        GetPhysicalReg(RISCV_sp), stacksz_reg));
+                b->push_front(rvconstructor->ConstructUImm(RISCV_LI, stacksz_reg, func->GetStackSize()));
+            }
+            if (func->HasInParaInStack()) {
+                b->push_front(rvconstructor->ConstructR(RISCV_ADD, GetPhysicalReg(RISCV_fp),
+                                                        GetPhysicalReg(RISCV_sp), GetPhysicalReg(RISCV_x0)));
+            }
+
+            int offset = 0;
+            for (int i = 0; i < 64; i++) {
+                if (!saveregs_occurblockids[i].empty()) {
+                    int regno = i;
+                    offset -= 8;
+                    if (regno >= RISCV_x0 && regno <= RISCV_x31) {
+                        b->push_front(rvconstructor->ConstructSImm(RISCV_SD, GetPhysicalReg(regno),
+                                                                   GetPhysicalReg(RISCV_sp), offset));
+                    } else {
+                        b->push_front(rvconstructor->ConstructSImm(RISCV_FSD, GetPhysicalReg(regno),
+                                                                   GetPhysicalReg(RISCV_sp), offset));
                     }
                 }
             }
+        }
 
-            auto last_ins = *(b->ReverseBegin());
-
-            auto riscv_last_ins = (RiscV64Instruction *)last_ins;
-            if (riscv_last_ins->getOpcode() == RISCV_JALR) {
-                if (riscv_last_ins->getRd() == GetPhysicalReg(RISCV_x0)) {
-                    if (riscv_last_ins->getRs1() == GetPhysicalReg(RISCV_ra)) {
-                        b->pop_back();
-                        if (func->GetStackSize() <= 2032) {
-                            b->push_back(rvconstructor->ConstructIImm(RISCV_ADDI, GetPhysicalReg(RISCV_sp),
-                                                                      GetPhysicalReg(RISCV_sp), func->GetStackSize()));
-                        } else {
-                            auto stacksz_reg = GetPhysicalReg(RISCV_t0);
-                            b->push_back(rvconstructor->ConstructUImm(RISCV_LI, stacksz_reg, func->GetStackSize()));
-                            b->push_back(rvconstructor->ConstructR(RISCV_ADD, GetPhysicalReg(RISCV_sp),
-                                                                   GetPhysicalReg(RISCV_sp), stacksz_reg));
-                        }
+        auto last_ins = *(b->ReverseBegin());
+
+        auto riscv_last_ins = (RiscV64Instruction *)last_ins;
+        if (riscv_last_ins->getOpcode() == RISCV_JALR) {
+            if (riscv_last_ins->getRd() == GetPhysicalReg(RISCV_x0)) {
+                if (riscv_last_ins->getRs1() == GetPhysicalReg(RISCV_ra)) {
+                    b->pop_back();
+                    if (func->GetStackSize() <= 2032) {
+                        b->push_back(rvconstructor->ConstructIImm(RISCV_ADDI, GetPhysicalReg(RISCV_sp),
+                                                                  GetPhysicalReg(RISCV_sp), func->GetStackSize()));
+                    } else {
+                        auto stacksz_reg = GetPhysicalReg(RISCV_t0);
+                        b->push_back(rvconstructor->ConstructUImm(RISCV_LI, stacksz_reg, func->GetStackSize()));
+                        b->push_back(rvconstructor->ConstructR(RISCV_ADD, GetPhysicalReg(RISCV_sp),
+                                                               GetPhysicalReg(RISCV_sp), stacksz_reg));
+                    }
 
-                        int offset = 0;
-                        for (int i = 0; i < 64; i++) {
-                            if (!saveregs_occurblockids[i].empty()) {
-                                int regno = i;
-                                offset -= 8;
-                                if (regno >= RISCV_x0 && regno <= RISCV_x31) {
-                                    b->push_back(rvconstructor->ConstructIImm(RISCV_LD, GetPhysicalReg(regno),
-                                                                              GetPhysicalReg(RISCV_sp), offset));
-                                } else {
-                                    b->push_back(rvconstructor->ConstructIImm(RISCV_FLD, GetPhysicalReg(regno),
-                                                                              GetPhysicalReg(RISCV_sp), offset));
-                                }
+                    int offset = 0;
+                    for (int i = 0; i < 64; i++) {
+                        if (!saveregs_occurblockids[i].empty()) {
+                            int regno = i;
+                            offset -= 8;
+                            if (regno >= RISCV_x0 && regno <= RISCV_x31) {
+                                b->push_back(rvconstructor->ConstructIImm(RISCV_LD, GetPhysicalReg(regno),
+                                                                          GetPhysicalReg(RISCV_sp), offset));
+                            } else {
+                                b->push_back(rvconstructor->ConstructIImm(RISCV_FLD, GetPhysicalReg(regno),
+                                                                          GetPhysicalReg(RISCV_sp), offset));
                             }
                         }
-
-                        b->push_back(riscv_last_ins);
                     }
+
+                    b->push_back(riscv_last_ins);
                 }
             }
         }
     }
-
-    // 到此我们就完成目标代码生成的所有工作了
-}
\ No newline at end of file
+}
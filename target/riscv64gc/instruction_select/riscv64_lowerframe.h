@@ -8,6 +8,7 @@ class RiscV64LowerFrame : public MachinePass {
 public:
     RiscV64LowerFrame(MachineUnit *unit) : MachinePass(unit) {}
     void Execute();
+    void ExecuteInFunc(MachineFunction *func);
     Register fromImmF(float immf, MachineBlock *bb) {
         Register tmp = current_func->GetNewReg(INT64);
         // lui t0, %hi(1066192077)  # 加载高20位
@@ -39,6 +40,7 @@ class RiscV64LowerStack : public MachinePass {
 public:
     RiscV64LowerStack(MachineUnit *unit) : MachinePass(unit) {}
     void Execute();
+    void ExecuteInFunc(MachineFunction *func);
 };
 
 #endif    // RISCV64_LOWERFRAME_H
\ No newline at end of file
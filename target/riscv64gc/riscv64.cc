@@ -1,6 +1,7 @@
 #include "riscv64.h"
 #include <assert.h>
 RiscV64InstructionConstructor RiscV64InstructionConstructor::instance;
+thread_local Arena *RiscV64InstructionConstructor::pool = nullptr;
 RiscV64InstructionConstructor *rvconstructor = RiscV64InstructionConstructor::GetConstructor();
 
 std::vector<Register *> RiscV64Instruction::GetReadReg() {
@@ -261,7 +262,7 @@ Register(false, RISCV_f28, FLOAT64), Register(false, RISCV_f29, FLOAT64), Regist
 Register(false, RISCV_f31, FLOAT64),
 };
 // 获取可分配的寄存器列表（不考虑区间冲突）
-std::vector<int> RiscV64RegisterAllocTools::getValidRegs(LiveInterval interval) {
+std::vector<int> RiscV64RegisterAllocTools::getValidRegs(const LiveInterval &interval) {
     if (interval.getReg().type.data_type == MachineDataType::INT) {
         return std::vector<int>({
         RISCV_t0, RISCV_t1, RISCV_t2, RISCV_t3, RISCV_t4, RISCV_t5,  RISCV_t6,  RISCV_a0, RISCV_a1, RISCV_a2,
@@ -287,6 +288,7 @@ Register RiscV64Spiller::GenerateReadCode(std::list<MachineBaseInstruction *>::i
     // it为指向发生寄存器溢出的指令的迭代器
     // raw_stk_offset为该寄存器溢出到栈中的位置的偏移，相对于什么位置的偏移可以在调用时自行决定
     auto read_mid_reg = function->GetNewRegister(type.data_type, type.data_length);
+    rvconstructor->SetInstructionPool(&function->GetInstructionPool());
     // TODO("GenerateReadSpillCode");
 
     int offset = raw_stk_offset + function->GetStackOffset();
@@ -305,6 +307,7 @@ Register RiscV64Spiller::GenerateReadCode(std::list<MachineBaseInstruction *>::i
 Register RiscV64Spiller::GenerateWriteCode(std::list<MachineBaseInstruction *>::iterator &it, int raw_stk_offset,
                                            MachineDataType type) {
     auto write_mid_reg = function->GetNewRegister(type.data_type, type.data_length);
+    rvconstructor->SetInstructionPool(&function->GetInstructionPool());
     // TODO("GenerateWriteSpillCode");
 
     int offset = raw_stk_offset + function->GetStackOffset();
@@ -437,6 +437,7 @@ private:
     }
 
     friend class RiscV64InstructionConstructor;
+    friend class Arena;
 
     RiscV64Instruction() : MachineBaseInstruction(MachineBaseInstruction::RiscV), imm(0), use_label(false) {}
 
@@ -471,15 +472,28 @@ public:
 class RiscV64InstructionConstructor {
     static RiscV64InstructionConstructor instance;
 
+    // 新建的指令从pool中分配, pool为当前线程正在处理的函数的指令池(见MachineFunction::GetInstructionPool)
+    // 每个线程各自记录pool, 因此多个线程可以同时为不同的函数构造指令
+    static thread_local Arena *pool;
+
     RiscV64InstructionConstructor() {}
 
+    RiscV64Instruction *NewInstruction() {
+        if (pool == nullptr) {
+            return new RiscV64Instruction();
+        }
+        return pool->New<RiscV64Instruction>();
+    }
+
 public:
     static RiscV64InstructionConstructor *GetConstructor() { return &instance; }
+    // 在为某个函数生成指令之前调用, 之后构造的指令都属于该函数, 随函数的指令池一起释放
+    void SetInstructionPool(Arena *pool) { RiscV64InstructionConstructor::pool = pool; }
     // 函数命名方法大部分与RISC-V指令格式一致
 
     // example: addw Rd, Rs1, Rs2
     RiscV64Instruction *ConstructR(int op, Register Rd, Register Rs1, Register Rs2) {
-        RiscV64Instruction *ret = new RiscV64Instruction();
+        RiscV64Instruction *ret = NewInstruction();
         ret->setOpcode(op, false);
         Assert(OpTable[op].ins_formattype == RvOpInfo::R_type);
         ret->setRd(Rd);
@@ -489,7 +503,7 @@ public:
     }
     // example: fmv.x.w Rd, Rs1
     RiscV64Instruction *ConstructR2(int op, Register Rd, Register Rs1) {
-        RiscV64Instruction *ret = new RiscV64Instruction();
+        RiscV64Instruction *ret = NewInstruction();
         ret->setOpcode(op, false);
         Assert(OpTable[op].ins_formattype == RvOpInfo::R2_type);
         ret->setRd(Rd);
@@ -498,7 +512,7 @@ public:
     }
     // example: fmadd.s Rd, Rs1, Rs2, Rs3
     RiscV64Instruction *ConstructR4(int op, Register Rd, Register Rs1, Register Rs2, Register Rs3) {
-        RiscV64Instruction *ret = new RiscV64Instruction();
+        RiscV64Instruction *ret = NewInstruction();
         ret->setOpcode(op, false);
         Assert(OpTable[op].ins_formattype == RvOpInfo::R4_type);
         ret->setRd(Rd);
@@ -510,7 +524,7 @@ public:
     // example: lw Rd, imm(Rs1)
     // example: addi Rd, Rs1, imm
     RiscV64Instruction *ConstructIImm(int op, Register Rd, Register Rs1, int imm) {
-        RiscV64Instruction *ret = new RiscV64Instruction();
+        RiscV64Instruction *ret = NewInstruction();
         ret->setOpcode(op, false);
         Assert(OpTable[op].ins_formattype == RvOpInfo::I_type);
         ret->setRd(Rd);
@@ -521,7 +535,7 @@ public:
     // example: lw Rd label(Rs1)   =>  lw Rd %lo(label_name)(Rs1)
     // example: addi Rd, Rs1, label  =>  addi Rd, Rs1, %lo(label_name)
     RiscV64Instruction *ConstructILabel(int op, Register Rd, Register Rs1, RiscVLabel label) {
-        RiscV64Instruction *ret = new RiscV64Instruction();
+        RiscV64Instruction *ret = NewInstruction();
         ret->setOpcode(op, true);
         Assert(OpTable[op].ins_formattype == RvOpInfo::I_type);
         ret->setRd(Rd);
@@ -531,7 +545,7 @@ public:
     }
     // example: sw value imm(ptr)
     RiscV64Instruction *ConstructSImm(int op, Register value, Register ptr, int imm) {
-        RiscV64Instruction *ret = new RiscV64Instruction();
+        RiscV64Instruction *ret = NewInstruction();
         ret->setOpcode(op, false);
         Assert(OpTable[op].ins_formattype == RvOpInfo::S_type);
         ret->setRs1(value);
@@ -541,7 +555,7 @@ public:
     }
     // example: sw value label(ptr)  =>  sw value %lo(label_name)(ptr)
     RiscV64Instruction *ConstructSLabel(int op, Register value, Register ptr, RiscVLabel label) {
-        RiscV64Instruction *ret = new RiscV64Instruction();
+        RiscV64Instruction *ret = NewInstruction();
         ret->setOpcode(op, true);
         Assert(OpTable[op].ins_formattype == RvOpInfo::S_type);
         ret->setRs1(value);
@@ -551,7 +565,7 @@ public:
     }
     // example: b(cond) Rs1, Rs2,label  =>  bne Rs1, Rs2, .L3(标签具体如何输出见riscv64_printasm.cc)
     RiscV64Instruction *ConstructBLabel(int op, Register Rs1, Register Rs2, RiscVLabel label) {
-        RiscV64Instruction *ret = new RiscV64Instruction();
+        RiscV64Instruction *ret = NewInstruction();
         ret->setOpcode(op, true);
         Assert(OpTable[op].ins_formattype == RvOpInfo::B_type);
         ret->setRs1(Rs1);
@@ -561,7 +575,7 @@ public:
     }
     // example: lui Rd, imm
     RiscV64Instruction *ConstructUImm(int op, Register Rd, int imm) {
-        RiscV64Instruction *ret = new RiscV64Instruction();
+        RiscV64Instruction *ret = NewInstruction();
         ret->setOpcode(op, false);
         Assert(OpTable[op].ins_formattype == RvOpInfo::U_type);
         ret->setRd(Rd);
@@ -570,7 +584,7 @@ public:
     }
     // example: lui Rd, %hi(label_name)
     RiscV64Instruction *ConstructULabel(int op, Register Rd, RiscVLabel label) {
-        RiscV64Instruction *ret = new RiscV64Instruction();
+        RiscV64Instruction *ret = NewInstruction();
         ret->setOpcode(op, true);
         Assert(OpTable[op].ins_formattype == RvOpInfo::U_type);
         ret->setRd(Rd);
@@ -579,7 +593,7 @@ public:
     }
     // example: jal rd, label  =>  jal a0, .L4
     RiscV64Instruction *ConstructJLabel(int op, Register rd, RiscVLabel label) {
-        RiscV64Instruction *ret = new RiscV64Instruction();
+        RiscV64Instruction *ret = NewInstruction();
         ret->setOpcode(op, true);
         Assert(OpTable[op].ins_formattype == RvOpInfo::J_type);
         ret->setRd(rd);
@@ -593,7 +607,7 @@ public:
     // 对于函数调用，我们单独处理这一条指令，而不是用真指令替代，原因是函数调用涉及到部分寄存器的读写
     RiscV64Instruction *ConstructCall(int op, std::string funcname, int iregnum, int fregnum) {
         Assert(OpTable[op].ins_formattype == RvOpInfo::CALL_type);
-        RiscV64Instruction *ret = new RiscV64Instruction();
+        RiscV64Instruction *ret = NewInstruction();
         ret->setOpcode(op, true);
         // ret->setRd(GetPhysicalReg(phy_rd));
         ret->setCalliregNum(iregnum);
@@ -631,7 +645,7 @@ class RiscV64Unit : public MachineUnit {};
 
 class RiscV64RegisterAllocTools : public PhysicalRegistersAllocTools {
 protected:
-    std::vector<int> getValidRegs(LiveInterval interval);
+    std::vector<int> getValidRegs(const LiveInterval &interval);
     std::vector<int> getAliasRegs(int phy_id) { return std::vector<int>({phy_id}); }
 
 public:
@@ -1,186 +1,269 @@
 #include "../include/Instruction.h"
 #include "../include/basic_block.h"
+#include <algorithm>
 #include <assert.h>
+#include <atomic>
+#include <cstring>
+#include <mutex>
 #include <unordered_map>
 
-static std::unordered_map<int, RegOperand *> RegOperandMap;
-static std::map<int, LabelOperand *> LabelOperandMap;
-static std::map<std::string, GlobalOperand *> GlobalOperandMap;
+/*
+    以编号为下标的操作数表, 中间代码优化可能按函数并行执行, 因此多个线程会同时查询和创建操作数
+    采用两级结构: 目录大小固定, 每一项指向一块定长的数组, 已经分配的块不会移动, 查询已有的操作数不需要加锁
+*/
+template <class T> class OperandIndexTable {
+private:
+    static constexpr size_t CHUNK_BITS = 12;
+    static constexpr size_t CHUNK_SIZE = 1 << CHUNK_BITS;
+    static constexpr size_t DIR_SIZE = 1 << 14;
+    static_assert(CHUNK_SIZE * DIR_SIZE == OPERAND_TABLE_SIZE);
+
+    std::atomic<std::atomic<T *> *> dir[DIR_SIZE]{};
+    std::mutex chunk_mutex;
+
+public:
+    std::atomic<T *> &Slot(size_t idx) {
+        assert(idx < CHUNK_SIZE * DIR_SIZE);
+        auto &entry = dir[idx >> CHUNK_BITS];
+        auto chunk = entry.load(std::memory_order_acquire);
+        if (chunk == nullptr) {
+            std::lock_guard<std::mutex> lock(chunk_mutex);
+            chunk = entry.load(std::memory_order_relaxed);
+            if (chunk == nullptr) {
+                chunk = new std::atomic<T *>[CHUNK_SIZE]();
+                entry.store(chunk, std::memory_order_release);
+            }
+        }
+        return chunk[idx & (CHUNK_SIZE - 1)];
+    }
+};
+
+// 创建新的操作数以及访问按值驻留的哈希表时需要持有该锁
+static std::mutex operand_mutex;
+
+// 在slot中查找操作数, 不存在时加锁创建
+template <class T, class Create> static T *GetOrCreate(std::atomic<T *> &slot, Create create) {
+    T *op = slot.load(std::memory_order_acquire);
+    if (op == nullptr) {
+        std::lock_guard<std::mutex> lock(operand_mutex);
+        op = slot.load(std::memory_order_relaxed);
+        if (op == nullptr) {
+            op = create();
+            slot.store(op, std::memory_order_release);
+        }
+    }
+    return op;
+}
+
+// 寄存器编号和标签编号都是从0开始的连续整数, 直接以编号为下标
+// RegOperandMap的下标为RegNo + 1, 用于容纳无返回值的函数调用使用的%r-1
+static OperandIndexTable<RegOperand> RegOperandMap;
+static OperandIndexTable<LabelOperand> LabelOperandMap;
+static std::unordered_map<std::string, GlobalOperand *> GlobalOperandMap;
+
+// 立即数按值驻留, 浮点数按位模式驻留(区分0.0与-0.0)
+static std::unordered_map<int, ImmI32Operand *> ImmI32OperandMap;
+static std::unordered_map<long long, ImmI64Operand *> ImmI64OperandMap;
+static std::unordered_map<unsigned int, ImmF32Operand *> ImmF32OperandMap;
+
+Arena *ir_arena = nullptr;
 
 RegOperand *GetNewRegOperand(int RegNo) {
-    auto it = RegOperandMap.find(RegNo);
-    if (it == RegOperandMap.end()) {
-        auto R = new RegOperand(RegNo);
-        RegOperandMap[RegNo] = R;
-        return R;
-    } else {
-        return it->second;
-    }
+    assert(RegNo >= -1);
+    return GetOrCreate(RegOperandMap.Slot(RegNo + 1), [RegNo]() { return new RegOperand(RegNo); });
 }
 
 LabelOperand *GetNewLabelOperand(int LabelNo) {
-    auto it = LabelOperandMap.find(LabelNo);
-    if (it == LabelOperandMap.end()) {
-        auto L = new LabelOperand(LabelNo);
-        LabelOperandMap[LabelNo] = L;
-        return L;
-    } else {
-        return it->second;
-    }
+    assert(LabelNo >= 0);
+    return GetOrCreate(LabelOperandMap.Slot(LabelNo), [LabelNo]() { return new LabelOperand(LabelNo); });
 }
 
 GlobalOperand *GetNewGlobalOperand(std::string name) {
-    auto it = GlobalOperandMap.find(name);
-    if (it == GlobalOperandMap.end()) {
-        auto G = new GlobalOperand(name);
-        GlobalOperandMap[name] = G;
-        return G;
-    } else {
-        return it->second;
+    std::lock_guard<std::mutex> lock(operand_mutex);
+    auto &G = GlobalOperandMap[name];
+    if (G == nullptr) {
+        G = new GlobalOperand(name);
+    }
+    return G;
+}
+
+ImmI32Operand *GetNewImmI32Operand(int immVal) {
+    std::lock_guard<std::mutex> lock(operand_mutex);
+    auto &I = ImmI32OperandMap[immVal];
+    if (I == nullptr) {
+        I = new ImmI32Operand(immVal);
+    }
+    return I;
+}
+
+ImmI64Operand *GetNewImmI64Operand(long long immVal) {
+    std::lock_guard<std::mutex> lock(operand_mutex);
+    auto &I = ImmI64OperandMap[immVal];
+    if (I == nullptr) {
+        I = new ImmI64Operand(immVal);
+    }
+    return I;
+}
+
+ImmF32Operand *GetNewImmF32Operand(float immVal) {
+    unsigned int bits;
+    memcpy(&bits, &immVal, sizeof(bits));
+    std::lock_guard<std::mutex> lock(operand_mutex);
+    auto &F = ImmF32OperandMap[bits];
+    if (F == nullptr) {
+        F = new ImmF32Operand(immVal);
     }
+    return F;
 }
 
 void IRgenArithmeticI32(LLVMBlock B, BasicInstruction::LLVMIROpcode opcode, int reg1, int reg2, int result_reg) {
-    B->InsertInstruction(1, new ArithmeticInstruction(opcode, BasicInstruction::LLVMType::I32, GetNewRegOperand(reg1),
-                                                      GetNewRegOperand(reg2), GetNewRegOperand(result_reg)));
+    B->InsertInstruction(1, ir_arena->New<ArithmeticInstruction>(opcode, BasicInstruction::LLVMType::I32,
+                                                                 GetNewRegOperand(reg1), GetNewRegOperand(reg2),
+                                                                 GetNewRegOperand(result_reg)));
 }
 
 void IRgenArithmeticF32(LLVMBlock B, BasicInstruction::LLVMIROpcode opcode, int reg1, int reg2, int result_reg) {
-    B->InsertInstruction(1,
-                         new ArithmeticInstruction(opcode, BasicInstruction::LLVMType::FLOAT32, GetNewRegOperand(reg1),
-                                                   GetNewRegOperand(reg2), GetNewRegOperand(result_reg)));
+    B->InsertInstruction(1, ir_arena->New<ArithmeticInstruction>(opcode, BasicInstruction::LLVMType::FLOAT32,
+                                                                 GetNewRegOperand(reg1), GetNewRegOperand(reg2),
+                                                                 GetNewRegOperand(result_reg)));
 }
 
 void IRgenArithmeticI32ImmLeft(LLVMBlock B, BasicInstruction::LLVMIROpcode opcode, int val1, int reg2, int result_reg) {
-    B->InsertInstruction(1, new ArithmeticInstruction(opcode, BasicInstruction::LLVMType::I32, new ImmI32Operand(val1),
-                                                      GetNewRegOperand(reg2), GetNewRegOperand(result_reg)));
+    B->InsertInstruction(1, ir_arena->New<ArithmeticInstruction>(opcode, BasicInstruction::LLVMType::I32,
+                                                                 GetNewImmI32Operand(val1), GetNewRegOperand(reg2),
+                                                                 GetNewRegOperand(result_reg)));
 }
 
 void IRgenArithmeticF32ImmLeft(LLVMBlock B, BasicInstruction::LLVMIROpcode opcode, float val1, int reg2,
                                int result_reg) {
-    B->InsertInstruction(1,
-                         new ArithmeticInstruction(opcode, BasicInstruction::LLVMType::FLOAT32, new ImmF32Operand(val1),
-                                                   GetNewRegOperand(reg2), GetNewRegOperand(result_reg)));
+    B->InsertInstruction(1, ir_arena->New<ArithmeticInstruction>(opcode, BasicInstruction::LLVMType::FLOAT32,
+                                                                 GetNewImmF32Operand(val1), GetNewRegOperand(reg2),
+                                                                 GetNewRegOperand(result_reg)));
 }
 
 void IRgenArithmeticI32ImmAll(LLVMBlock B, BasicInstruction::LLVMIROpcode opcode, int val1, int val2, int result_reg) {
-    B->InsertInstruction(1, new ArithmeticInstruction(opcode, BasicInstruction::LLVMType::I32, new ImmI32Operand(val1),
-                                                      new ImmI32Operand(val2), GetNewRegOperand(result_reg)));
+    B->InsertInstruction(1, ir_arena->New<ArithmeticInstruction>(opcode, BasicInstruction::LLVMType::I32,
+                                                                 GetNewImmI32Operand(val1), GetNewImmI32Operand(val2),
+                                                                 GetNewRegOperand(result_reg)));
 }
 
 void IRgenArithmeticF32ImmAll(LLVMBlock B, BasicInstruction::LLVMIROpcode opcode, float val1, float val2,
                               int result_reg) {
-    B->InsertInstruction(1,
-                         new ArithmeticInstruction(opcode, BasicInstruction::LLVMType::FLOAT32, new ImmF32Operand(val1),
-                                                   new ImmF32Operand(val2), GetNewRegOperand(result_reg)));
+    B->InsertInstruction(1, ir_arena->New<ArithmeticInstruction>(opcode, BasicInstruction::LLVMType::FLOAT32,
+                                                                 GetNewImmF32Operand(val1), GetNewImmF32Operand(val2),
+                                                                 GetNewRegOperand(result_reg)));
 }
 
 void IRgenIcmp(LLVMBlock B, BasicInstruction::IcmpCond cmp_op, int reg1, int reg2, int result_reg) {
-    B->InsertInstruction(1, new IcmpInstruction(BasicInstruction::LLVMType::I32, GetNewRegOperand(reg1),
-                                                GetNewRegOperand(reg2), cmp_op, GetNewRegOperand(result_reg)));
+    B->InsertInstruction(1, ir_arena->New<IcmpInstruction>(BasicInstruction::LLVMType::I32, GetNewRegOperand(reg1),
+                                                           GetNewRegOperand(reg2), cmp_op,
+                                                           GetNewRegOperand(result_reg)));
 }
 
 void IRgenFcmp(LLVMBlock B, BasicInstruction::FcmpCond cmp_op, int reg1, int reg2, int result_reg) {
-    B->InsertInstruction(1, new FcmpInstruction(BasicInstruction::LLVMType::FLOAT32, GetNewRegOperand(reg1),
-                                                GetNewRegOperand(reg2), cmp_op, GetNewRegOperand(result_reg)));
+    B->InsertInstruction(1, ir_arena->New<FcmpInstruction>(BasicInstruction::LLVMType::FLOAT32, GetNewRegOperand(reg1),
+                                                           GetNewRegOperand(reg2), cmp_op,
+                                                           GetNewRegOperand(result_reg)));
 }
 
 void IRgenIcmpImmRight(LLVMBlock B, BasicInstruction::IcmpCond cmp_op, int reg1, int val2, int result_reg) {
-    B->InsertInstruction(1, new IcmpInstruction(BasicInstruction::LLVMType::I32, GetNewRegOperand(reg1),
-                                                new ImmI32Operand(val2), cmp_op, GetNewRegOperand(result_reg)));
+    B->InsertInstruction(1, ir_arena->New<IcmpInstruction>(BasicInstruction::LLVMType::I32, GetNewRegOperand(reg1),
+                                                           GetNewImmI32Operand(val2), cmp_op,
+                                                           GetNewRegOperand(result_reg)));
 }
 
 void IRgenFcmpImmRight(LLVMBlock B, BasicInstruction::FcmpCond cmp_op, int reg1, float val2, int result_reg) {
-    B->InsertInstruction(1, new FcmpInstruction(BasicInstruction::LLVMType::FLOAT32, GetNewRegOperand(reg1),
-                                                new ImmF32Operand(val2), cmp_op, GetNewRegOperand(result_reg)));
+    B->InsertInstruction(1, ir_arena->New<FcmpInstruction>(BasicInstruction::LLVMType::FLOAT32, GetNewRegOperand(reg1),
+                                                           GetNewImmF32Operand(val2), cmp_op,
+                                                           GetNewRegOperand(result_reg)));
 }
 
 void IRgenFptosi(LLVMBlock B, int src, int dst) {
-    B->InsertInstruction(1, new FptosiInstruction(GetNewRegOperand(dst), GetNewRegOperand(src)));
+    B->InsertInstruction(1, ir_arena->New<FptosiInstruction>(GetNewRegOperand(dst), GetNewRegOperand(src)));
 }
 
 void IRgenSitofp(LLVMBlock B, int src, int dst) {
-    B->InsertInstruction(1, new SitofpInstruction(GetNewRegOperand(dst), GetNewRegOperand(src)));
+    B->InsertInstruction(1, ir_arena->New<SitofpInstruction>(GetNewRegOperand(dst), GetNewRegOperand(src)));
 }
 
 void IRgenZextI1toI32(LLVMBlock B, int src, int dst) {
-    B->InsertInstruction(1, new ZextInstruction(BasicInstruction::LLVMType::I32, GetNewRegOperand(dst),
-                                                BasicInstruction::LLVMType::I1, GetNewRegOperand(src)));
+    B->InsertInstruction(1, ir_arena->New<ZextInstruction>(BasicInstruction::LLVMType::I32, GetNewRegOperand(dst),
+                                                           BasicInstruction::LLVMType::I1, GetNewRegOperand(src)));
 }
 
 void IRgenGetElementptrIndexI32(LLVMBlock B, BasicInstruction::LLVMType type, int result_reg, Operand ptr,
                                 std::vector<int> dims, std::vector<Operand> indexs) {
-    B->InsertInstruction(
-    1, new GetElementptrInstruction(type, GetNewRegOperand(result_reg), ptr, dims, indexs, BasicInstruction::I32));
+    B->InsertInstruction(1, ir_arena->New<GetElementptrInstruction>(type, GetNewRegOperand(result_reg), ptr, dims,
+                                                                    indexs, BasicInstruction::I32));
 }
 
 void IRgenGetElementptrIndexI64(LLVMBlock B, BasicInstruction::LLVMType type, int result_reg, Operand ptr,
                                 std::vector<int> dims, std::vector<Operand> indexs) {
-    B->InsertInstruction(
-    1, new GetElementptrInstruction(type, GetNewRegOperand(result_reg), ptr, dims, indexs, BasicInstruction::I64));
+    B->InsertInstruction(1, ir_arena->New<GetElementptrInstruction>(type, GetNewRegOperand(result_reg), ptr, dims,
+                                                                    indexs, BasicInstruction::I64));
 }
 
 void IRgenLoad(LLVMBlock B, BasicInstruction::LLVMType type, int result_reg, Operand ptr) {
-    B->InsertInstruction(1, new LoadInstruction(type, ptr, GetNewRegOperand(result_reg)));
+    B->InsertInstruction(1, ir_arena->New<LoadInstruction>(type, ptr, GetNewRegOperand(result_reg)));
 }
 
 void IRgenStore(LLVMBlock B, BasicInstruction::LLVMType type, int value_reg, Operand ptr) {
-    B->InsertInstruction(1, new StoreInstruction(type, ptr, GetNewRegOperand(value_reg)));
+    B->InsertInstruction(1, ir_arena->New<StoreInstruction>(type, ptr, GetNewRegOperand(value_reg)));
 }
 
 void IRgenStore(LLVMBlock B, BasicInstruction::LLVMType type, Operand value, Operand ptr) {
-    B->InsertInstruction(1, new StoreInstruction(type, ptr, value));
+    B->InsertInstruction(1, ir_arena->New<StoreInstruction>(type, ptr, value));
 }
 
 void IRgenCall(LLVMBlock B, BasicInstruction::LLVMType type, int result_reg,
                std::vector<std::pair<enum BasicInstruction::LLVMType, Operand>> args, std::string name) {
-    B->InsertInstruction(1, new CallInstruction(type, GetNewRegOperand(result_reg), name, args));
+    B->InsertInstruction(1, ir_arena->New<CallInstruction>(type, GetNewRegOperand(result_reg), name, args));
 }
 
 void IRgenCallVoid(LLVMBlock B, BasicInstruction::LLVMType type,
                    std::vector<std::pair<enum BasicInstruction::LLVMType, Operand>> args, std::string name) {
-    B->InsertInstruction(1, new CallInstruction(type, GetNewRegOperand(-1), name, args));
+    B->InsertInstruction(1, ir_arena->New<CallInstruction>(type, GetNewRegOperand(-1), name, args));
 }
 
 void IRgenCallNoArgs(LLVMBlock B, BasicInstruction::LLVMType type, int result_reg, std::string name) {
-    B->InsertInstruction(1, new CallInstruction(type, GetNewRegOperand(result_reg), name));
+    B->InsertInstruction(1, ir_arena->New<CallInstruction>(type, GetNewRegOperand(result_reg), name));
 }
 
 void IRgenCallVoidNoArgs(LLVMBlock B, BasicInstruction::LLVMType type, std::string name) {
-    B->InsertInstruction(1, new CallInstruction(type, GetNewRegOperand(-1), name));
+    B->InsertInstruction(1, ir_arena->New<CallInstruction>(type, GetNewRegOperand(-1), name));
 }
 
 void IRgenRetReg(LLVMBlock B, BasicInstruction::LLVMType type, int reg) {
-    B->InsertInstruction(1, new RetInstruction(type, GetNewRegOperand(reg)));
+    B->InsertInstruction(1, ir_arena->New<RetInstruction>(type, GetNewRegOperand(reg)));
 }
 
 void IRgenRetImmInt(LLVMBlock B, BasicInstruction::LLVMType type, int val) {
-    B->InsertInstruction(1, new RetInstruction(type, new ImmI32Operand(val)));
+    B->InsertInstruction(1, ir_arena->New<RetInstruction>(type, GetNewImmI32Operand(val)));
 }
 
 void IRgenRetImmFloat(LLVMBlock B, BasicInstruction::LLVMType type, float val) {
-    B->InsertInstruction(1, new RetInstruction(type, new ImmF32Operand(val)));
+    B->InsertInstruction(1, ir_arena->New<RetInstruction>(type, GetNewImmF32Operand(val)));
 }
 
 void IRgenRetVoid(LLVMBlock B) {
-    B->InsertInstruction(1, new RetInstruction(BasicInstruction::LLVMType::VOID, nullptr));
+    B->InsertInstruction(1, ir_arena->New<RetInstruction>(BasicInstruction::LLVMType::VOID, nullptr));
 }
 
 void IRgenBRUnCond(LLVMBlock B, int dst_label) {
-    B->InsertInstruction(1, new BrUncondInstruction(GetNewLabelOperand(dst_label)));
+    B->InsertInstruction(1, ir_arena->New<BrUncondInstruction>(GetNewLabelOperand(dst_label)));
 }
 
 void IRgenBrCond(LLVMBlock B, int cond_reg, int true_label, int false_label) {
-    B->InsertInstruction(1, new BrCondInstruction(GetNewRegOperand(cond_reg), GetNewLabelOperand(true_label),
-                                                  GetNewLabelOperand(false_label)));
+    B->InsertInstruction(1, ir_arena->New<BrCondInstruction>(GetNewRegOperand(cond_reg), GetNewLabelOperand(true_label),
+                                                             GetNewLabelOperand(false_label)));
 }
 
 void IRgenAlloca(LLVMBlock B, BasicInstruction::LLVMType type, int reg) {
-    B->InsertInstruction(0, new AllocaInstruction(type, GetNewRegOperand(reg)));
+    B->InsertInstruction(0, ir_arena->New<AllocaInstruction>(type, GetNewRegOperand(reg)));
 }
 
 void IRgenAllocaArray(LLVMBlock B, BasicInstruction::LLVMType type, int reg, std::vector<int> dims) {
-    B->InsertInstruction(0, new AllocaInstruction(type, dims, GetNewRegOperand(reg)));
+    B->InsertInstruction(0, ir_arena->New<AllocaInstruction>(type, dims, GetNewRegOperand(reg)));
 }
 
 // 添加的用于修改操作数的函数
@@ -6,7 +6,7 @@
 CFG *current_CFG;
 extern int output_Physical_reg;
 
-std::ostream &operator<<(std::ostream &s, BasicInstruction::LLVMType type) {
+OutputBuffer &operator<<(OutputBuffer &s, BasicInstruction::LLVMType type) {
     switch (type) {
     case BasicInstruction::I32:
         s << "i32";
@@ -35,7 +35,7 @@ std::ostream &operator<<(std::ostream &s, BasicInstruction::LLVMType type) {
     }
     return s;
 }
-std::ostream &operator<<(std::ostream &s, BasicInstruction::LLVMIROpcode type) {
+OutputBuffer &operator<<(OutputBuffer &s, BasicInstruction::LLVMIROpcode type) {
     switch (type) {
     case BasicInstruction::LOAD:
         s << "load";
@@ -99,7 +99,7 @@ std::ostream &operator<<(std::ostream &s, BasicInstruction::LLVMIROpcode type) {
     }
     return s;
 }
-std::ostream &operator<<(std::ostream &s, BasicInstruction::IcmpCond type) {
+OutputBuffer &operator<<(OutputBuffer &s, BasicInstruction::IcmpCond type) {
     switch (type) {
     case BasicInstruction::eq:
         s << "eq";
@@ -136,7 +136,7 @@ std::ostream &operator<<(std::ostream &s, BasicInstruction::IcmpCond type) {
     }
     return s;
 }
-std::ostream &operator<<(std::ostream &s, BasicInstruction::FcmpCond type) {
+OutputBuffer &operator<<(OutputBuffer &s, BasicInstruction::FcmpCond type) {
     switch (type) {
     case BasicInstruction::FALSE:
         s << "false";
@@ -209,26 +209,41 @@ std::string LabelOperand::GetFullName() { return "%L" + std::to_string(label_no)
 
 std::string GlobalOperand::GetFullName() { return "@" + name; }
 
+void RegOperand::PrintFullName(OutputBuffer &s) { s << "%r" << reg_no; }
+
+void ImmI32Operand::PrintFullName(OutputBuffer &s) { s << immVal; }
+
+void ImmI64Operand::PrintFullName(OutputBuffer &s) { s << immVal; }
+
+void ImmF32Operand::PrintFullName(OutputBuffer &s) {
+    s << "0x";
+    s.AppendHex(GetFloatByteVal());
+}
+
+void LabelOperand::PrintFullName(OutputBuffer &s) { s << "%L" << label_no; }
+
+void GlobalOperand::PrintFullName(OutputBuffer &s) { s << '@' << name; }
+
 // @Output a operand
-std::ostream &operator<<(std::ostream &s, Operand op) {
-    s << op->GetFullName();
+OutputBuffer &operator<<(OutputBuffer &s, Operand op) {
+    op->PrintFullName(s);
     return s;
 }
 
-void LoadInstruction::PrintIR(std::ostream &s) { s << result << " = load " << type << ", ptr " << pointer << "\n"; }
-void StoreInstruction::PrintIR(std::ostream &s) {
+void LoadInstruction::PrintIR(OutputBuffer &s) { s << result << " = load " << type << ", ptr " << pointer << "\n"; }
+void StoreInstruction::PrintIR(OutputBuffer &s) {
     s << "store " << type << " " << value << ", ptr " << pointer << "\n";
 }
-void ArithmeticInstruction::PrintIR(std::ostream &s) {
+void ArithmeticInstruction::PrintIR(OutputBuffer &s) {
     s << result << " = " << opcode << " " << type << " " << op1 << "," << op2 << "\n";
 }
-void IcmpInstruction::PrintIR(std::ostream &s) {
+void IcmpInstruction::PrintIR(OutputBuffer &s) {
     s << result << " = icmp " << cond << " " << type << " " << op1 << "," << op2 << "\n";
 }
-void FcmpInstruction::PrintIR(std::ostream &s) {
+void FcmpInstruction::PrintIR(OutputBuffer &s) {
     s << result << " = fcmp " << cond << " " << type << " " << op1 << "," << op2 << "\n";
 }
-void PhiInstruction::PrintIR(std::ostream &s) {
+void PhiInstruction::PrintIR(OutputBuffer &s) {
     s << result << " = phi " << type << " ";
     for (auto it = phi_list.begin(); it != phi_list.end(); ++it) {
         s << "[" << it->second << "," << it->first << "]";
@@ -238,21 +253,23 @@ void PhiInstruction::PrintIR(std::ostream &s) {
     }
     s << '\n';
 }
-void AllocaInstruction::PrintIR(std::ostream &s) {
+void AllocaInstruction::PrintIR(OutputBuffer &s) {
     s << result << " = alloca ";
     if (dims.empty())
         s << type << "\n";    // 单个变量
     else {
         for (std::vector<int>::iterator it = dims.begin(); it != dims.end(); ++it)
             s << "[" << *it << " x ";    // 高维数组
-        s << type << std::string(dims.size(), ']') << "\n";
+        s << type;
+        s.Append(dims.size(), ']');
+        s << "\n";
     }
 }
-void BrCondInstruction::PrintIR(std::ostream &s) {
+void BrCondInstruction::PrintIR(OutputBuffer &s) {
     // br i1 <cond>, label <iftrue>, label <iffalse>
     s << "br i1 " << cond << ", label " << trueLabel << ", label " << falseLabel << "\n";
 }
-void BrUncondInstruction::PrintIR(std::ostream &s) {
+void BrUncondInstruction::PrintIR(OutputBuffer &s) {
     // br label <dest>
     s << "br label " << destLabel << "\n";
 }
@@ -261,7 +278,7 @@ void BrUncondInstruction::PrintIR(std::ostream &s) {
 // define void @DFS(i32 %0,i32 %1){
 //   Function Body
 // }
-void FunctionDefineInstruction::PrintIR(std::ostream &s) {
+void FunctionDefineInstruction::PrintIR(OutputBuffer &s) {
     // define void @FunctionName
     s << "define " << return_type << " @" << Func_name;
 
@@ -277,7 +294,7 @@ void FunctionDefineInstruction::PrintIR(std::ostream &s) {
     s << ")\n";
 }
 
-void FunctionDeclareInstruction::PrintIR(std::ostream &s) {
+void FunctionDeclareInstruction::PrintIR(OutputBuffer &s) {
     // declare void @FunctionName(i32,f32)
     s << "declare " << return_type << " @" << Func_name << "(";
     for (uint32_t i = 0; i < formals.size(); ++i) {
@@ -289,7 +306,7 @@ void FunctionDeclareInstruction::PrintIR(std::ostream &s) {
     s << ")\n";
 }
 
-void BasicBlock::printIR(std::ostream &s) {
+void BasicBlock::printIR(OutputBuffer &s) {
     s << "L" << block_id << ":  ;" << comment << "\n";
 
     for (Instruction ins : Instruction_list) {
@@ -298,7 +315,7 @@ void BasicBlock::printIR(std::ostream &s) {
     }
 }
 
-void LLVMIR::printIR(std::ostream &s) {
+void LLVMIR::printIR(OutputBuffer &s) {
     // output lib func decl
     for (Instruction lib_func_decl : function_declare) {
         lib_func_decl->PrintIR(s);
@@ -310,19 +327,22 @@ void LLVMIR::printIR(std::ostream &s) {
     }
 
     // output Functions
-    for (auto Func_Block_item : function_block_map) {    //<function,<id,block> >
-        FuncDefInstruction f = Func_Block_item.first;
+    for (FuncDefInstruction f : function_order) {
         current_CFG = llvm_cfg[f];
-        // output function Syntax
-        f->PrintIR(s);
+        printFunctionIR(s, f);
+    }
+}
 
-        // output Blocks in functions
-        s << "{\n";
-        for (auto block : Func_Block_item.second) {
-            block.second->printIR(s);
-        }
-        s << "}\n";
+void LLVMIR::printFunctionIR(OutputBuffer &s, FuncDefInstruction f) {
+    // output function Syntax
+    f->PrintIR(s);
+
+    // output Blocks in functions
+    s << "{\n";
+    for (auto block : function_block_map.at(f)) {
+        block.second->printIR(s);
     }
+    s << "}\n";
 }
 
 long long Float_to_Byte(float f) {
@@ -363,48 +383,46 @@ long long Float_to_Byte(float f) {
 
 long long ImmF32Operand::GetFloatByteVal() { return Float_to_Byte(immVal); }
 
-void recursive_print(std::ostream &s, BasicInstruction::LLVMType type, VarAttribute &v, int dimDph, int beginPos,
+void recursive_print(OutputBuffer &s, BasicInstruction::LLVMType type, VarAttribute &v, int dimDph, int beginPos,
                      int endPos) {
-    if (dimDph == 0) {
-        int allzero = 1;
-        if (v.type == 1) {
-            for (auto x : v.IntInitVals) {
-                if (x != 0) {
-                    allzero = 0;
-                    break;
-                }
-            }
-        } else {
-            for (auto x : v.FloatInitVals) {
-                if (x != 0) {
-                    allzero = 0;
-                    break;
-                }
-            }
+    // 全为0的(子)数组直接输出zeroinitializer, 不再逐个输出其中的元素
+    bool allzero =
+    v.type == 1 ? v.IntInitVals.AllZero(beginPos, endPos + 1) : v.FloatInitVals.AllZero(beginPos, endPos + 1);
+    if (dimDph == 0 && allzero) {
+        for (int dim : v.dims) {
+            s << "[" << dim << "x ";
         }
-        if (allzero) {
-            for (int dim : v.dims) {
-                s << "[" << dim << "x ";
-            }
-            s << type << std::string(v.dims.size(), ']') << " "
-              << "zeroinitializer";
-            return;
+        s << type;
+        s.Append(v.dims.size(), ']');
+        s << " "
+          << "zeroinitializer";
+        return;
+    }
+    if (beginPos != endPos && allzero) {
+        for (int i = dimDph; i < v.dims.size(); i++) {
+            s << "[" << v.dims[i] << " x ";
         }
+        s << type;
+        s.Append(v.dims.size() - dimDph, ']');
+        s << " zeroinitializer";
+        return;
     }
     if (beginPos == endPos) {
         if (type == BasicInstruction::I32) {
             s << type << " " << v.IntInitVals[beginPos];
         } else if (type == BasicInstruction::FLOAT32) {
             s << type << " "
-              << "0x" << std::hex << Float_to_Byte(v.FloatInitVals[beginPos]);
-            s << std::dec;
+              << "0x";
+            s.AppendHex(Float_to_Byte(v.FloatInitVals[beginPos]));
         }
         return;
     }
     for (int i = dimDph; i < v.dims.size(); i++) {
         s << "[" << v.dims[i] << " x ";
     }
-    s << type << std::string(v.dims.size() - dimDph, ']') << " ";
+    s << type;
+    s.Append(v.dims.size() - dimDph, ']');
+    s << " ";
     s << "[";
     int step = 1;
     for (int i = dimDph + 1; i < v.dims.size(); i++) {
@@ -419,7 +437,7 @@ void recursive_print(std::ostream &s, BasicInstruction::LLVMType type, VarAttrib
 }
 
 // Remember "\n"
-void GlobalVarDefineInstruction::PrintIR(std::ostream &s) {
+void GlobalVarDefineInstruction::PrintIR(OutputBuffer &s) {
     if (arrayval.dims.empty()) {
         if (init_val != nullptr)
             s << "@" << name << " = global " << type << " " << init_val << "\n";
@@ -447,7 +465,7 @@ Example 1:
 Example 2:
     call void @DFS(i32 0,i32 %4)
 */
-void CallInstruction::PrintIR(std::ostream &s) {
+void CallInstruction::PrintIR(OutputBuffer &s) {
     if (ret_type != LLVMType::VOID) {
         s << result << " = ";
     }
@@ -464,7 +482,7 @@ void CallInstruction::PrintIR(std::ostream &s) {
 }
 
 // Remember "\n"
-void RetInstruction::PrintIR(std::ostream &s) {
+void RetInstruction::PrintIR(OutputBuffer &s) {
     s << "ret " << ret_type;
     if (ret_val != nullptr) {
         s << " " << ret_val;
@@ -477,7 +495,7 @@ Syntax:
 <result> = getelementptr inbounds <ty>, ptr <ptrval>{, [inrange] <ty> <idx>}*
 <result> = getelementptr <ty>, <N x ptr> <ptrval>, [inrange] <vector index type> <idx>
 */
-void GetElementptrInstruction::PrintIR(std::ostream &s) {
+void GetElementptrInstruction::PrintIR(OutputBuffer &s) {
     s << result << " = getelementptr ";
     // print type
     if (dims.empty())
@@ -487,7 +505,7 @@ void GetElementptrInstruction::PrintIR(std::ostream &s) {
             s << "[" << dim << " x ";
         }
         s << type;
-        s << std::string(dims.size(), ']');
+        s.Append(dims.size(), ']');
     }
 
     // print ptrval
@@ -498,21 +516,21 @@ void GetElementptrInstruction::PrintIR(std::ostream &s) {
     s << "\n";
 }
 
-void FptosiInstruction::PrintIR(std::ostream &s) {
+void FptosiInstruction::PrintIR(OutputBuffer &s) {
     s << result << " = fptosi float"
       << " " << value << " to "
       << "i32"
       << "\n";
 }
 
-void SitofpInstruction::PrintIR(std::ostream &s) {
+void SitofpInstruction::PrintIR(OutputBuffer &s) {
     s << result << " = sitofp i32"
       << " " << value << " to "
       << "float"
       << "\n";
 }
 
-void GlobalStringConstInstruction::PrintIR(std::ostream &s) {
+void GlobalStringConstInstruction::PrintIR(OutputBuffer &s) {
     int str_len = str_val.size() + 1;
     for (char c : str_val) {
         if (c == '\\')
@@ -557,6 +575,6 @@ void GlobalStringConstInstruction::PrintIR(std::ostream &s) {
       << "\"\n";
 }
 
-void ZextInstruction::PrintIR(std::ostream &s) {
+void ZextInstruction::PrintIR(OutputBuffer &s) {
     s << result << " = zext " << from_type << " " << value << " to " << to_type << "\n";
 }
\ No newline at end of file
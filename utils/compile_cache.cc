@@ -0,0 +1,184 @@
+#include "../include/compile_cache.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+// 条目格式: MAGIC, 键的长度(十进制)和换行, 键, 汇编代码; 修改格式时需要修改MAGIC, 使旧条目全部失效
+static const char MAGIC[] = "SysYc-cache-v1\n";
+static const char SUFFIX[] = ".fn";
+
+static bool WriteAll(int fd, const char *data, size_t len) {
+    while (len > 0) {
+        ssize_t n = ::write(fd, data, len);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += n;
+        len -= n;
+    }
+    return true;
+}
+
+static bool ReadAll(int fd, std::string &buf) {
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        return false;
+    }
+    buf.resize(st.st_size);
+    size_t done = 0;
+    while (done < buf.size()) {
+        ssize_t n = pread(fd, buf.data() + done, buf.size() - done, done);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        done += n;
+    }
+    return true;
+}
+
+// FNV-1a, 只用于决定文件名, 命中与否以完整比较键为准
+static unsigned long long HashKey(std::string_view key) {
+    unsigned long long h = 14695981039346656037ull;
+    for (unsigned char c : key) {
+        h = (h ^ c) * 1099511628211ull;
+    }
+    return h;
+}
+
+void CompileCache::Enable(std::string_view dir, long long max_mb) {
+    this->dir = dir;
+    max_bytes = max_mb * 1024 * 1024;
+    if (mkdir(this->dir.c_str(), 0755) < 0 && errno != EEXIST) {
+        fprintf(stderr, "warning: cannot use cache directory %s: %s\n", this->dir.c_str(), strerror(errno));
+        return;
+    }
+    enabled = true;
+}
+
+void CompileCache::SetContext(std::string_view flags) {
+    // 编译器重新构建后可执行文件的大小或修改时间会改变, 旧的条目不再命中
+    struct stat st {};
+    stat("/proc/self/exe", &st);
+    char exe[96];
+    snprintf(exe, sizeof(exe), "exe:%lld:%lld.%09ld ", (long long)st.st_size, (long long)st.st_mtim.tv_sec,
+             st.st_mtim.tv_nsec);
+    context = std::string(MAGIC) + exe + std::string(flags) + "\n";
+}
+
+std::string CompileCache::EntryPath(std::string_view key) const {
+    char name[64];
+    snprintf(name, sizeof(name), "/%016llx-%zx%s", HashKey(key), key.size(), SUFFIX);
+    return dir + name;
+}
+
+bool CompileCache::Lookup(std::string_view key, std::string &asm_out) {
+    int fd = open(EntryPath(key).c_str(), O_RDONLY);
+    if (fd < 0) {
+        misses++;
+        return false;
+    }
+    std::string buf;
+    bool ok = ReadAll(fd, buf);
+    // 检查格式, 并完整比较键
+    size_t magic_len = sizeof(MAGIC) - 1;
+    size_t nl = ok ? buf.find('\n', magic_len) : std::string::npos;
+    ok = nl != std::string::npos && buf.compare(0, magic_len, MAGIC) == 0;
+    size_t key_len = ok ? strtoull(buf.c_str() + magic_len, nullptr, 10) : 0;
+    ok = ok && buf.size() - (nl + 1) >= key_len && key_len == key.size() && buf.compare(nl + 1, key_len, key) == 0;
+    if (ok) {
+        // 更新修改时间, 作为LRU的访问时间
+        futimens(fd, nullptr);
+        asm_out.assign(buf, nl + 1 + key_len, std::string::npos);
+        hits++;
+    } else {
+        misses++;
+    }
+    close(fd);
+    return ok;
+}
+
+void CompileCache::Store(std::string_view key, std::string_view asm_code) {
+    static std::atomic<int> tmp_id{0};
+    std::string tmp = dir + "/tmp-" + std::to_string(getpid()) + "-" + std::to_string(tmp_id++);
+    int fd = open(tmp.c_str(), O_WRONLY | O_CREAT | O_EXCL, 0644);
+    if (fd < 0) {
+        return;
+    }
+    std::string header = std::string(MAGIC) + std::to_string(key.size()) + "\n";
+    bool ok = WriteAll(fd, header.data(), header.size()) && WriteAll(fd, key.data(), key.size()) &&
+              WriteAll(fd, asm_code.data(), asm_code.size());
+    close(fd);
+    // rename是原子的, 其他进程只会看到完整的条目
+    if (!ok || rename(tmp.c_str(), EntryPath(key).c_str()) < 0) {
+        unlink(tmp.c_str());
+        return;
+    }
+    stores++;
+}
+
+void CompileCache::Trim() {
+    if (!enabled || stores == 0) {
+        return;
+    }
+    DIR *d = opendir(dir.c_str());
+    if (d == nullptr) {
+        return;
+    }
+    struct Item {
+        timespec mtime;
+        long long size;
+        std::string name;
+    };
+    std::vector<Item> items;
+    long long total = 0;
+    time_t now = time(nullptr);
+    size_t suffix_len = sizeof(SUFFIX) - 1;
+    while (dirent *e = readdir(d)) {
+        std::string_view name = e->d_name;
+        bool is_entry = name.size() > suffix_len && name.substr(name.size() - suffix_len) == SUFFIX;
+        bool is_tmp = name.substr(0, 4) == "tmp-";
+        struct stat st;
+        if ((!is_entry && !is_tmp) || fstatat(dirfd(d), e->d_name, &st, 0) < 0) {
+            continue;
+        }
+        // 被中断的编译留下的临时文件
+        if (is_tmp) {
+            if (now - st.st_mtim.tv_sec > 3600) {
+                unlinkat(dirfd(d), e->d_name, 0);
+            }
+            continue;
+        }
+        items.push_back({st.st_mtim, (long long)st.st_size, std::string(name)});
+        total += st.st_size;
+    }
+    if (total > max_bytes) {
+        std::sort(items.begin(), items.end(), [](const Item &a, const Item &b) {
+            return a.mtime.tv_sec != b.mtime.tv_sec ? a.mtime.tv_sec < b.mtime.tv_sec
+                                                    : a.mtime.tv_nsec < b.mtime.tv_nsec;
+        });
+        // 删除到上限的90%, 避免之后每次编译都需要删除
+        for (auto &item : items) {
+            if (total <= max_bytes / 10 * 9) {
+                break;
+            }
+            // 其他进程可能已经删除了该条目
+            unlinkat(dirfd(d), item.name.c_str(), 0);
+            total -= item.size;
+        }
+    }
+    closedir(d);
+}
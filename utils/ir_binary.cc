@@ -0,0 +1,708 @@
+#include "../include/ir_binary.h"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <unordered_map>
+
+namespace {
+
+class IRBinaryWriter {
+private:
+    std::string string_data{};
+    std::vector<IRBString> strings{};
+    std::unordered_map<std::string, uint32_t> string_ids{};
+    std::vector<IRBOperand> operands{};
+    std::unordered_map<Operand, uint32_t> operand_ids{};
+
+public:
+    std::vector<IRBDeclare> declares{};
+    std::vector<IRBGlobal> globals{};
+    std::vector<IRBFunction> functions{};
+    std::vector<IRBBlock> blocks{};
+    std::vector<IRBInst> insts{};
+    std::vector<uint32_t> extra{};
+
+    uint32_t String(const std::string &s) {
+        auto [it, inserted] = string_ids.emplace(s, strings.size());
+        if (inserted) {
+            strings.push_back({(uint32_t)string_data.size(), (uint32_t)s.size()});
+            string_data += s;
+        }
+        return it->second;
+    }
+
+    uint32_t Op(Operand op) {
+        if (op == nullptr) {
+            return IR_BINARY_NONE;
+        }
+        auto [it, inserted] = operand_ids.emplace(op, operands.size());
+        if (!inserted) {
+            return it->second;
+        }
+        IRBOperand rec{(uint32_t)op->GetOperandType(), 0, 0};
+        switch (op->GetOperandType()) {
+        case BasicOperand::REG:
+            rec.a = ((RegOperand *)op)->GetRegNo();
+            break;
+        case BasicOperand::IMMI32:
+            rec.a = ((ImmI32Operand *)op)->GetIntImmVal();
+            break;
+        case BasicOperand::IMMF32: {
+            float val = ((ImmF32Operand *)op)->GetFloatVal();
+            memcpy(&rec.a, &val, sizeof(val));
+            break;
+        }
+        case BasicOperand::IMMI64: {
+            unsigned long long val = ((ImmI64Operand *)op)->GetLlImmVal();
+            rec.a = (uint32_t)val;
+            rec.b = (uint32_t)(val >> 32);
+            break;
+        }
+        case BasicOperand::LABEL:
+            rec.a = ((LabelOperand *)op)->GetLabelNo();
+            break;
+        case BasicOperand::GLOBAL:
+            rec.a = String(((GlobalOperand *)op)->GetName());
+            break;
+        }
+        operands.push_back(rec);
+        return it->second;
+    }
+
+    // 返回额外数据的当前长度, 作为接下来写入的内容的起始位置
+    uint32_t ExtraPos() { return extra.size(); }
+
+    void Inst(Instruction I);
+    void Global(Instruction I);
+    bool Write(int fd);
+};
+
+void IRBinaryWriter::Inst(Instruction I) {
+    IRBInst rec{};
+    rec.opcode = I->GetOpcode();
+    rec.result = rec.op[0] = rec.op[1] = rec.op[2] = IR_BINARY_NONE;
+    rec.extra = ExtraPos();
+    switch (I->GetOpcode()) {
+    case BasicInstruction::LOAD: {
+        auto LoadI = (LoadInstruction *)I;
+        rec.type = LoadI->GetDataType();
+        rec.result = Op(LoadI->GetResult());
+        rec.op[0] = Op(LoadI->GetPointer());
+        break;
+    }
+    case BasicInstruction::STORE: {
+        auto StoreI = (StoreInstruction *)I;
+        rec.type = StoreI->GetDataType();
+        rec.op[0] = Op(StoreI->GetPointer());
+        rec.op[1] = Op(StoreI->GetValue());
+        break;
+    }
+    case BasicInstruction::ADD:
+    case BasicInstruction::SUB:
+    case BasicInstruction::MUL:
+    case BasicInstruction::DIV:
+    case BasicInstruction::FADD:
+    case BasicInstruction::FSUB:
+    case BasicInstruction::FMUL:
+    case BasicInstruction::FDIV:
+    case BasicInstruction::MOD:
+    case BasicInstruction::BITXOR:
+    case BasicInstruction::SHL: {
+        auto ArithI = (ArithmeticInstruction *)I;
+        rec.type = ArithI->GetDataType();
+        rec.result = Op(ArithI->GetResult());
+        rec.op[0] = Op(ArithI->GetOperand1());
+        rec.op[1] = Op(ArithI->GetOperand2());
+        break;
+    }
+    case BasicInstruction::ICMP: {
+        auto IcmpI = (IcmpInstruction *)I;
+        rec.type = IcmpI->GetDataType();
+        rec.aux = IcmpI->GetCond();
+        rec.result = Op(IcmpI->GetResult());
+        rec.op[0] = Op(IcmpI->GetOp1());
+        rec.op[1] = Op(IcmpI->GetOp2());
+        break;
+    }
+    case BasicInstruction::FCMP: {
+        auto FcmpI = (FcmpInstruction *)I;
+        rec.type = FcmpI->GetDataType();
+        rec.aux = FcmpI->GetCond();
+        rec.result = Op(FcmpI->GetResult());
+        rec.op[0] = Op(FcmpI->GetOp1());
+        rec.op[1] = Op(FcmpI->GetOp2());
+        break;
+    }
+    case BasicInstruction::PHI: {
+        auto PhiI = (PhiInstruction *)I;
+        rec.type = PhiI->GetDataType();
+        rec.result = Op(PhiI->GetResult());
+        for (auto [label, val] : PhiI->GetPhiList()) {
+            extra.push_back(Op(label));
+            extra.push_back(Op(val));
+        }
+        break;
+    }
+    case BasicInstruction::ALLOCA: {
+        auto AllocaI = (AllocaInstruction *)I;
+        rec.type = AllocaI->GetDataType();
+        rec.result = Op(AllocaI->GetResult());
+        for (auto d : AllocaI->GetDims()) {
+            extra.push_back(d);
+        }
+        break;
+    }
+    case BasicInstruction::BR_COND: {
+        auto BrCondI = (BrCondInstruction *)I;
+        rec.op[0] = Op(BrCondI->GetCond());
+        rec.op[1] = Op(BrCondI->GetTrueLabel());
+        rec.op[2] = Op(BrCondI->GetFalseLabel());
+        break;
+    }
+    case BasicInstruction::BR_UNCOND:
+        rec.op[0] = Op(((BrUncondInstruction *)I)->GetDestLabel());
+        break;
+    case BasicInstruction::RET: {
+        auto RetI = (RetInstruction *)I;
+        rec.type = RetI->GetType();
+        rec.op[0] = Op(RetI->GetRetVal());
+        break;
+    }
+    case BasicInstruction::CALL: {
+        auto CallI = (CallInstruction *)I;
+        rec.type = CallI->GetRetType();
+        rec.result = Op(CallI->GetResult());
+        rec.op[0] = String(CallI->GetFunctionName());
+        for (auto [type, arg] : CallI->GetParameterList()) {
+            extra.push_back(type);
+            extra.push_back(Op(arg));
+        }
+        break;
+    }
+    case BasicInstruction::GETELEMENTPTR: {
+        auto GEPI = (GetElementptrInstruction *)I;
+        auto dims = GEPI->GetDims();
+        rec.type = GEPI->GetType();
+        rec.aux = GEPI->GetIndexType();
+        rec.result = Op(GEPI->GetResult());
+        rec.op[0] = Op(GEPI->GetPtrVal());
+        rec.op[1] = dims.size();
+        for (auto d : dims) {
+            extra.push_back(d);
+        }
+        for (auto idx : GEPI->GetIndexes()) {
+            extra.push_back(Op(idx));
+        }
+        break;
+    }
+    case BasicInstruction::FPTOSI:
+        rec.result = Op(((FptosiInstruction *)I)->GetResult());
+        rec.op[0] = Op(((FptosiInstruction *)I)->GetSrc());
+        break;
+    case BasicInstruction::SITOFP:
+        rec.result = Op(((SitofpInstruction *)I)->GetResult());
+        rec.op[0] = Op(((SitofpInstruction *)I)->GetSrc());
+        break;
+    case BasicInstruction::ZEXT: {
+        auto ZextI = (ZextInstruction *)I;
+        rec.type = ZextI->GetToType();
+        rec.aux = ZextI->GetFromType();
+        rec.result = Op(ZextI->GetResult());
+        rec.op[0] = Op(ZextI->GetSrc());
+        break;
+    }
+    default:
+        ERROR("Unexpected opcode %d in function body", I->GetOpcode());
+    }
+    rec.n_extra = ExtraPos() - rec.extra;
+    insts.push_back(rec);
+}
+
+template <class T> static void PutSparseArray(std::vector<uint32_t> &extra, const SparseArray<T> &arr) {
+    extra.push_back(arr.size());
+    extra.push_back(arr.NonZeros().size());
+    for (auto &[idx, val] : arr.NonZeros()) {
+        uint32_t bits;
+        memcpy(&bits, &val, sizeof(bits));
+        extra.push_back(idx);
+        extra.push_back(bits);
+    }
+}
+
+void IRBinaryWriter::Global(Instruction I) {
+    if (I->GetOpcode() != BasicInstruction::GLOBAL_VAR) {
+        ERROR("Unexpected opcode %d in global definitions", I->GetOpcode());
+    }
+    auto GlobalI = (GlobalVarDefineInstruction *)I;
+    auto &attr = GlobalI->arrayval;
+    IRBGlobal rec{};
+    rec.opcode = I->GetOpcode();
+    rec.type = GlobalI->type;
+    rec.attr_type = attr.type;
+    rec.const_tag = attr.ConstTag;
+    rec.name = String(GlobalI->name);
+    rec.init = Op(GlobalI->init_val);
+    rec.extra = ExtraPos();
+    extra.push_back(attr.dims.size());
+    for (auto d : attr.dims) {
+        extra.push_back(d);
+    }
+    static_assert(sizeof(int) == sizeof(uint32_t) && sizeof(float) == sizeof(uint32_t));
+    PutSparseArray(extra, attr.IntInitVals);
+    PutSparseArray(extra, attr.FloatInitVals);
+    rec.n_extra = ExtraPos() - rec.extra;
+    globals.push_back(rec);
+}
+
+static bool WriteAll(int fd, const char *data, size_t len) {
+    while (len > 0) {
+        ssize_t n = ::write(fd, data, len);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += n;
+        len -= n;
+    }
+    return true;
+}
+
+bool IRBinaryWriter::Write(int fd) {
+    IRBHeader header{};
+    memcpy(header.magic, IR_BINARY_MAGIC, sizeof(header.magic));
+    header.version = IR_BINARY_VERSION;
+    header.section_num = IRB_SECTION_NUM;
+    std::pair<const void *, size_t> contents[IRB_SECTION_NUM];
+    size_t sizes[IRB_SECTION_NUM];
+    auto set = [&](IRBinarySectionId id, const auto &vec) {
+        contents[id] = {vec.data(), vec.size()};
+        sizes[id] = sizeof(vec[0]);
+    };
+    set(IRB_STRING_DATA, string_data);
+    set(IRB_STRINGS, strings);
+    set(IRB_OPERANDS, operands);
+    set(IRB_DECLARES, declares);
+    set(IRB_GLOBALS, globals);
+    set(IRB_FUNCTIONS, functions);
+    set(IRB_BLOCKS, blocks);
+    set(IRB_INSTS, insts);
+    set(IRB_EXTRA, extra);
+    // 每段的起始位置按8字节对齐, 映射到内存后可以直接作为记录数组访问
+    uint64_t offset = sizeof(header);
+    for (int i = 0; i < IRB_SECTION_NUM; i++) {
+        header.sections[i] = {offset, contents[i].second};
+        offset = (offset + contents[i].second * sizes[i] + 7) / 8 * 8;
+    }
+    if (!WriteAll(fd, (const char *)&header, sizeof(header))) {
+        return false;
+    }
+    static const char padding[8] = {};
+    uint64_t written = sizeof(header);
+    for (int i = 0; i < IRB_SECTION_NUM; i++) {
+        if (!WriteAll(fd, padding, header.sections[i].offset - written)) {
+            return false;
+        }
+        size_t len = contents[i].second * sizes[i];
+        if (!WriteAll(fd, (const char *)contents[i].first, len)) {
+            return false;
+        }
+        written = header.sections[i].offset + len;
+    }
+    return true;
+}
+
+// 读取时的边界检查: 文件可能被截断或损坏, 任何越界的下标都报告为格式错误, 而不是访问越界
+class IRBinaryReader {
+private:
+    const char *data;
+    size_t size;
+    const IRBHeader *header = nullptr;
+
+public:
+    const char *string_data = nullptr;
+    const IRBString *strings = nullptr;
+    const IRBOperand *operands = nullptr;
+    const IRBDeclare *declares = nullptr;
+    const IRBGlobal *globals = nullptr;
+    const IRBFunction *functions = nullptr;
+    const IRBBlock *blocks = nullptr;
+    const IRBInst *insts = nullptr;
+    const uint32_t *extra = nullptr;
+    std::string error{};
+
+    IRBinaryReader(const char *data, size_t size) : data(data), size(size) {}
+
+    uint64_t Count(IRBinarySectionId id) const { return header->sections[id].count; }
+
+    template <class T> bool Section(IRBinarySectionId id, const T *&ptr) {
+        auto [offset, count] = header->sections[id];
+        if (offset % 8 != 0 || offset > size || count > (size - offset) / sizeof(T)) {
+            error = "section " + std::to_string(id) + " out of range";
+            return false;
+        }
+        ptr = (const T *)(data + offset);
+        return true;
+    }
+
+    bool Open();
+
+    bool Check(bool cond, const char *what) {
+        if (!cond && error.empty()) {
+            error = what;
+        }
+        return cond;
+    }
+
+    std::string Str(uint32_t id) {
+        if (!Check(id < Count(IRB_STRINGS), "string index out of range")) {
+            return {};
+        }
+        auto s = strings[id];
+        if (!Check(s.offset <= Count(IRB_STRING_DATA) && s.length <= Count(IRB_STRING_DATA) - s.offset,
+                   "string out of range")) {
+            return {};
+        }
+        return std::string(string_data + s.offset, s.length);
+    }
+
+    // IR_BINARY_NONE表示空操作数
+    Operand Op(uint32_t id);
+    // 指令必须有的操作数, 不能为空
+    Operand Req(uint32_t id) {
+        Operand op = Op(id);
+        Check(op != nullptr, "missing operand");
+        return op;
+    }
+    // 返回[extra, extra + n)对应的数组, 越界时返回nullptr
+    const uint32_t *Extra(uint32_t pos, uint32_t n) {
+        return Check(pos <= Count(IRB_EXTRA) && n <= Count(IRB_EXTRA) - pos, "extra data out of range") ? extra + pos
+                                                                                                         : nullptr;
+    }
+
+    // 类型和条件保存为整数, 转换为枚举前检查范围, 不使用类型的指令保存为0
+    bool ValidType(uint32_t t) { return Check(t <= BasicInstruction::DOUBLE, "type out of range"); }
+
+    Instruction Inst(Arena &arena, const IRBInst &rec);
+    Instruction Global(Arena &arena, const IRBGlobal &rec);
+};
+
+bool IRBinaryReader::Open() {
+    if (!IsIRBinary(data, size)) {
+        error = "not an IR binary file";
+        return false;
+    }
+    if (size < sizeof(IRBHeader)) {
+        error = "truncated IR binary file";
+        return false;
+    }
+    header = (const IRBHeader *)data;
+    if (header->version != IR_BINARY_VERSION || header->section_num != IRB_SECTION_NUM) {
+        error = "unsupported IR binary version " + std::to_string(header->version);
+        return false;
+    }
+    return Section(IRB_STRING_DATA, string_data) && Section(IRB_STRINGS, strings) &&
+           Section(IRB_OPERANDS, operands) && Section(IRB_DECLARES, declares) && Section(IRB_GLOBALS, globals) &&
+           Section(IRB_FUNCTIONS, functions) && Section(IRB_BLOCKS, blocks) && Section(IRB_INSTS, insts) &&
+           Section(IRB_EXTRA, extra);
+}
+
+Operand IRBinaryReader::Op(uint32_t id) {
+    if (id == IR_BINARY_NONE || !Check(id < Count(IRB_OPERANDS), "operand index out of range")) {
+        return nullptr;
+    }
+    auto rec = operands[id];
+    switch (rec.kind) {
+    case BasicOperand::REG:
+        if (!Check(IsValidRegNo((int32_t)rec.a), "register number out of range")) {
+            return nullptr;
+        }
+        return GetNewRegOperand((int32_t)rec.a);
+    case BasicOperand::IMMI32:
+        return GetNewImmI32Operand((int)rec.a);
+    case BasicOperand::IMMF32: {
+        float val;
+        memcpy(&val, &rec.a, sizeof(val));
+        return GetNewImmF32Operand(val);
+    }
+    case BasicOperand::IMMI64:
+        return GetNewImmI64Operand((long long)((unsigned long long)rec.b << 32 | rec.a));
+    case BasicOperand::LABEL:
+        if (!Check(IsValidLabelNo((int32_t)rec.a), "label number out of range")) {
+            return nullptr;
+        }
+        return GetNewLabelOperand((int32_t)rec.a);
+    case BasicOperand::GLOBAL:
+        return GetNewGlobalOperand(Str(rec.a));
+    }
+    Check(false, "unknown operand kind");
+    return nullptr;
+}
+
+Instruction IRBinaryReader::Inst(Arena &arena, const IRBInst &rec) {
+    using LLVMType = BasicInstruction::LLVMType;
+    auto type = (LLVMType)rec.type;
+    const uint32_t *ext = Extra(rec.extra, rec.n_extra);
+    if (ext == nullptr || !ValidType(rec.type)) {
+        return nullptr;
+    }
+    switch (rec.opcode) {
+    case BasicInstruction::LOAD:
+        return arena.New<LoadInstruction>(type, Req(rec.op[0]), Req(rec.result));
+    case BasicInstruction::STORE:
+        return arena.New<StoreInstruction>(type, Req(rec.op[0]), Req(rec.op[1]));
+    case BasicInstruction::ADD:
+    case BasicInstruction::SUB:
+    case BasicInstruction::MUL:
+    case BasicInstruction::DIV:
+    case BasicInstruction::FADD:
+    case BasicInstruction::FSUB:
+    case BasicInstruction::FMUL:
+    case BasicInstruction::FDIV:
+    case BasicInstruction::MOD:
+    case BasicInstruction::BITXOR:
+    case BasicInstruction::SHL:
+        return arena.New<ArithmeticInstruction>((BasicInstruction::LLVMIROpcode)rec.opcode, type, Req(rec.op[0]),
+                                                Req(rec.op[1]), Req(rec.result));
+    case BasicInstruction::ICMP:
+        if (!Check(rec.aux >= BasicInstruction::eq && rec.aux <= BasicInstruction::sle,
+                   "icmp condition out of range")) {
+            return nullptr;
+        }
+        return arena.New<IcmpInstruction>(type, Req(rec.op[0]), Req(rec.op[1]), (BasicInstruction::IcmpCond)rec.aux,
+                                          Req(rec.result));
+    case BasicInstruction::FCMP:
+        if (!Check(rec.aux >= BasicInstruction::FALSE && rec.aux <= BasicInstruction::TRUE,
+                   "fcmp condition out of range")) {
+            return nullptr;
+        }
+        return arena.New<FcmpInstruction>(type, Req(rec.op[0]), Req(rec.op[1]), (BasicInstruction::FcmpCond)rec.aux,
+                                          Req(rec.result));
+    case BasicInstruction::PHI: {
+        std::vector<std::pair<Operand, Operand>> phi_list;
+        for (uint32_t i = 0; i + 1 < rec.n_extra; i += 2) {
+            phi_list.push_back({Req(ext[i]), Req(ext[i + 1])});
+        }
+        return arena.New<PhiInstruction>(type, Req(rec.result), std::move(phi_list));
+    }
+    case BasicInstruction::ALLOCA:
+        return arena.New<AllocaInstruction>(type, std::vector<int>(ext, ext + rec.n_extra), Req(rec.result));
+    case BasicInstruction::BR_COND:
+        return arena.New<BrCondInstruction>(Req(rec.op[0]), Req(rec.op[1]), Req(rec.op[2]));
+    case BasicInstruction::BR_UNCOND:
+        return arena.New<BrUncondInstruction>(Req(rec.op[0]));
+    case BasicInstruction::RET:
+        return arena.New<RetInstruction>(type, type == BasicInstruction::VOID ? Op(rec.op[0]) : Req(rec.op[0]));
+    case BasicInstruction::CALL: {
+        std::vector<std::pair<LLVMType, Operand>> args;
+        for (uint32_t i = 0; i + 1 < rec.n_extra && ValidType(ext[i]); i += 2) {
+            args.push_back({(LLVMType)ext[i], Req(ext[i + 1])});
+        }
+        Operand result = type == BasicInstruction::VOID ? Op(rec.result) : Req(rec.result);
+        return arena.New<CallInstruction>(type, result, Str(rec.op[0]), std::move(args));
+    }
+    case BasicInstruction::GETELEMENTPTR: {
+        if (!Check(rec.op[1] <= rec.n_extra, "getelementptr dims out of range") || !ValidType(rec.aux)) {
+            return nullptr;
+        }
+        std::vector<int> dims(ext, ext + rec.op[1]);
+        std::vector<Operand> indexes;
+        for (uint32_t i = rec.op[1]; i < rec.n_extra; i++) {
+            indexes.push_back(Req(ext[i]));
+        }
+        return arena.New<GetElementptrInstruction>(type, Req(rec.result), Req(rec.op[0]), std::move(dims),
+                                                   std::move(indexes), (LLVMType)rec.aux);
+    }
+    case BasicInstruction::FPTOSI:
+        return arena.New<FptosiInstruction>(Req(rec.result), Req(rec.op[0]));
+    case BasicInstruction::SITOFP:
+        return arena.New<SitofpInstruction>(Req(rec.result), Req(rec.op[0]));
+    case BasicInstruction::ZEXT:
+        if (!ValidType(rec.aux)) {
+            return nullptr;
+        }
+        return arena.New<ZextInstruction>(type, Req(rec.result), (LLVMType)rec.aux, Req(rec.op[0]));
+    }
+    Check(false, "unknown instruction opcode");
+    return nullptr;
+}
+
+template <class T> static const uint32_t *GetSparseArray(IRBinaryReader &r, const uint32_t *p, const uint32_t *end,
+                                                         SparseArray<T> &arr) {
+    if (!r.Check(p != nullptr && end - p >= 2 && (end - p - 2) / 2 >= p[1], "global initializer out of range")) {
+        return nullptr;
+    }
+    arr = SparseArray<T>(p[0]);
+    uint32_t nnz = p[1];
+    p += 2;
+    for (uint32_t i = 0; i < nnz; i++, p += 2) {
+        T val;
+        memcpy(&val, &p[1], sizeof(val));
+        arr.set(p[0], val);
+    }
+    return p;
+}
+
+Instruction IRBinaryReader::Global(Arena &arena, const IRBGlobal &rec) {
+    if (!Check(rec.opcode == BasicInstruction::GLOBAL_VAR, "unknown global opcode") || !ValidType(rec.type)) {
+        return nullptr;
+    }
+    const uint32_t *p = Extra(rec.extra, rec.n_extra);
+    if (!Check(p != nullptr && rec.n_extra >= 1 && p[0] < rec.n_extra, "global dims out of range")) {
+        return nullptr;
+    }
+    const uint32_t *end = p + rec.n_extra;
+    VarAttribute attr;
+    attr.type = (Type::ty)rec.attr_type;
+    attr.ConstTag = rec.const_tag;
+    attr.dims.assign(p + 1, p + 1 + p[0]);
+    p = GetSparseArray(*this, p + 1 + p[0], end, attr.IntInitVals);
+    p = GetSparseArray(*this, p, end, attr.FloatInitVals);
+    if (p == nullptr) {
+        return nullptr;
+    }
+    auto type = (BasicInstruction::LLVMType)rec.type;
+    auto GlobalI = arena.New<GlobalVarDefineInstruction>(Str(rec.name), type, std::move(attr));
+    GlobalI->init_val = Op(rec.init);
+    return GlobalI;
+}
+
+}    // namespace
+
+bool IsIRBinary(const char *data, size_t size) {
+    return size >= sizeof(IR_BINARY_MAGIC) && memcmp(data, IR_BINARY_MAGIC, sizeof(IR_BINARY_MAGIC)) == 0;
+}
+
+bool SaveIRBinary(LLVMIR &IR, const char *path) {
+    IRBinaryWriter w;
+    for (auto I : IR.function_declare) {
+        auto DeclI = (FunctionDeclareInstruction *)I;
+        IRBDeclare rec{w.String(DeclI->GetFunctionName()), (uint32_t)DeclI->GetReturnType(), w.ExtraPos(), 0};
+        for (auto t : DeclI->formals) {
+            w.extra.push_back(t);
+        }
+        rec.n_extra = w.ExtraPos() - rec.extra;
+        w.declares.push_back(rec);
+    }
+    for (auto I : IR.global_def) {
+        w.Global(I);
+    }
+    for (auto defI : IR.function_order) {
+        auto &blocks = IR.function_block_map[defI];
+        IRBFunction rec{};
+        rec.name = w.String(defI->GetFunctionName());
+        rec.ret_type = defI->GetReturnType();
+        rec.extra = w.ExtraPos();
+        for (size_t i = 0; i < defI->formals.size(); i++) {
+            w.extra.push_back(defI->formals[i]);
+            w.extra.push_back(w.Op(defI->formals_reg[i]));
+        }
+        rec.n_extra = w.ExtraPos() - rec.extra;
+        rec.max_reg = IR.def_reg[defI];
+        rec.first_block = w.blocks.size();
+        rec.n_blocks = blocks.size();
+        for (auto &[id, block] : blocks) {
+            IRBBlock block_rec{id, block->comment.empty() ? IR_BINARY_NONE : w.String(block->comment),
+                               (uint32_t)w.insts.size(), (uint32_t)block->Instruction_list.size()};
+            w.blocks.push_back(block_rec);
+            for (auto I : block->Instruction_list) {
+                w.Inst(I);
+            }
+        }
+        w.functions.push_back(rec);
+    }
+
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        fprintf(stderr, "error: cannot open %s: %s\n", path, strerror(errno));
+        return false;
+    }
+    bool ok = w.Write(fd);
+    if (!ok) {
+        fprintf(stderr, "error: cannot write %s: %s\n", path, strerror(errno));
+    }
+    close(fd);
+    return ok;
+}
+
+bool LoadIRBinary(LLVMIR &IR, const char *data, size_t size, std::string &error) {
+    IRBinaryReader r(data, size);
+    if (!r.Open()) {
+        error = r.error;
+        return false;
+    }
+    Arena &global = IR.global_arena;
+    for (uint64_t i = 0; i < r.Count(IRB_DECLARES) && r.error.empty(); i++) {
+        auto &rec = r.declares[i];
+        if (!r.ValidType(rec.ret_type)) {
+            break;
+        }
+        auto DeclI = global.New<FunctionDeclareInstruction>((BasicInstruction::LLVMType)rec.ret_type, r.Str(rec.name));
+        if (const uint32_t *ext = r.Extra(rec.extra, rec.n_extra)) {
+            for (uint32_t j = 0; j < rec.n_extra && r.ValidType(ext[j]); j++) {
+                DeclI->InsertFormal((BasicInstruction::LLVMType)ext[j]);
+            }
+        }
+        IR.function_declare.push_back(DeclI);
+    }
+    for (uint64_t i = 0; i < r.Count(IRB_GLOBALS) && r.error.empty(); i++) {
+        if (auto I = r.Global(global, r.globals[i])) {
+            IR.global_def.push_back(I);
+        }
+    }
+    for (uint64_t i = 0; i < r.Count(IRB_FUNCTIONS) && r.error.empty(); i++) {
+        auto &rec = r.functions[i];
+        if (!r.ValidType(rec.ret_type) || !r.Check(IsValidRegNo(rec.max_reg), "register number out of range")) {
+            break;
+        }
+        auto defI = global.New<FunctionDefineInstruction>((BasicInstruction::LLVMType)rec.ret_type, r.Str(rec.name));
+        IR.NewFunction(defI);
+        IR.def_reg[defI] = rec.max_reg;
+        const uint32_t *ext = r.Extra(rec.extra, rec.n_extra);
+        for (uint32_t j = 0; ext != nullptr && j + 1 < rec.n_extra && r.ValidType(ext[j]); j += 2) {
+            Operand reg = r.Op(ext[j + 1]);
+            if (!r.Check(reg != nullptr && reg->GetOperandType() == BasicOperand::REG,
+                         "function parameter is not a register")) {
+                break;
+            }
+            defI->formals.push_back((BasicInstruction::LLVMType)ext[j]);
+            defI->formals_reg.push_back(reg);
+        }
+        if (!r.Check(rec.first_block <= r.Count(IRB_BLOCKS) && rec.n_blocks <= r.Count(IRB_BLOCKS) - rec.first_block,
+                     "block range out of range")) {
+            break;
+        }
+        Arena &arena = IR.GetArena(defI);
+        for (uint32_t b = rec.first_block; b < rec.first_block + rec.n_blocks && r.error.empty(); b++) {
+            auto &block_rec = r.blocks[b];
+            if (!r.Check(block_rec.first_inst <= r.Count(IRB_INSTS) &&
+                         block_rec.n_insts <= r.Count(IRB_INSTS) - block_rec.first_inst,
+                         "instruction range out of range") ||
+                !r.Check(IsValidLabelNo(block_rec.id), "block label out of range") ||
+                !r.Check(!IR.function_block_map[defI].count(block_rec.id), "duplicate block label")) {
+                break;
+            }
+            LLVMBlock block = IR.NewBlock(defI, block_rec.id);
+            if (block_rec.comment != IR_BINARY_NONE) {
+                block->comment = r.Str(block_rec.comment);
+            }
+            for (uint32_t k = block_rec.first_inst; k < block_rec.first_inst + block_rec.n_insts; k++) {
+                if (auto I = r.Inst(arena, r.insts[k])) {
+                    block->Instruction_list.push_back(I);
+                }
+            }
+        }
+        // 之后直接建立控制流图(见CFG::BuildEdges), 需要与.ll一样检查基本块的结构
+        std::string msg;
+        if (r.error.empty() && !IR.CheckBlocks(defI, msg)) {
+            r.error = msg;
+        }
+    }
+    // 与中间代码生成结束时一致
+    ir_arena = &global;
+    error = r.error;
+    return error.empty();
+}
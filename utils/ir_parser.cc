@@ -0,0 +1,613 @@
+#include "../include/ir_parser.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <string_view>
+
+namespace {
+
+using LLVMType = BasicInstruction::LLVMType;
+
+// 与Instuction_out.cc中的输出一一对应
+const std::pair<std::string_view, LLVMType> TypeNames[] = {
+{"i32", BasicInstruction::I32},  {"i64", BasicInstruction::I64},      {"i8", BasicInstruction::I8},
+{"i1", BasicInstruction::I1},    {"float", BasicInstruction::FLOAT32}, {"double", BasicInstruction::DOUBLE},
+{"ptr", BasicInstruction::PTR},  {"void", BasicInstruction::VOID},
+};
+
+const std::pair<std::string_view, BasicInstruction::LLVMIROpcode> ArithmeticNames[] = {
+{"add", BasicInstruction::ADD},   {"sub", BasicInstruction::SUB},   {"mul", BasicInstruction::MUL},
+{"sdiv", BasicInstruction::DIV},  {"srem", BasicInstruction::MOD},  {"fadd", BasicInstruction::FADD},
+{"fsub", BasicInstruction::FSUB}, {"fmul", BasicInstruction::FMUL}, {"fdiv", BasicInstruction::FDIV},
+{"xor", BasicInstruction::BITXOR}, {"shl", BasicInstruction::SHL},
+};
+
+const std::pair<std::string_view, BasicInstruction::IcmpCond> IcmpNames[] = {
+{"eq", BasicInstruction::eq},   {"ne", BasicInstruction::ne},   {"ugt", BasicInstruction::ugt},
+{"uge", BasicInstruction::uge}, {"ult", BasicInstruction::ult}, {"ule", BasicInstruction::ule},
+{"sgt", BasicInstruction::sgt}, {"sge", BasicInstruction::sge}, {"slt", BasicInstruction::slt},
+{"sle", BasicInstruction::sle},
+};
+
+const std::pair<std::string_view, BasicInstruction::FcmpCond> FcmpNames[] = {
+{"false", BasicInstruction::FALSE}, {"oeq", BasicInstruction::OEQ}, {"ogt", BasicInstruction::OGT},
+{"oge", BasicInstruction::OGE},     {"olt", BasicInstruction::OLT}, {"ole", BasicInstruction::OLE},
+{"one", BasicInstruction::ONE},     {"ord", BasicInstruction::ORD}, {"ueq", BasicInstruction::UEQ},
+{"ugt", BasicInstruction::UGT},     {"uge", BasicInstruction::UGE}, {"ult", BasicInstruction::ULT},
+{"ule", BasicInstruction::ULE},     {"une", BasicInstruction::UNE}, {"uno", BasicInstruction::UNO},
+{"true", BasicInstruction::TRUE},
+};
+
+template <class T, size_t N> bool Lookup(const std::pair<std::string_view, T> (&table)[N], std::string_view s, T &v) {
+    for (auto &[name, val] : table) {
+        if (name == s) {
+            v = val;
+            return true;
+        }
+    }
+    return false;
+}
+
+// 浮点数立即数以double的位模式输出(见Float_to_Byte)
+float HexToFloat(unsigned long long bits) {
+    double d;
+    memcpy(&d, &bits, sizeof(d));
+    return (float)d;
+}
+
+// 逐行解析, 每个解析函数出错时记录第一个错误并返回false
+class IRTextParser {
+private:
+    LLVMIR &IR;
+    const char *cur;
+    const char *end;
+    int line = 1;
+    std::string error{};
+
+    // 当前函数中出现的最大寄存器编号
+    int max_reg = -1;
+
+    bool Fail(const std::string &msg) {
+        if (error.empty()) {
+            error = "line " + std::to_string(line) + ": " + msg;
+        }
+        return false;
+    }
+
+    void SkipSpaces() {
+        while (cur < end && (*cur == ' ' || *cur == '\t' || *cur == '\r')) {
+            cur++;
+        }
+    }
+    bool AtLineEnd() {
+        SkipSpaces();
+        return cur == end || *cur == '\n';
+    }
+    bool Peek(char c) {
+        SkipSpaces();
+        return cur < end && *cur == c;
+    }
+    bool Eat(std::string_view tok) {
+        SkipSpaces();
+        if ((size_t)(end - cur) >= tok.size() && std::string_view(cur, tok.size()) == tok) {
+            cur += tok.size();
+            return true;
+        }
+        return false;
+    }
+    bool Expect(std::string_view tok) { return Eat(tok) || Fail("expected '" + std::string(tok) + "'"); }
+    // 当前行必须已经结束, 并移动到下一行
+    bool EndLine() {
+        if (!AtLineEnd()) {
+            return Fail("unexpected '" + std::string(cur, std::find(cur, end, '\n')) + "'");
+        }
+        if (cur < end) {
+            cur++;
+            line++;
+        }
+        return true;
+    }
+
+    // 关键字、函数名和全局变量名
+    std::string_view Word() {
+        SkipSpaces();
+        const char *begin = cur;
+        while (cur < end && (isalnum((unsigned char)*cur) || *cur == '_' || *cur == '.')) {
+            cur++;
+        }
+        return std::string_view(begin, cur - begin);
+    }
+    bool Int(long long &v) {
+        SkipSpaces();
+        if (cur == end || !(isdigit((unsigned char)*cur) || *cur == '-')) {
+            return Fail("expected integer");
+        }
+        char *num_end;
+        errno = 0;
+        v = strtoll(cur, &num_end, 10);
+        if (num_end == cur || num_end > end || errno != 0) {
+            return Fail("expected integer");
+        }
+        cur = num_end;
+        return true;
+    }
+    bool Int(int &v) {
+        long long ll;
+        if (!Int(ll)) {
+            return false;
+        }
+        if (ll < INT_MIN || ll > INT_MAX) {
+            return Fail("integer out of range");
+        }
+        v = (int)ll;
+        return true;
+    }
+    bool Hex(unsigned long long &v) {
+        if (cur == end || !isxdigit((unsigned char)*cur)) {
+            return Fail("expected hexadecimal number");
+        }
+        char *num_end;
+        v = strtoull(cur, &num_end, 16);
+        if (num_end == cur || num_end > end) {
+            return Fail("expected hexadecimal number");
+        }
+        cur = num_end;
+        return true;
+    }
+    bool ScalarType(LLVMType &t) {
+        std::string_view w = Word();
+        return Lookup(TypeNames, w, t) || Fail("unknown type '" + std::string(w) + "'");
+    }
+    // [d1 x [d2 x ... <ty>]]
+    bool ArrayType(std::vector<int> &dims, LLVMType &t) {
+        while (Eat("[")) {
+            int d;
+            if (!Int(d) || !Expect("x")) {
+                return false;
+            }
+            dims.push_back(d);
+        }
+        if (!ScalarType(t)) {
+            return false;
+        }
+        for (size_t i = 0; i < dims.size(); i++) {
+            if (!Expect("]")) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // 类型为t的操作数, 整数立即数根据t决定是i32还是i64
+    bool Value(LLVMType t, Operand &op);
+    bool ArrayInit(VarAttribute &attr, LLVMType t, size_t depth, size_t begin);
+
+    bool Declare();
+    bool Global();
+    bool Function();
+    bool Inst(FuncDefInstruction defI, LLVMBlock block);
+
+public:
+    IRTextParser(LLVMIR &IR, const char *data, size_t size) : IR(IR), cur(data), end(data + size) {}
+
+    bool Parse(std::string &err);
+};
+
+bool IRTextParser::Value(LLVMType t, Operand &op) {
+    SkipSpaces();
+    if (Eat("%r")) {
+        int reg;
+        if (!Int(reg)) {
+            return false;
+        }
+        if (!IsValidRegNo(reg)) {
+            return Fail("register number out of range");
+        }
+        max_reg = std::max(max_reg, reg);
+        op = GetNewRegOperand(reg);
+    } else if (Eat("%L")) {
+        int label;
+        if (!Int(label)) {
+            return false;
+        }
+        if (!IsValidLabelNo(label)) {
+            return Fail("label number out of range");
+        }
+        op = GetNewLabelOperand(label);
+    } else if (Eat("@")) {
+        std::string_view name = Word();
+        if (name.empty()) {
+            return Fail("expected global name");
+        }
+        op = GetNewGlobalOperand(std::string(name));
+    } else if (Eat("0x")) {
+        unsigned long long bits;
+        if (!Hex(bits)) {
+            return false;
+        }
+        op = GetNewImmF32Operand(HexToFloat(bits));
+    } else {
+        long long v;
+        if (!Int(v)) {
+            return false;
+        }
+        if (t != BasicInstruction::I64 && (v < INT_MIN || v > INT_MAX)) {
+            return Fail("integer out of range");
+        }
+        op = t == BasicInstruction::I64 ? (Operand)GetNewImmI64Operand(v) : (Operand)GetNewImmI32Operand((int)v);
+    }
+    return true;
+}
+
+/*
+    数组初值, 与recursive_print对应: 每个元素为 "<子数组类型> [...]", "<子数组类型> zeroinitializer" 或 "<ty> <值>"
+    只包含一个元素的(子)数组不输出数组类型, 直接输出 "<ty> <值>", 因此遇到不以'['开头的元素时, 按单个元素处理
+*/
+bool IRTextParser::ArrayInit(VarAttribute &attr, LLVMType t, size_t depth, size_t begin) {
+    if (Eat("zeroinitializer")) {
+        return true;
+    }
+    if (depth >= attr.dims.size()) {
+        return Fail("array initializer nested too deep");
+    }
+    size_t step = 1;
+    for (size_t i = depth + 1; i < attr.dims.size(); i++) {
+        step *= attr.dims[i];
+    }
+    if (!Expect("[")) {
+        return false;
+    }
+    for (int i = 0; i < attr.dims[depth]; i++) {
+        if (i > 0 && !Expect(",")) {
+            return false;
+        }
+        size_t pos = begin + i * step;
+        if (Peek('[')) {
+            std::vector<int> sub_dims;
+            LLVMType sub_type;
+            if (!ArrayType(sub_dims, sub_type) || !ArrayInit(attr, t, depth + 1, pos)) {
+                return false;
+            }
+            continue;
+        }
+        LLVMType elem_type;
+        if (!ScalarType(elem_type)) {
+            return false;
+        }
+        if (elem_type == BasicInstruction::FLOAT32) {
+            unsigned long long bits;
+            if (!Expect("0x") || !Hex(bits)) {
+                return false;
+            }
+            attr.FloatInitVals.set(pos, HexToFloat(bits));
+        } else {
+            int v;
+            if (!Int(v)) {
+                return false;
+            }
+            attr.IntInitVals.set(pos, v);
+        }
+    }
+    return Expect("]");
+}
+
+// declare <ty> @name(<ty>,...)
+bool IRTextParser::Declare() {
+    LLVMType ret;
+    if (!ScalarType(ret) || !Expect("@")) {
+        return false;
+    }
+    auto DeclI = IR.global_arena.New<FunctionDeclareInstruction>(ret, std::string(Word()));
+    if (!Expect("(")) {
+        return false;
+    }
+    while (!Eat(")")) {
+        LLVMType t;
+        if ((!DeclI->formals.empty() && !Expect(",")) || !ScalarType(t)) {
+            return false;
+        }
+        DeclI->InsertFormal(t);
+    }
+    IR.function_declare.push_back(DeclI);
+    return EndLine();
+}
+
+// @name = global <ty> <值>|zeroinitializer 或 @name = global [..] [...]|zeroinitializer
+bool IRTextParser::Global() {
+    std::string name(Word());
+    if (name.empty() || !Expect("=") || !Expect("global")) {
+        return false;
+    }
+    GlobalVarDefineInstruction *GlobalI;
+    if (Peek('[')) {
+        VarAttribute attr;
+        LLVMType t;
+        if (!ArrayType(attr.dims, t)) {
+            return false;
+        }
+        size_t n = 1;
+        for (auto d : attr.dims) {
+            n *= d;
+        }
+        attr.type = t == BasicInstruction::FLOAT32 ? Type::FLOAT : Type::INT;
+        if (attr.type == Type::FLOAT) {
+            attr.FloatInitVals = SparseArray<float>(n);
+        } else {
+            attr.IntInitVals = SparseArray<int>(n);
+        }
+        if (!ArrayInit(attr, t, 0, 0)) {
+            return false;
+        }
+        GlobalI = IR.global_arena.New<GlobalVarDefineInstruction>(name, t, std::move(attr));
+    } else {
+        LLVMType t;
+        Operand init = nullptr;
+        if (!ScalarType(t) || (!Eat("zeroinitializer") && !Value(t, init))) {
+            return false;
+        }
+        GlobalI = IR.global_arena.New<GlobalVarDefineInstruction>(name, t, init);
+    }
+    IR.global_def.push_back(GlobalI);
+    return EndLine();
+}
+
+/*
+    define <ty> @name(<ty> %rN,...)
+    {
+    L0:  ;<comment>
+        <指令>
+    }
+*/
+bool IRTextParser::Function() {
+    LLVMType ret;
+    if (!ScalarType(ret) || !Expect("@")) {
+        return false;
+    }
+    auto defI = IR.global_arena.New<FunctionDefineInstruction>(ret, std::string(Word()));
+    IR.NewFunction(defI);
+    max_reg = -1;
+    if (!Expect("(")) {
+        return false;
+    }
+    while (!Eat(")")) {
+        LLVMType t;
+        Operand reg;
+        if ((!defI->formals.empty() && !Expect(",")) || !ScalarType(t) || !Value(t, reg)) {
+            return false;
+        }
+        if (reg->GetOperandType() != BasicOperand::REG) {
+            return Fail("expected register as function parameter");
+        }
+        defI->formals.push_back(t);
+        defI->formals_reg.push_back(reg);
+    }
+    if (!EndLine() || !Expect("{") || !EndLine()) {
+        return false;
+    }
+    auto &blocks = IR.function_block_map[defI];
+    LLVMBlock block = nullptr;
+    while (!Eat("}")) {
+        if (cur == end) {
+            return Fail("missing '}' at end of function " + defI->GetFunctionName());
+        }
+        if (AtLineEnd()) {
+            EndLine();
+            continue;
+        }
+        if (Eat("L")) {
+            int id;
+            if (!Int(id) || !Expect(":") || !Expect(";")) {
+                return false;
+            }
+            if (!IsValidLabelNo(id)) {
+                return Fail("label number out of range");
+            }
+            if (blocks.count(id)) {
+                return Fail("duplicate block L" + std::to_string(id));
+            }
+            block = IR.NewBlock(defI, id);
+            const char *comment_end = std::find(cur, end, '\n');
+            block->comment.assign(cur, comment_end);
+            // 与SkipSpaces一致, 忽略行尾的'\r'
+            if (!block->comment.empty() && block->comment.back() == '\r') {
+                block->comment.pop_back();
+            }
+            cur = comment_end;
+        } else if (block == nullptr) {
+            return Fail("instruction outside of basic block");
+        } else if (!Inst(defI, block)) {
+            return false;
+        }
+        if (!EndLine()) {
+            return false;
+        }
+    }
+    // 与快照使用相同的检查, 之后直接建立控制流图(见CFG::BuildEdges)
+    std::string msg;
+    if (!IR.CheckBlocks(defI, msg)) {
+        return Fail(msg);
+    }
+    IR.def_reg[defI] = max_reg;
+    return EndLine();
+}
+
+bool IRTextParser::Inst(FuncDefInstruction defI, LLVMBlock block) {
+    Arena &arena = IR.GetArena(defI);
+    Operand result = nullptr;
+    if (Peek('%')) {
+        if (!Value(BasicInstruction::I32, result) || !Expect("=")) {
+            return false;
+        }
+    }
+    std::string_view opcode = Word();
+    auto need_result = [&]() { return result != nullptr || Fail(std::string(opcode) + " without result"); };
+    Instruction I = nullptr;
+    LLVMType t;
+    Operand op1, op2, op3;
+    BasicInstruction::LLVMIROpcode arith;
+    if (opcode == "load") {
+        if (!need_result() || !ScalarType(t) || !Expect(",") || !Expect("ptr") || !Value(BasicInstruction::PTR, op1)) {
+            return false;
+        }
+        I = arena.New<LoadInstruction>(t, op1, result);
+    } else if (opcode == "store") {
+        if (!ScalarType(t) || !Value(t, op1) || !Expect(",") || !Expect("ptr") || !Value(BasicInstruction::PTR, op2)) {
+            return false;
+        }
+        I = arena.New<StoreInstruction>(t, op2, op1);
+    } else if (Lookup(ArithmeticNames, opcode, arith)) {
+        if (!need_result() || !ScalarType(t) || !Value(t, op1) || !Expect(",") || !Value(t, op2)) {
+            return false;
+        }
+        I = arena.New<ArithmeticInstruction>(arith, t, op1, op2, result);
+    } else if (opcode == "icmp") {
+        BasicInstruction::IcmpCond cond;
+        std::string_view w = Word();
+        if (!Lookup(IcmpNames, w, cond)) {
+            return Fail("unknown icmp condition '" + std::string(w) + "'");
+        }
+        if (!need_result() || !ScalarType(t) || !Value(t, op1) || !Expect(",") || !Value(t, op2)) {
+            return false;
+        }
+        I = arena.New<IcmpInstruction>(t, op1, op2, cond, result);
+    } else if (opcode == "fcmp") {
+        BasicInstruction::FcmpCond cond;
+        std::string_view w = Word();
+        if (!Lookup(FcmpNames, w, cond)) {
+            return Fail("unknown fcmp condition '" + std::string(w) + "'");
+        }
+        if (!need_result() || !ScalarType(t) || !Value(t, op1) || !Expect(",") || !Value(t, op2)) {
+            return false;
+        }
+        I = arena.New<FcmpInstruction>(t, op1, op2, cond, result);
+    } else if (opcode == "phi") {
+        // [值,label],[值,label]...
+        if (!need_result() || !ScalarType(t)) {
+            return false;
+        }
+        auto PhiI = arena.New<PhiInstruction>(t, result);
+        while (!AtLineEnd()) {
+            if ((!PhiI->GetPhiList().empty() && !Expect(",")) || !Expect("[") || !Value(t, op1) || !Expect(",") ||
+                !Value(BasicInstruction::I32, op2) || !Expect("]")) {
+                return false;
+            }
+            PhiI->InsertPhi({op2, op1});
+        }
+        I = PhiI;
+    } else if (opcode == "alloca") {
+        std::vector<int> dims;
+        if (!need_result() || !ArrayType(dims, t)) {
+            return false;
+        }
+        I = arena.New<AllocaInstruction>(t, std::move(dims), result);
+    } else if (opcode == "br") {
+        if (Eat("label")) {
+            if (!Value(BasicInstruction::I32, op1)) {
+                return false;
+            }
+            I = arena.New<BrUncondInstruction>(op1);
+        } else {
+            if (!Expect("i1") || !Value(BasicInstruction::I1, op1) || !Expect(",") || !Expect("label") ||
+                !Value(BasicInstruction::I32, op2) || !Expect(",") || !Expect("label") ||
+                !Value(BasicInstruction::I32, op3)) {
+                return false;
+            }
+            I = arena.New<BrCondInstruction>(op1, op2, op3);
+        }
+    } else if (opcode == "ret") {
+        op1 = nullptr;
+        if (!ScalarType(t) || (!AtLineEnd() && !Value(t, op1))) {
+            return false;
+        }
+        I = arena.New<RetInstruction>(t, op1);
+    } else if (opcode == "call") {
+        if (!ScalarType(t) || !Expect("@")) {
+            return false;
+        }
+        std::string name(Word());
+        std::vector<std::pair<LLVMType, Operand>> args;
+        if (!Expect("(")) {
+            return false;
+        }
+        while (!Eat(")")) {
+            LLVMType arg_type;
+            if ((!args.empty() && !Expect(",")) || !ScalarType(arg_type) || !Value(arg_type, op1)) {
+                return false;
+            }
+            args.push_back({arg_type, op1});
+        }
+        I = arena.New<CallInstruction>(t, result, name, std::move(args));
+    } else if (opcode == "getelementptr") {
+        std::vector<int> dims;
+        std::vector<Operand> indexes;
+        LLVMType index_type = BasicInstruction::I32;
+        if (!need_result() || !ArrayType(dims, t) || !Expect(",") || !Expect("ptr") ||
+            !Value(BasicInstruction::PTR, op1)) {
+            return false;
+        }
+        while (Eat(",")) {
+            if (!ScalarType(index_type) || !Value(index_type, op2)) {
+                return false;
+            }
+            indexes.push_back(op2);
+        }
+        I = arena.New<GetElementptrInstruction>(t, result, op1, std::move(dims), std::move(indexes), index_type);
+    } else if (opcode == "fptosi") {
+        if (!need_result() || !Expect("float") || !Value(BasicInstruction::FLOAT32, op1) || !Expect("to") ||
+            !Expect("i32")) {
+            return false;
+        }
+        I = arena.New<FptosiInstruction>(result, op1);
+    } else if (opcode == "sitofp") {
+        if (!need_result() || !Expect("i32") || !Value(BasicInstruction::I32, op1) || !Expect("to") ||
+            !Expect("float")) {
+            return false;
+        }
+        I = arena.New<SitofpInstruction>(result, op1);
+    } else if (opcode == "zext") {
+        LLVMType to;
+        if (!need_result() || !ScalarType(t) || !Value(t, op1) || !Expect("to") || !ScalarType(to)) {
+            return false;
+        }
+        I = arena.New<ZextInstruction>(to, result, t, op1);
+    } else {
+        return Fail("unknown instruction '" + std::string(opcode) + "'");
+    }
+    block->Instruction_list.push_back(I);
+    return true;
+}
+
+bool IRTextParser::Parse(std::string &err) {
+    bool ok = true;
+    while (ok && cur < end) {
+        if (AtLineEnd()) {
+            EndLine();
+        } else if (Eat("declare")) {
+            ok = Declare();
+        } else if (Eat("define")) {
+            ok = Function();
+        } else if (Eat("@")) {
+            ok = Global();
+        } else {
+            ok = Fail("expected declare, define or global definition");
+        }
+    }
+    // 与中间代码生成结束时一致
+    ir_arena = &IR.global_arena;
+    err = error;
+    return ok;
+}
+
+}    // namespace
+
+bool IsIRTextFile(const char *path) {
+    size_t len = strlen(path);
+    return len >= 3 && strcmp(path + len - 3, ".ll") == 0;
+}
+
+bool ParseIRText(LLVMIR &IR, const char *data, size_t size, std::string &error) {
+    return IRTextParser(IR, data, size).Parse(error);
+}
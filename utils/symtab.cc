@@ -1,76 +1,45 @@
 #include "../include/symtab.h"
 
-Symbol IdTable::add_id(std::string s) {
+Symbol IdTable::add_id(std::string_view s) {
     auto it = id_table.find(s);
     if (it == id_table.end()) {
-        Symbol new_symbol = new Entry(s);
-        id_table[s] = new_symbol;
+        Symbol new_symbol = new Entry(std::string(s));
+        id_table.emplace(new_symbol->get_view(), new_symbol);
         return new_symbol;
     } else {
-        return id_table[s];
+        return it->second;
     }
 }
 
-void SymbolTable::add_Symbol(Symbol C, VarAttribute val) { symbol_table[current_scope][C] = val; }
+void SymbolTable::add_Symbol(Symbol C, VarAttribute val) { symbol_table.insert(C, std::move(val)); }
 
 Type::ty SymbolTable::lookup_type(Symbol C) {
-    for (int i = current_scope; i >= 0; --i) {
-        auto it = symbol_table[i].find(C);
-        if (it != symbol_table[i].end()) {
-            return it->second.type;
-        }
-    }
-    return Type::VOID;
+    auto entry = symbol_table.find(C);
+    return entry == nullptr ? Type::VOID : entry->second.type;
 }
 
 int SymbolTable::lookup_scope(Symbol C) {
-    for (int i = current_scope; i >= 0; --i) {
-        auto it = symbol_table[i].find(C);
-        if (it != symbol_table[i].end()) {
-            return i;
-        }
-    }
-    return -1;
+    auto entry = symbol_table.find(C);
+    return entry == nullptr ? -1 : entry->first;
 }
 
-VarAttribute SymbolTable::lookup_val(Symbol C) {
-    for (int i = current_scope; i >= 0; --i) {
-        auto it = symbol_table[i].find(C);
-        if (it != symbol_table[i].end()) {
-            return it->second;
-        }
-    }
-    return VarAttribute();
+const VarAttribute &SymbolTable::lookup_val(Symbol C) {
+    static const VarAttribute empty;
+    auto entry = symbol_table.find(C);
+    return entry == nullptr ? empty : entry->second;
 }
 
-void SymbolTable::enter_scope() {
-    ++current_scope;
-    symbol_table.push_back(std::map<Symbol, VarAttribute>());
-}
+void SymbolTable::enter_scope() { symbol_table.enter_scope(); }
 
-void SymbolTable::exit_scope() {
-    --current_scope;
-    symbol_table.pop_back();
-}
+void SymbolTable::exit_scope() { symbol_table.exit_scope(); }
 
 int SymbolRegTable::lookup(Symbol C) {
-    for (int i = current_scope; i >= 0; --i) {
-        auto it = symbol_table[i].find(C);
-        if (it != symbol_table[i].end()) {
-            return it->second;
-        }
-    }
-    return -1;
+    auto entry = symbol_table.find(C);
+    return entry == nullptr ? -1 : entry->second;
 }
 
-void SymbolRegTable::add_Symbol(Symbol C, int val) { symbol_table[current_scope][C] = val; }
+void SymbolRegTable::add_Symbol(Symbol C, int val) { symbol_table.insert(C, val); }
 
-void SymbolRegTable::enter_scope() {
-    ++current_scope;
-    symbol_table.push_back(std::map<Symbol, int>());
-}
+void SymbolRegTable::enter_scope() { symbol_table.enter_scope(); }
 
-void SymbolRegTable::exit_scope() {
-    --current_scope;
-    symbol_table.pop_back();
-}
+void SymbolRegTable::exit_scope() { symbol_table.exit_scope(); }